@@ -0,0 +1,45 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyalgorithm.h>
+
+// template<class RandomIt, class UnaryPredicate>
+//   RandomIt parallel_stable_partition(RandomIt first, RandomIt last,
+//                                      UnaryPredicate pred, unsigned max_threads = 0);
+
+#include "tidyalgorithm.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+struct is_odd {
+    bool operator()(int i) const { return i % 2 != 0; }
+};
+
+void test(int size, unsigned threads)
+{
+    tidy::vector<int> v;
+    for (int i = 0; i < size; ++i)
+        v.push_back(std::rand() % 1000);
+    tidy::vector<int> expected = v;
+    auto expected_mid = std::stable_partition(expected.begin(), expected.end(), is_odd());
+
+    auto mid = tidy::parallel_stable_partition(v.begin(), v.end(), is_odd(), threads);
+    assert(mid - v.begin() == expected_mid - expected.begin());
+    assert(v == expected);
+}
+
+int main()
+{
+    const int sizes[] = {0, 1, 100, 8192 * 2, 8192 * 5 + 3, 100000};
+    for (int size : sizes) {
+        test(size, 1);
+        test(size, 2);
+        test(size, 3);
+        test(size, 8);
+        test(size, 0);
+    }
+}
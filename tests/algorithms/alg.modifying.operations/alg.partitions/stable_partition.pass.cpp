@@ -0,0 +1,66 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyalgorithm.h>
+
+// template<BidirectionalIterator Iter, Predicate<auto, Iter::value_type> Pred>
+//   Iter stable_partition(Iter first, Iter last, Pred pred);
+
+#include "tidyalgorithm.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+#include "MoveOnly.h"
+#include "test_iterators.h"
+
+struct is_odd {
+    bool operator()(int i) const { return i % 2 != 0; }
+};
+
+template <class Iter>
+void test(int size)
+{
+    tidy::vector<int> v;
+    for (int i = 0; i < size; ++i)
+        v.push_back(std::rand() % 1000);
+    tidy::vector<int> expected = v;
+    auto expected_mid = std::stable_partition(expected.begin(), expected.end(), is_odd());
+
+    Iter mid = tidy::stable_partition(Iter(v.data()), Iter(v.data() + v.size()), is_odd());
+    assert(base(mid) - v.data() == expected_mid - expected.begin());
+    assert(v == expected);
+}
+
+int main()
+{
+    const int sizes[] = {0, 1, 2, 3, 10, 100, 1000};
+    for (int size : sizes) {
+        test<bidirectional_iterator<int*> >(size);
+        test<random_access_iterator<int*> >(size);
+        test<int*>(size);
+    }
+    {
+        // all elements satisfy or don't satisfy the predicate
+        tidy::vector<int> v = {1, 3, 5};
+        assert(tidy::stable_partition(v.begin(), v.end(), is_odd()) == v.end());
+        v = {2, 4, 6};
+        assert(tidy::stable_partition(v.begin(), v.end(), is_odd()) == v.begin());
+        assert(v == tidy::vector<int>({2, 4, 6}));
+    }
+    {
+        tidy::vector<MoveOnly> v;
+        for (int i = 0; i < 10; ++i)
+            v.push_back(MoveOnly(i));
+        auto mid = tidy::stable_partition(v.begin(), v.end(),
+                                          [](const MoveOnly& m) { return m.get() % 2 != 0; });
+        assert(mid == v.begin() + 5);
+        for (int i = 0; i < 5; ++i) {
+            assert(v[i] == MoveOnly(2 * i + 1));
+            assert(v[i + 5] == MoveOnly(2 * i));
+        }
+    }
+}
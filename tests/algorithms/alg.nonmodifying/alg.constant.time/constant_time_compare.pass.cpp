@@ -0,0 +1,96 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyconstanttime.h>
+
+// int constant_time_compare(const void* a, const void* b, size_t size);
+// int constant_time_compare(const vector<T, Alloc>& a, const vector<T, Alloc>& b);
+// int constant_time_compare(const basic_string<CharT, char_traits<CharT>, Alloc>& a,
+//                           const basic_string<CharT, char_traits<CharT>, Alloc>& b);
+
+#include "tidyconstanttime.h"
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+int sign(int x)
+{
+    return (x > 0) - (x < 0);
+}
+
+// compare with operator< on vectors of single-byte elements
+template<class T>
+void test_byte_vectors()
+{
+    std::srand(2);
+    for (int iter = 0; iter < 5000; ++iter) {
+        tidy::vector<T> a(std::rand() % 40);
+        for (T& x : a)
+            x = static_cast<T>(std::rand());
+        tidy::vector<T> b = a;
+        for (int d = std::rand() % 3; d > 0 && !b.empty(); --d)
+            b[std::rand() % b.size()] = static_cast<T>(std::rand());
+        int expected = int(b < a) - int(a < b);
+        assert(tidy::constant_time_compare(a, b) == expected);
+    }
+}
+
+int main()
+{
+    {
+        // compare with memcmp, with differences of both signs at several
+        // positions, including bytes above 0x7f
+        std::srand(1);
+        unsigned char a[40];
+        unsigned char b[40];
+        for (int iter = 0; iter < 20000; ++iter) {
+            std::size_t len = std::rand() % 40;
+            for (std::size_t i = 0; i < len; ++i)
+                a[i] = b[i] = static_cast<unsigned char>(std::rand());
+            for (int d = std::rand() % 3; d > 0 && len > 0; --d)
+                b[std::rand() % len] = static_cast<unsigned char>(std::rand());
+            assert(tidy::constant_time_compare(a, b, len) ==
+                   sign(std::memcmp(a, b, len)));
+        }
+    }
+    {
+        tidy::vector<int> a = { 1, -2, 3 };
+        tidy::vector<int> b = { 1, 2, 3 };
+        assert(tidy::constant_time_compare(a, b) == -1);
+        assert(tidy::constant_time_compare(b, a) == 1);
+        assert(tidy::constant_time_compare(a, a) == 0);
+        b.pop_back();
+        assert(tidy::constant_time_compare(a, b) == -1);
+        a[1] = 2;
+        assert(tidy::constant_time_compare(a, b) == 1);
+        assert(tidy::constant_time_compare(b, a) == -1);
+    }
+    {
+        // vectors compare their elements by value, thus the order of
+        // '\x80' and '\x01' depends on whether char is signed
+        tidy::vector<char> a = { '\x80' };
+        tidy::vector<char> b = { '\x01' };
+        assert(tidy::constant_time_compare(a, b) == (a < b ? -1 : 1));
+        test_byte_vectors<char>();
+        test_byte_vectors<signed char>();
+        test_byte_vectors<unsigned char>();
+    }
+    {
+        const char* strs[] = { "", "a", "ab", "abc", "abd", "b", "\xff", "\x7f" };
+        for (const char* x : strs) {
+            for (const char* y : strs) {
+                int expected = sign(std::string(x).compare(y));
+                assert(tidy::constant_time_compare(tidy::string(x), tidy::string(y)) ==
+                       expected);
+            }
+        }
+        assert(tidy::constant_time_compare(tidy::wstring(L"ab"), tidy::wstring(L"b")) == -1);
+        assert(tidy::constant_time_compare(tidy::u16string(u"\xffff"),
+                                           tidy::u16string(u"a")) == 1);
+    }
+}
@@ -0,0 +1,69 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyconstanttime.h>
+
+// bool constant_time_equal(const void* a, const void* b, size_t size);
+// bool constant_time_equal(const vector<T, Alloc>& a, const vector<T, Alloc>& b);
+// bool constant_time_equal(const basic_string<CharT, char_traits<CharT>, Alloc>& a,
+//                          const basic_string<CharT, char_traits<CharT>, Alloc>& b);
+
+#include "tidyconstanttime.h"
+#include "tidystaticstring.h"
+#include <cassert>
+#include <cstdint>
+
+int main()
+{
+    {
+        // every length and every position of the difference, covering the
+        // vector, word and byte loops
+        unsigned char a[100];
+        unsigned char b[100];
+        for (int i = 0; i < 100; ++i)
+            a[i] = b[i] = static_cast<unsigned char>(i * 7);
+        for (std::size_t len = 0; len <= 100; ++len) {
+            assert(tidy::constant_time_equal(a, b, len));
+            for (std::size_t i = 0; i < len; ++i) {
+                b[i] ^= 0x80;
+                assert(!tidy::constant_time_equal(a, b, len));
+                b[i] ^= 0x80;
+            }
+        }
+        assert(tidy::constant_time_equal(nullptr, nullptr, 0));
+    }
+    {
+        tidy::vector<std::uint8_t> a = { 1, 2, 3 };
+        tidy::vector<std::uint8_t> b = { 1, 2, 3 };
+        assert(tidy::constant_time_equal(a, b));
+        b[2] = 4;
+        assert(!tidy::constant_time_equal(a, b));
+        b.pop_back();
+        assert(!tidy::constant_time_equal(a, b));
+        assert(tidy::constant_time_equal(tidy::vector<std::uint8_t>(),
+                                         tidy::vector<std::uint8_t>()));
+
+        tidy::vector<int> c(50, 1);
+        tidy::vector<int> d(50, 1);
+        assert(tidy::constant_time_equal(c, d));
+        d[49] = 2;
+        assert(!tidy::constant_time_equal(c, d));
+    }
+    {
+        tidy::string a = "secret token";
+        assert(tidy::constant_time_equal(a, tidy::string("secret token")));
+        assert(!tidy::constant_time_equal(a, tidy::string("secret tokem")));
+        assert(!tidy::constant_time_equal(a, tidy::string("secret")));
+        assert(tidy::constant_time_equal(tidy::string(), tidy::string()));
+
+        tidy::u32string w = U"abc";
+        assert(tidy::constant_time_equal(w, tidy::u32string(U"abc")));
+        assert(!tidy::constant_time_equal(w, tidy::u32string(U"abd")));
+
+        tidy::static_string<16> s = "abc";
+        assert(tidy::constant_time_equal(s, tidy::static_string<16>("abc")));
+    }
+}
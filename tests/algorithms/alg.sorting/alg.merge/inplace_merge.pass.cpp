@@ -0,0 +1,81 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyalgorithm.h>
+
+// template<BidirectionalIterator Iter, StrictWeakOrder<auto, Iter::value_type> Compare>
+//   void inplace_merge(Iter first, Iter middle, Iter last, Compare comp);
+// template<BidirectionalIterator Iter>
+//   void inplace_merge(Iter first, Iter middle, Iter last);
+
+#include "tidyalgorithm.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <functional>
+#include <utility>
+
+#include "MoveOnly.h"
+#include "test_iterators.h"
+
+typedef std::pair<int, int> P;
+
+struct key_less {
+    bool operator()(const P& a, const P& b) const { return a.first < b.first; }
+};
+
+template <class Iter>
+void test(int size, int split)
+{
+    // the pairs are ordered by key and the second member tells the original
+    // position, thus stability is checked too
+    tidy::vector<P> v;
+    for (int i = 0; i < size; ++i)
+        v.push_back(P(std::rand() % 10, i));
+    std::stable_sort(v.begin(), v.begin() + split, key_less());
+    std::stable_sort(v.begin() + split, v.end(), key_less());
+    tidy::vector<P> expected = v;
+    std::inplace_merge(expected.begin(), expected.begin() + split, expected.end(),
+                       key_less());
+
+    tidy::inplace_merge(Iter(v.data()), Iter(v.data() + split),
+                        Iter(v.data() + v.size()), key_less());
+    assert(v == expected);
+}
+
+int main()
+{
+    const int sizes[] = {0, 1, 2, 3, 10, 100, 1001};
+    for (int size : sizes) {
+        const int splits[] = {0, 1, size / 3, size / 2, size - size / 3, size - 1, size};
+        for (int split : splits) {
+            if (split < 0 || split > size)
+                continue;
+            test<bidirectional_iterator<P*> >(size, split);
+            test<random_access_iterator<P*> >(size, split);
+            test<P*>(size, split);
+        }
+    }
+    {
+        tidy::vector<int> v = {1, 3, 5, 7, 2, 4, 6};
+        tidy::inplace_merge(v.begin(), v.begin() + 4, v.end());
+        assert(v == tidy::vector<int>({1, 2, 3, 4, 5, 6, 7}));
+
+        tidy::vector<int> w = {7, 5, 3, 6, 4, 2};
+        tidy::inplace_merge(w.begin(), w.begin() + 3, w.end(), std::greater<int>());
+        assert(w == tidy::vector<int>({7, 6, 5, 4, 3, 2}));
+    }
+    {
+        tidy::vector<MoveOnly> v;
+        for (int i = 0; i < 100; i += 2)
+            v.push_back(MoveOnly(i));
+        for (int i = 1; i < 100; i += 2)
+            v.push_back(MoveOnly(i));
+        tidy::inplace_merge(v.begin(), v.begin() + 50, v.end());
+        for (int i = 0; i < 100; ++i)
+            assert(v[i] == MoveOnly(i));
+    }
+}
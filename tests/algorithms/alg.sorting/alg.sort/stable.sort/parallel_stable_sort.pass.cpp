@@ -0,0 +1,76 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyalgorithm.h>
+
+// template<class RandomIt, class Compare>
+//   void parallel_stable_sort(RandomIt first, RandomIt last, Compare comp,
+//                             unsigned max_threads = 0);
+// template<class RandomIt>
+//   void parallel_stable_sort(RandomIt first, RandomIt last);
+
+#include "tidyalgorithm.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+
+typedef std::pair<int, int> P;
+
+struct key_less {
+    bool operator()(const P& a, const P& b) const { return a.first < b.first; }
+};
+
+struct throwing_less {
+    bool operator()(int a, int b) const
+    {
+        if (a == -1 || b == -1)
+            throw std::runtime_error("comparison failed");
+        return a < b;
+    }
+};
+
+void test(int size, unsigned threads)
+{
+    tidy::vector<P> v;
+    for (int i = 0; i < size; ++i)
+        v.push_back(P(std::rand() % 100, i));
+    tidy::vector<P> expected = v;
+    std::stable_sort(expected.begin(), expected.end(), key_less());
+
+    tidy::parallel_stable_sort(v.begin(), v.end(), key_less(), threads);
+    assert(v == expected);
+}
+
+int main()
+{
+    const int sizes[] = {0, 1, 100, 8192 * 2, 8192 * 5 + 3, 100000};
+    for (int size : sizes) {
+        test(size, 1);
+        test(size, 2);
+        test(size, 3);
+        test(size, 8);
+    }
+    {
+        tidy::vector<int> v;
+        for (int i = 0; i < 50000; ++i)
+            v.push_back(50000 - i);
+        tidy::parallel_stable_sort(v.begin(), v.end());
+        for (int i = 0; i < 50000; ++i)
+            assert(v[i] == i + 1);
+    }
+    {
+        // exceptions thrown on the worker threads reach the caller
+        tidy::vector<int> v(50000, 1);
+        v[30000] = -1;
+        try {
+            tidy::parallel_stable_sort(v.begin(), v.end(), throwing_less(), 4);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+    }
+}
@@ -0,0 +1,96 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyalgorithm.h>
+
+// template<RandomAccessIterator Iter, StrictWeakOrder<auto, Iter::value_type> Compare>
+//   void stable_sort(Iter first, Iter last, Compare comp);
+// template<RandomAccessIterator Iter>
+//   void stable_sort(Iter first, Iter last);
+
+#include "tidyalgorithm.h"
+#include "tidystring.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <functional>
+#include <utility>
+
+#include "MoveOnly.h"
+#include "test_iterators.h"
+
+typedef std::pair<int, int> P;
+
+struct key_less {
+    bool operator()(const P& a, const P& b) const { return a.first < b.first; }
+};
+
+// Elements with equal keys must keep their relative order
+void test_stability(int size, int keys)
+{
+    tidy::vector<P> v;
+    for (int i = 0; i < size; ++i)
+        v.push_back(P(std::rand() % keys, i));
+    tidy::vector<P> expected = v;
+    std::stable_sort(expected.begin(), expected.end(), key_less());
+
+    tidy::stable_sort(v.begin(), v.end(), key_less());
+    assert(v == expected);
+}
+
+template <class Iter>
+void test_sorted(int size)
+{
+    tidy::vector<int> v;
+    for (int i = 0; i < size; ++i)
+        v.push_back(std::rand() % (size + 1));
+    tidy::vector<int> expected = v;
+    std::sort(expected.begin(), expected.end());
+
+    tidy::stable_sort(Iter(v.data()), Iter(v.data() + v.size()));
+    assert(v == expected);
+
+    tidy::stable_sort(Iter(v.data()), Iter(v.data() + v.size()), std::greater<int>());
+    std::reverse(expected.begin(), expected.end());
+    assert(v == expected);
+}
+
+int main()
+{
+    const int sizes[] = {0, 1, 2, 3, 10, 31, 32, 33, 64, 100, 1000, 4097};
+    for (int size : sizes) {
+        test_stability(size, 1);
+        test_stability(size, 3);
+        test_stability(size, size + 1);
+        test_sorted<int*>(size);
+        test_sorted<random_access_iterator<int*> >(size);
+    }
+    {
+        // already sorted and reverse sorted inputs
+        tidy::vector<int> v;
+        for (int i = 0; i < 1000; ++i)
+            v.push_back(i);
+        tidy::stable_sort(v.begin(), v.end());
+        assert(std::is_sorted(v.begin(), v.end()));
+        std::reverse(v.begin(), v.end());
+        tidy::stable_sort(v.begin(), v.end());
+        assert(std::is_sorted(v.begin(), v.end()));
+    }
+    {
+        tidy::vector<MoveOnly> v;
+        for (int i = 0; i < 500; ++i)
+            v.push_back(MoveOnly((i * 7919) % 500));
+        tidy::stable_sort(v.begin(), v.end());
+        for (int i = 0; i < 500; ++i)
+            assert(v[i] == MoveOnly(i));
+    }
+    {
+        tidy::string s("the quick brown fox jumps over the lazy dog");
+        tidy::stable_sort(s.begin(), s.end());
+        assert(std::is_sorted(s.begin(), s.end()));
+        assert(s.size() == 43);
+    }
+}
@@ -0,0 +1,196 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidylrucache.h>
+
+// template<class Value, class Key = string, class Clock = steady_clock>
+// class lru_cache
+
+#include "tidylrucache.h"
+#include "wipe_checking_allocator.h"
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct fake_clock {
+    typedef std::chrono::milliseconds duration;
+    typedef duration::rep rep;
+    typedef duration::period period;
+    typedef std::chrono::time_point<fake_clock> time_point;
+    static const bool is_steady = true;
+
+    static long long ms;
+    static time_point now() { return time_point(duration(ms)); }
+};
+long long fake_clock::ms = 1000;
+
+typedef tidy::lru_cache<tidy::string, tidy::string, fake_clock> cache_type;
+
+bool has(cache_type& c, const char* key)
+{
+    return c.contains(key, std::strlen(key));
+}
+
+// The memory of the keys and values is checked to be wiped when it's
+// released. Counting the releases shows that the key and the value of an
+// entry are destroyed as soon as the entry leaves the cache.
+typedef tidy::basic_string<char, std::char_traits<char>, wipe_checking_allocator<char>>
+    wiped_string;
+typedef tidy::lru_cache<wiped_string, wiped_string, fake_clock> wiped_cache_type;
+
+int released()
+{
+    return wipe_checking_allocator<char>::deallocations;
+}
+
+void test_wipe()
+{
+    wiped_cache_type c(2, std::chrono::milliseconds(1000), 1);
+    c.put("key1", "secret value 1");
+    c.put("key2", "secret value 2");
+
+    int before = released();
+    assert(c.erase("key1", 4));
+    assert(released() == before + 2);
+
+    // eviction of the least recently used entry
+    c.put("key3", "secret value 3");
+    before = released();
+    c.put("key4", "secret value 4");
+    assert(!c.contains("key2", 4));
+    assert(released() == before + 2);
+
+    // replacing the value releases the old value and the unused key
+    before = released();
+    c.put("key4", "secret value 5");
+    assert(released() == before + 2);
+
+    // expiry
+    c.put("key5", "secret value 6", std::chrono::milliseconds(10));
+    before = released();
+    fake_clock::ms += 2000;
+    c.expire();
+    assert(c.size() == 0);
+    assert(released() == before + 4);
+
+    c.put("key6", "secret value 7");
+    c.put("key7", "secret value 8");
+    before = released();
+    c.clear();
+    assert(c.size() == 0);
+    assert(released() == before + 4);
+}
+
+int main()
+{
+    {
+        cache_type c(4, fake_clock::duration::zero(), 1);
+        assert(c.capacity() == 4 && c.shard_count() == 1 && c.size() == 0);
+        c.put("a", "1");
+        c.put("b", "2");
+        c.put("c", "3");
+        c.put("d", "4");
+        assert(c.size() == 4);
+
+        tidy::string value;
+        assert(c.get("a", 1, value) && value == "1");
+        // "b" is the least recently used entry now
+        c.put("e", "5");
+        assert(c.size() == 4);
+        assert(!has(c, "b"));
+        assert(has(c, "a") && has(c, "c") && has(c, "d") && has(c, "e"));
+
+        c.put("c", "33");
+        assert(c.get(tidy::string("c"), value) && value == "33");
+        assert(c.size() == 4);
+
+        std::size_t length = 0;
+        assert(c.visit("e", 1, [&](const tidy::string& v) { length = v.size(); }));
+        assert(length == 1);
+        assert(!c.visit("x", 1, [&](const tidy::string&) { assert(false); }));
+
+        assert(c.erase("a", 1));
+        assert(!c.erase("a", 1));
+        assert(c.size() == 3);
+        c.clear();
+        assert(c.size() == 0 && !has(c, "c"));
+        c.put("f", "6");
+        assert(has(c, "f"));
+    }
+    {
+        // entries expire after their time to live
+        cache_type c(100, std::chrono::milliseconds(1000), 4);
+        assert(c.shard_count() == 4 && c.capacity() == 100);
+        c.put("short", "1", std::chrono::milliseconds(100));
+        c.put("default", "2");
+        c.put("forever", "3", fake_clock::duration::zero());
+        assert(c.size() == 3);
+
+        fake_clock::ms += 99;
+        assert(has(c, "short"));
+        fake_clock::ms += 1;
+        assert(!has(c, "short"));
+        assert(c.size() == 2);
+
+        fake_clock::ms += 899;
+        c.expire();
+        assert(c.size() == 2);
+        assert(has(c, "default"));
+        fake_clock::ms += 1;
+        assert(!has(c, "default"));
+        assert(c.size() == 1);
+
+        // the timer wheel removes entries within one tick (1/16 of the
+        // default time to live) after they expire
+        c.put("unused", "4");
+        fake_clock::ms += 1000 + 1000 / 16;
+        c.expire();
+        assert(c.size() == 1);
+
+        // many rotations of the timer wheel later
+        fake_clock::ms += 1000000;
+        c.expire();
+        assert(has(c, "forever"));
+
+        c.put("long", "4", std::chrono::milliseconds(100000));
+        fake_clock::ms += 99999;
+        c.expire();
+        assert(has(c, "long"));
+        fake_clock::ms += 1;
+        c.expire();
+        assert(!has(c, "long"));
+
+        // putting an entry again resets its time to live
+        c.put("k", "5");
+        fake_clock::ms += 800;
+        c.put("k", "6");
+        fake_clock::ms += 800;
+        c.expire();
+        assert(has(c, "k"));
+    }
+    {
+        tidy::lru_cache<tidy::vector<unsigned char>> c(1000);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&c, t]() {
+                for (int i = 0; i < 2000; ++i) {
+                    tidy::string key = std::to_string(t * 100000 + i % 300).c_str();
+                    c.put(key, tidy::vector<unsigned char>(16, (unsigned char)t));
+                    tidy::vector<unsigned char> out;
+                    if (c.get(key.data(), key.size(), out))
+                        assert(out.size() == 16);
+                }
+            });
+        }
+        for (auto& t : threads)
+            t.join();
+        assert(c.size() <= c.capacity());
+    }
+    test_wipe();
+}
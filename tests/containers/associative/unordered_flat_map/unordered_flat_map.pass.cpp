@@ -0,0 +1,292 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyunorderedflatmap.h>
+
+// template<class Key, class T, class Hash = hash<Key>, class KeyEqual = equal_to<Key>,
+//          class Allocator = allocator<pair<const Key, T>>>
+// class unordered_flat_map
+
+#include "tidyunorderedflatmap.h"
+#include "tidystaticstring.h"
+#include "tidystring.h"
+#include "wipe_checking_allocator.h"
+#include <cassert>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct string_hash {
+    template<class S>
+    std::size_t operator()(const S& s) const
+    {
+        return tidy::detail::hash_bytes(s.data(), s.size());
+    }
+};
+
+// puts all keys into the same probe sequence
+struct bad_hash {
+    std::size_t operator()(int) const { return 0; }
+};
+
+// throws once the given number of calls is reached
+struct throwing_hash {
+    static int calls_left;
+    std::size_t operator()(int key) const
+    {
+        if (calls_left >= 0 && calls_left-- == 0)
+            throw std::runtime_error("hash");
+        return std::size_t(key);
+    }
+};
+int throwing_hash::calls_left = -1;
+
+// a value whose copies throw once the given number of copies is reached and
+// whose move constructor may throw, so that rehashing copies it
+struct throwing_copy {
+    static int copies_left;
+    tidy::string data;
+
+    explicit throwing_copy(const char* s) : data(s) {}
+    throwing_copy(const throwing_copy& other) : data(other.data)
+    {
+        if (copies_left >= 0 && copies_left-- == 0)
+            throw std::runtime_error("copy");
+    }
+    throwing_copy(throwing_copy&& other) noexcept(false) : data(other.data) {}
+};
+int throwing_copy::copies_left = -1;
+
+void test_rehash_exceptions()
+{
+    {
+        tidy::unordered_flat_map<int, tidy::string, throwing_hash> m;
+        for (int i = 0; i < 14; ++i)
+            m.emplace(i, tidy::string(50, char('a' + i)));
+        std::size_t buckets = m.bucket_count();
+        throwing_hash::calls_left = 5;
+        try {
+            m.rehash(buckets * 2);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        throwing_hash::calls_left = -1;
+        assert(m.size() == 14 && m.bucket_count() == buckets);
+        for (int i = 0; i < 14; ++i)
+            assert(m.at(i) == tidy::string(50, char('a' + i)));
+    }
+    {
+        tidy::unordered_flat_map<int, throwing_copy> m;
+        for (int i = 0; i < 14; ++i)
+            m.emplace(i, throwing_copy("a value long enough to allocate"));
+        std::size_t buckets = m.bucket_count();
+        throwing_copy::copies_left = 5;
+        try {
+            m.rehash(buckets * 2);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        throwing_copy::copies_left = -1;
+        assert(m.size() == 14 && m.bucket_count() == buckets);
+        for (int i = 0; i < 14; ++i)
+            assert(m.at(i).data == "a value long enough to allocate");
+        m.rehash(buckets * 2);
+        assert(m.bucket_count() == buckets * 2 && m.at(13).data.size() == 31);
+    }
+}
+
+bool is_zero(const void* p, std::size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(p);
+    for (std::size_t i = 0; i < size; ++i) {
+        if (bytes[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+// The allocator asserts that every array released by the map, i.e. the old
+// arrays after a rehash and the final ones on destruction, is all zero
+void test_wipe()
+{
+    typedef std::pair<const int, long> value_type;
+    typedef tidy::unordered_flat_map<int, long, std::hash<int>, std::equal_to<int>,
+                                     wipe_checking_allocator<value_type>> map_type;
+    typedef wipe_checking_allocator<std::pair<int, long>> slot_allocator;
+    {
+        map_type m;
+        int allocations = slot_allocator::allocations;
+        for (int i = 1; i <= 100; ++i)
+            m[i] = -i;
+        assert(slot_allocator::allocations - allocations > 1);
+
+        // erased slots are wiped right away
+        const value_type* erased = &*m.find(7);
+        assert(m.erase(7) == 1);
+        assert(is_zero(erased, sizeof(value_type)));
+
+        // clear wipes the slots and keeps them
+        std::vector<const value_type*> slots;
+        for (const value_type& v : m)
+            slots.push_back(&v);
+        std::size_t buckets = m.bucket_count();
+        m.clear();
+        assert(m.bucket_count() == buckets);
+        for (const value_type* slot : slots)
+            assert(is_zero(slot, sizeof(value_type)));
+
+        m[1] = 1;
+        m.rehash(0);
+        assert(m.at(1) == 1);
+    }
+}
+
+int main()
+{
+    {
+        tidy::unordered_flat_map<int, int> m;
+        assert(m.empty());
+        assert(m.bucket_count() == 0);
+        assert(m.find(1) == m.end());
+        assert(m.begin() == m.end());
+
+        for (int i = 0; i < 1000; ++i)
+            assert(m.emplace(i, i * 2).second);
+        assert(m.size() == 1000);
+        assert(m.load_factor() <= m.max_load_factor());
+        assert(!m.emplace(5, 0).second);
+        for (int i = 0; i < 1000; ++i) {
+            assert(m.contains(i));
+            assert(m.at(i) == i * 2);
+        }
+        assert(!m.contains(1000));
+        assert(m.count(-1) == 0);
+
+        int sum = 0;
+        std::size_t n = 0;
+        for (const auto& v : m) {
+            sum += v.first;
+            ++n;
+        }
+        assert(n == 1000);
+        assert(sum == 999 * 1000 / 2);
+
+        for (int i = 0; i < 1000; i += 2)
+            assert(m.erase(i) == 1);
+        assert(m.erase(0) == 0);
+        assert(m.size() == 500);
+        for (int i = 0; i < 1000; ++i)
+            assert(m.contains(i) == (i % 2 == 1));
+
+        bool thrown = false;
+        try {
+            m.at(0);
+        } catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        std::size_t cap = m.bucket_count();
+        m.clear();
+        assert(m.empty());
+        assert(m.bucket_count() == cap);
+        assert(m.begin() == m.end());
+    }
+    {
+        // erase by iterator while iterating
+        tidy::unordered_flat_map<int, int> m;
+        for (int i = 0; i < 100; ++i)
+            m[i] = i;
+        for (auto it = m.begin(); it != m.end();) {
+            if (it->first % 3 == 0)
+                it = m.erase(it);
+            else
+                ++it;
+        }
+        assert(m.size() == 66);
+        for (int i = 0; i < 100; ++i)
+            assert(m.contains(i) == (i % 3 != 0));
+    }
+    {
+        // randomized comparison against std::map, with tombstone reuse
+        tidy::unordered_flat_map<int, int> m;
+        std::map<int, int> model;
+        std::srand(1);
+        for (int i = 0; i < 20000; ++i) {
+            int key = std::rand() % 300;
+            if (std::rand() % 2 == 0) {
+                m[key] = i;
+                model[key] = i;
+            } else {
+                assert(m.erase(key) == model.erase(key));
+            }
+            assert(m.size() == model.size());
+        }
+        for (const auto& v : model)
+            assert(m.at(v.first) == v.second);
+        // the deleted slots are reused, so the table doesn't keep growing
+        assert(m.bucket_count() <= 1024);
+    }
+    {
+        // all keys collide
+        tidy::unordered_flat_map<int, int, bad_hash> m;
+        for (int i = 0; i < 100; ++i)
+            m.emplace(i, i);
+        for (int i = 0; i < 100; ++i)
+            assert(m.at(i) == i);
+        for (int i = 0; i < 50; ++i)
+            m.erase(i);
+        for (int i = 0; i < 100; ++i)
+            assert(m.contains(i) == (i >= 50));
+    }
+    {
+        typedef tidy::unordered_flat_map<tidy::string, tidy::string, string_hash> map_type;
+        map_type m;
+        m.try_emplace("key", "value");
+        m.insert_or_assign("key2", "value2");
+        m.insert_or_assign("key2", "value3");
+        m["key3"] = "value4";
+        assert(m.size() == 3);
+        assert(m.at("key2") == "value3");
+
+        map_type copy = m;
+        assert(copy == m);
+        copy["key"] = "other";
+        assert(copy != m);
+
+        map_type moved = std::move(copy);
+        assert(moved.size() == 3);
+        assert(moved.at("key") == "other");
+
+        swap(m, moved);
+        assert(m.at("key") == "other");
+        assert(moved.at("key") == "value");
+
+        // grow through several rehashes while the strings move
+        for (int i = 0; i < 500; ++i)
+            m[tidy::string(std::to_string(i).c_str())] = "x";
+        assert(m.size() == 503);
+        assert(m.at("250") == "x");
+    }
+    {
+        typedef tidy::static_string<15> key_type;
+        tidy::unordered_flat_map<key_type, int, string_hash> m = {
+            { key_type("a"), 1 }, { key_type("b"), 2 }
+        };
+        assert(m.size() == 2);
+        assert(m.at(key_type("b")) == 2);
+        m.reserve(100);
+        assert(m.bucket_count() * 7 / 8 >= 100);
+        assert(m.at(key_type("a")) == 1);
+        m.rehash(0);
+        assert(m.bucket_count() == 16);
+        assert(m.at(key_type("a")) == 1);
+    }
+    test_rehash_exceptions();
+    test_wipe();
+}
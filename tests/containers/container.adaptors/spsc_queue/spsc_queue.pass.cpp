@@ -0,0 +1,147 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyspscqueue.h>
+
+// template<class T> class spsc_queue
+
+#include "tidyspscqueue.h"
+#include "tidystring.h"
+#include <cassert>
+#include <cstdint>
+#include <set>
+#include <thread>
+
+struct counted {
+    static int alive;
+    int value;
+    explicit counted(int v = 0) : value(v) { ++alive; }
+    counted(const counted& other) : value(other.value) { ++alive; }
+    counted& operator=(const counted&) = default;
+    ~counted() { --alive; }
+};
+int counted::alive = 0;
+
+// records the address of the slot it is constructed in
+struct located {
+    static const void* last;
+    std::uint64_t value;
+    located() : value(0) {}
+    explicit located(std::uint64_t v) : value(v) { last = this; }
+    located& operator=(located&& other) = default;
+};
+const void* located::last = nullptr;
+
+// Checks that all bytes of a slot are zero after its element is popped
+bool storage_is_zero(const void* slot, std::size_t size)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(slot);
+    for (std::size_t i = 0; i < size; ++i) {
+        if (p[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+int main()
+{
+    {
+        tidy::spsc_queue<int> q(5);
+        assert(q.capacity() == 8);
+        assert(q.empty());
+        int out = -1;
+        assert(!q.try_pop(out) && out == -1);
+        for (int i = 0; i < 8; ++i)
+            assert(q.try_push(i));
+        assert(!q.try_push(8));
+        assert(q.size() == 8);
+        for (int round = 0; round < 100; ++round) {
+            assert(q.try_pop(out) && out == round);
+            assert(q.try_push(round + 8));
+        }
+        assert(q.size() == 8);
+    }
+    {
+        tidy::spsc_queue<tidy::vector<int>> q(4);
+        tidy::vector<int> v = { 1, 2, 3 };
+        const int* data = v.data();
+        assert(q.try_push(std::move(v)));
+        assert(q.try_emplace(5, 7));
+        tidy::vector<int> out;
+        assert(q.try_pop(out));
+        // moved without copying the elements
+        assert(out.data() == data && out.size() == 3);
+        assert(q.try_pop(out));
+        assert(out.size() == 5 && out[4] == 7);
+        assert(q.empty());
+    }
+    {
+        // the slots are wiped when popped, also after the indices wrap around
+        tidy::spsc_queue<located> q(4);
+        std::set<const void*> slots;
+        located out;
+        for (std::uint64_t i = 1; i <= 20; ++i) {
+            assert(q.try_emplace(~i));
+            const void* slot = located::last;
+            slots.insert(slot);
+            assert(!storage_is_zero(slot, sizeof(located)));
+            assert(q.try_pop(out) && out.value == ~i);
+            assert(storage_is_zero(slot, sizeof(located)));
+        }
+        assert(slots.size() == 4);
+    }
+    {
+        // only the popped slot is wiped while the queue is full
+        tidy::spsc_queue<located> q(4);
+        const void* slots[4];
+        for (std::uint64_t i = 0; i < 4; ++i) {
+            assert(q.try_emplace(i + 1));
+            slots[i] = located::last;
+        }
+        located out;
+        for (int i = 0; i < 4; ++i) {
+            assert(q.try_pop(out) && out.value == std::uint64_t(i + 1));
+            for (int k = 0; k < 4; ++k)
+                assert(storage_is_zero(slots[k], sizeof(located)) == (k <= i));
+        }
+    }
+    {
+        // remaining elements are destroyed with the queue
+        {
+            tidy::spsc_queue<counted> q(4);
+            counted c(1);
+            q.try_push(c);
+            q.try_push(c);
+            q.try_emplace(3);
+            counted out;
+            assert(q.try_pop(out) && out.value == 1);
+            assert(counted::alive == 4);
+        }
+        assert(counted::alive == 0);
+    }
+    {
+        const int count = 200000;
+        tidy::spsc_queue<tidy::string> q(64);
+        std::thread producer([&]() {
+            for (int i = 0; i < count; ++i) {
+                tidy::string s(std::size_t(i % 32), char('a' + i % 26));
+                while (!q.try_push(std::move(s))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        tidy::string s;
+        for (int i = 0; i < count; ++i) {
+            while (!q.try_pop(s)) {
+                std::this_thread::yield();
+            }
+            assert(s.size() == std::size_t(i % 32));
+            assert(s.empty() || s[0] == char('a' + i % 26));
+        }
+        producer.join();
+        assert(q.empty());
+    }
+}
@@ -0,0 +1,142 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidybytequeue.h>
+
+// class byte_queue
+
+#include "tidybytequeue.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <utility>
+
+std::string contents(const tidy::byte_queue& q)
+{
+    std::string result(q.size(), '\0');
+    q.copy_to(&result[0], 0, q.size());
+    return result;
+}
+
+// Checks that all bytes of the storage except the ones in the queue are zero
+// after the queue is emptied or cleared
+bool storage_is_zero(const tidy::byte_queue& q)
+{
+    const std::uint8_t* p = q.data();
+    for (std::size_t i = 0; i < q.capacity(); ++i) {
+        if (p[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+int main()
+{
+    {
+        tidy::byte_queue q;
+        assert(q.empty() && q.size() == 0 && q.capacity() == 0);
+        q.consume(0);
+        q.push("", 0);
+        assert(q.empty());
+        q.clear();
+    }
+    {
+        tidy::byte_queue q(8);
+        assert(q.capacity() == 8);
+        q.push("abcdef", 6);
+        q.consume(4);
+        assert(contents(q) == "ef" && q.front() == 'e' && q.back() == 'f');
+        // wraps around without reallocating
+        q.push("ghijk", 5);
+        assert(q.capacity() == 8);
+        assert(contents(q) == "efghijk");
+        assert(q[0] == 'e' && q[6] == 'k');
+        assert(q.contiguous_size() == 4);
+        assert(std::memcmp(q.data(), "efgh", 4) == 0);
+
+        const std::uint8_t* p = q.linearize();
+        assert(q.contiguous_size() == 7);
+        assert(std::memcmp(p, "efghijk", 7) == 0);
+        assert(q.capacity() == 8);
+
+        char out[3];
+        q.pop(out, 3);
+        assert(std::memcmp(out, "efg", 3) == 0);
+        assert(contents(q) == "hijk");
+
+        try {
+            q.consume(5);
+            assert(false);
+        } catch (const std::out_of_range&) {
+        }
+
+        // consumed bytes are wiped once the queue becomes empty
+        q.consume(4);
+        assert(q.empty() && q.contiguous_size() == 0);
+        assert(storage_is_zero(q));
+    }
+    {
+        tidy::byte_queue q(4);
+        q.push("abc", 3);
+        q.consume(2);
+        q.push("defgh", 5);
+        assert(q.capacity() == 8);
+        assert(contents(q) == "cdefgh");
+
+        tidy::byte_queue copy = q;
+        q.consume(1);
+        assert(contents(copy) == "cdefgh" && contents(q) == "defgh");
+        tidy::byte_queue moved = std::move(copy);
+        assert(contents(moved) == "cdefgh" && copy.empty());
+        swap(moved, q);
+        assert(contents(q) == "cdefgh" && contents(moved) == "defgh");
+
+        q.clear();
+        assert(q.empty() && storage_is_zero(q));
+    }
+    {
+        // stream of records consumed in linear time
+        tidy::byte_queue q;
+        std::size_t total = 0;
+        for (int i = 0; i < 10000; ++i) {
+            std::uint8_t record[5] = { 4, 'd', 'a', 't', std::uint8_t(i) };
+            q.push(record, 5);
+            while (q.size() >= 1 && q.size() >= std::size_t(q.front()) + 1) {
+                std::size_t len = q.front();
+                q.consume(1);
+                assert(q[3] == std::uint8_t(i));
+                q.consume(len);
+                total += len;
+            }
+        }
+        assert(total == 40000 && q.empty());
+        assert(q.capacity() <= 8);
+    }
+    {
+        tidy::byte_queue q;
+        std::string model;
+        unsigned seed = 1;
+        for (int i = 0; i < 20000; ++i) {
+            seed = seed * 1103515245 + 12345;
+            std::size_t count = (seed >> 16) % 13;
+            if ((seed >> 8) % 3 != 0) {
+                std::string bytes(count, char('a' + i % 26));
+                q.push(bytes.data(), count);
+                model += bytes;
+            } else {
+                count = std::min(count, model.size());
+                q.consume(count);
+                model.erase(0, count);
+            }
+            if (i % 7 == 0)
+                q.linearize();
+            assert(contents(q) == model);
+            if (q.empty())
+                assert(storage_is_zero(q));
+        }
+    }
+}
@@ -0,0 +1,248 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidychainedbuffer.h>
+
+// class chained_buffer
+
+#include "tidychainedbuffer.h"
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <utility>
+#if TIDY_HAS_IOVEC
+#include <unistd.h>
+#endif
+
+// The blocks whose memory must be zero when it is released
+struct watched_block {
+    const void* data;
+    std::size_t size;
+};
+watched_block watched[8];
+int watched_count = 0;
+int watched_released = 0;
+
+void watch(const std::uint8_t* data, std::size_t size)
+{
+    watched[watched_count++] = watched_block{ data, size };
+}
+
+bool is_zero(const std::uint8_t* p, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        if (p[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+void* operator new(std::size_t size)
+{
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    for (int i = 0; i < watched_count; ++i) {
+        if (watched[i].data == p) {
+            assert(is_zero(static_cast<const std::uint8_t*>(p), watched[i].size));
+            watched[i] = watched[--watched_count];
+            ++watched_released;
+            break;
+        }
+    }
+    std::free(p);
+}
+
+#if __cpp_sized_deallocation
+void operator delete(void* p, std::size_t) noexcept
+{
+    ::operator delete(p);
+}
+#endif
+
+std::string contents(const tidy::chained_buffer& b)
+{
+    std::string result(b.size(), '\0');
+    b.copy_to(&result[0]);
+    return result;
+}
+
+int main()
+{
+    {
+        tidy::chained_buffer b;
+        assert(b.empty() && b.size() == 0 && b.segment_count() == 0);
+        assert(b.coalesce() == nullptr);
+        b.append("", 0);
+        assert(b.empty() && b.segment_count() == 0);
+    }
+    {
+        // small appends fill the last segment
+        tidy::chained_buffer b(16);
+        b.append("hello", 5);
+        b.append(" world", 6);
+        assert(b.segment_count() == 1);
+        b.append(", how are you", 13);
+        assert(b.segment_count() == 2);
+        assert(contents(b) == "hello world, how are you");
+
+        b.prepend(">> ", 3);
+        assert(b.segment_count() == 3);
+        assert(contents(b) == ">> hello world, how are you");
+
+        b.trim_front(3);
+        b.trim_back(4);
+        assert(contents(b) == "hello world, how are");
+        assert(b.segment_count() == 2);
+        b.append("!", 1);
+        assert(contents(b) == "hello world, how are!");
+    }
+    {
+        // split and join without copying
+        tidy::chained_buffer b(8);
+        b.append("headerpayload", 13);
+        const std::uint8_t* first = b.coalesce();
+        tidy::chained_buffer head = b.split(6);
+        assert(contents(head) == "header" && contents(b) == "payload");
+        assert(head.coalesce() == first);
+        assert(b.coalesce() == first + 6);
+
+        // the shared segment is not written to in place
+        head.append("!", 1);
+        assert(contents(head) == "header!" && contents(b) == "payload");
+        assert(head.segment_count() == 2);
+
+        tidy::chained_buffer joined;
+        joined.append(head);
+        joined.append(std::move(b));
+        assert(b.empty());
+        assert(contents(joined) == "header!payload");
+        assert(contents(head) == "header!");
+        joined.prepend(joined);
+        assert(contents(joined) == "header!payloadheader!payload");
+
+        tidy::chained_buffer all = joined.split(joined.size());
+        assert(joined.empty() && all.size() == 28);
+        try {
+            all.split(29);
+            assert(false);
+        } catch (const std::out_of_range&) {
+        }
+    }
+    {
+        // copies are independent
+        tidy::chained_buffer a("abc", 3);
+        tidy::chained_buffer b = a;
+        b.append("def", 3);
+        a.append("xyz", 3);
+        assert(contents(a) == "abcxyz" && contents(b) == "abcdef");
+        a.trim_front(1);
+        assert(contents(b) == "abcdef");
+        b = std::move(a);
+        assert(contents(b) == "bcxyz" && a.empty());
+        swap(a, b);
+        assert(contents(a) == "bcxyz" && b.empty());
+    }
+    {
+        tidy::chained_buffer b(4);
+        for (char c = 'a'; c <= 'z'; ++c)
+            b.prepend(&c, 1);
+        assert(b.segment_count() == 26);
+        tidy::vector<std::uint8_t> v = b.to_vector();
+        assert(v.size() == 26 && v.front() == 'z' && v.back() == 'a');
+        const std::uint8_t* p = b.coalesce();
+        assert(b.segment_count() == 1);
+        assert(std::memcmp(p, "zyxwvutsrqponmlkjihgfedcba", 26) == 0);
+
+        std::size_t total = 0;
+        b.for_each_segment([&](const std::uint8_t*, std::size_t size) { total += size; });
+        assert(total == 26);
+    }
+    {
+        // removed bytes are wiped in place and dropped segments are wiped
+        // before their memory is released
+        tidy::chained_buffer b(16);
+        b.append("0123456789abcdef", 16);
+        b.append("ghijklmnopqrstuv", 16);
+        b.append("wxyz", 4);
+        const std::uint8_t* blocks[3];
+        int count = 0;
+        b.for_each_segment([&](const std::uint8_t* data, std::size_t) {
+            blocks[count++] = data;
+        });
+        assert(count == 3);
+        for (int i = 0; i < 3; ++i)
+            watch(blocks[i], 16);
+
+        b.trim_front(4);
+        assert(is_zero(blocks[0], 4));
+        b.trim_back(2);
+        assert(is_zero(blocks[2] + 2, 2));
+        assert(watched_released == 0);
+
+        b.trim_front(12);
+        assert(watched_released == 1);
+        b.trim_back(2);
+        assert(watched_released == 2);
+        assert(contents(b) == "ghijklmnopqrstuv");
+
+        // shared segments are left intact until the last buffer drops them
+        tidy::chained_buffer copy = b;
+        b.trim_front(3);
+        b.trim_back(3);
+        assert(contents(copy) == "ghijklmnopqrstuv");
+        b.clear();
+        assert(watched_released == 2);
+        copy.clear();
+        assert(watched_released == 3);
+
+        // coalesce releases the old segments
+        b.append("0123456789abcdef", 16);
+        b.append("ghij", 4);
+        count = 0;
+        b.for_each_segment([&](const std::uint8_t* data, std::size_t) {
+            blocks[count++] = data;
+        });
+        assert(count == 2);
+        watch(blocks[0], 16);
+        watch(blocks[1], 16);
+        b.coalesce();
+        assert(watched_released == 5 && watched_count == 0);
+        assert(contents(b) == "0123456789abcdefghij");
+    }
+#if TIDY_HAS_IOVEC
+    {
+        tidy::chained_buffer b(4);
+        b.append("0123", 4);
+        b.prepend("ab", 2);
+        iovec iov[8];
+        assert(b.fill_iovec(iov, 8) == 2);
+        assert(iov[0].iov_len == 2 && iov[1].iov_len == 4);
+        assert(std::memcmp(iov[1].iov_base, "0123", 4) == 0);
+        assert(b.fill_iovec(iov, 1) == 1);
+
+        int fds[2];
+        assert(::pipe(fds) == 0);
+        assert(b.write_to(fds[1]) == 6);
+        assert(b.empty());
+
+        tidy::chained_buffer in(4);
+        in.append("x", 1);
+        assert(in.read_from(fds[0], 6) == 6);
+        assert(contents(in) == "xab0123");
+        assert(in.segment_count() == 2);
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+#endif
+}
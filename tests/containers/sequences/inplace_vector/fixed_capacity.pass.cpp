@@ -0,0 +1,109 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyinplacevector.h>
+
+// Elements are always stored within the object and exceeding the capacity
+// throws
+
+#include "tidyinplacevector.h"
+#include <cassert>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include "count_new.hpp"
+
+typedef tidy::inplace_vector<int, 4> V;
+
+int main()
+{
+    static_assert(V::inline_capacity == 4, "");
+    {
+        V v;
+        assert(v.capacity() == 4);
+        assert(v.max_size() == 4);
+        const int* data = v.data();
+        for (int i = 0; i < 4; ++i)
+            v.push_back(i);
+        assert(v.data() == data);
+
+        try {
+            v.push_back(4);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(v.size() == 4 && v.data() == data);
+        assert(v[3] == 3);
+
+        try {
+            v.insert(v.begin(), 2, 10);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(v.size() == 4 && v[0] == 0);
+
+        try {
+            v.reserve(5);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        try {
+            v.resize(5);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(v.__invariants());
+
+        v.erase(v.begin(), v.begin() + 3);
+        assert(v.size() == 1 && v[0] == 3);
+        assert(data[1] == 0 && data[2] == 0 && data[3] == 0);
+        v.pop_back();
+        assert(data[0] == 0);
+    }
+    {
+        V v1, v2;
+        v1.push_back(1);
+        v1.push_back(2);
+        v2.push_back(3);
+        const int* data = v1.data();
+        v1.swap(v2);
+        assert(v1.size() == 1 && v1[0] == 3);
+        assert(v2.size() == 2 && v2[0] == 1 && v2[1] == 2);
+
+        V v3(std::move(v1));
+        assert(v3.size() == 1 && v3[0] == 3);
+        assert(v1.empty() && data[0] == 0);
+
+        v3 = v2;
+        assert(v3 == v2);
+    }
+    {
+        // input ranges longer than the capacity are rejected without
+        // allocating temporary storage
+        std::istringstream in("1 2 3 4 5 6");
+        V v;
+        v.push_back(7);
+        v.push_back(8);
+
+        // constructing the exception itself may allocate
+        globalMemCounter.reset();
+        try {
+            throw std::length_error("size > max_size()");
+        } catch (const std::length_error&) {
+        }
+        int exception_allocations = globalMemCounter.new_called;
+
+        globalMemCounter.reset();
+        try {
+            v.insert(v.begin() + 1, std::istream_iterator<int>(in),
+                     std::istream_iterator<int>());
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(globalMemCounter.checkNewCalledEq(exception_allocations));
+        assert(v.size() == 2 && v[0] == 7 && v[1] == 8);
+    }
+}
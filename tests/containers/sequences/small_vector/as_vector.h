@@ -0,0 +1,52 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// This header is included before the tidy::vector tests in order to run them
+// against tidy::small_vector. The inline capacity is small so that the tests
+// exercise both the inline and the allocated storage. tidy::small_vector
+// supports only trivial types, thus the tests use tidy::vector for other types.
+
+#ifndef TIDY_TESTS_SMALL_VECTOR_AS_VECTOR_H
+#define TIDY_TESTS_SMALL_VECTOR_AS_VECTOR_H
+
+#include "tidysmallvector.h"
+
+namespace tidy_small_vector {
+
+template<class T, class Allocator = std::allocator<T>>
+using vector = typename std::conditional<
+    std::is_trivial<T>::value,
+    tidy::small_vector<T, 4, Allocator>,
+    tidy::vector<T, Allocator>
+>::type;
+
+using tidy::erase;
+using tidy::erase_if;
+
+} // namespace tidy_small_vector
+
+// The alias above is not deducible, thus the tests need overloads for the
+// actual container types. small_vector doesn't annotate the storage for ASan.
+template<class T, class Alloc>
+bool is_contiguous_container_asan_correct(const tidy::small_vector<T, 4, Alloc>&)
+{
+    return true;
+}
+
+template<class T, class Alloc>
+bool is_contiguous_container_asan_correct(const tidy::vector<T, Alloc>&)
+{
+    return true;
+}
+
+// The iterators are plain pointers, thus unqualified calls in the tests don't
+// find the iterator functions via argument-dependent lookup
+using std::distance;
+using std::next;
+
+#define tidy tidy_small_vector
+
+#endif
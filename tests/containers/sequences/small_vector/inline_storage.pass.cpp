@@ -0,0 +1,120 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidysmallvector.h>
+
+// Transitions between the inline and the allocated storage
+
+#include "tidysmallvector.h"
+#include <cassert>
+#include <cstddef>
+
+#include "test_allocator.h"
+
+typedef tidy::small_vector<int, 4> V;
+
+void fill(V& v, std::size_t count, int first)
+{
+    v.clear();
+    for (std::size_t i = 0; i < count; ++i)
+        v.push_back(first + int(i));
+}
+
+bool check(const V& v, std::size_t count, int first)
+{
+    if (!v.__invariants() || v.size() != count)
+        return false;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (v[i] != first + int(i))
+            return false;
+    }
+    return true;
+}
+
+int main()
+{
+    {
+        V v;
+        assert(v.is_inline());
+        assert(v.capacity() == 4);
+        fill(v, 4, 0);
+        assert(v.is_inline());
+        const int* inline_data = v.data();
+
+        v.push_back(4);
+        assert(!v.is_inline());
+        assert(check(v, 5, 0));
+
+        // the inline storage has been wiped when the elements were moved out
+        for (int i = 0; i < 4; ++i)
+            assert(inline_data[i] == 0);
+
+        v.resize(3);
+        v.shrink_to_fit();
+        assert(v.is_inline());
+        assert(v.data() == inline_data);
+        assert(check(v, 3, 0));
+    }
+    {
+        V v;
+        fill(v, 3, 0);
+        const int* inline_data = v.data();
+        v.erase(v.begin(), v.begin() + 2);
+        assert(check(v, 1, 2));
+        assert(inline_data[1] == 0 && inline_data[2] == 0);
+        v.pop_back();
+        assert(inline_data[0] == 0);
+    }
+    {
+        // inserting into the middle moves the elements to the allocated
+        // storage and opens the gap at the same time
+        V v;
+        fill(v, 4, 0);
+        const int* inline_data = v.data();
+        int source[] = {10, 11, 12};
+        v.insert(v.begin() + 1, source, source + 3);
+        assert(!v.is_inline() && v.size() == 7);
+        assert(v[0] == 0 && v[1] == 10 && v[3] == 12 && v[4] == 1 && v[6] == 3);
+        for (int i = 0; i < 4; ++i)
+            assert(inline_data[i] == 0);
+    }
+    for (int size1 = 0; size1 < 7; ++size1) {
+        for (int size2 = 0; size2 < 7; ++size2) {
+            V v1, v2;
+            fill(v1, size1, 10);
+            fill(v2, size2, 20);
+            v1.swap(v2);
+            assert(check(v1, size2, 20));
+            assert(check(v2, size1, 10));
+            assert(v1.is_inline() == (size2 <= 4));
+            assert(v2.is_inline() == (size1 <= 4));
+
+            V v3(std::move(v1));
+            assert(check(v3, size2, 20));
+            assert(v1.empty() && v1.is_inline());
+
+            v3 = std::move(v2);
+            assert(check(v3, size1, 10));
+            assert(v2.empty() && v2.is_inline());
+        }
+    }
+    {
+        typedef tidy::small_vector<int, 2, test_allocator<int>> A;
+        int alloc_count = test_alloc_base::alloc_count;
+        {
+            A v(test_allocator<int>(5));
+            v.push_back(1);
+            v.push_back(2);
+            assert(test_alloc_base::alloc_count == alloc_count);
+            v.push_back(3);
+            assert(test_alloc_base::alloc_count == alloc_count + 1);
+
+            A v2(std::move(v), test_allocator<int>(6));
+            assert(v2.size() == 3 && v.empty());
+        }
+        assert(test_alloc_base::alloc_count == alloc_count);
+    }
+}
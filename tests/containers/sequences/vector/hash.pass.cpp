@@ -0,0 +1,57 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyhash.h>
+
+// template<class T, class Alloc>
+// struct hash<vector<T, Alloc>>
+
+#include "tidyhash.h"
+#include "tidyvector.h"
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+int main()
+{
+    {
+        typedef tidy::vector<std::uint8_t> V;
+        typedef std::hash<V> H;
+        static_assert(std::is_same<H::argument_type, V>::value, "");
+        H h;
+        V a = { 1, 2, 3 };
+        V b = { 1, 2, 4 };
+        assert(h(a) == h(V(a)));
+        assert(h(a) != h(b));
+        assert(h(V()) == h(V()));
+    }
+    {
+        typedef tidy::vector<int> V;
+        V a(1000, 7);
+        V b = a;
+        assert(std::hash<V>()(a) == std::hash<V>()(b));
+        b[999] = 8;
+        assert(std::hash<V>()(a) != std::hash<V>()(b));
+    }
+    {
+        // every byte affects the hash, whichever way the input is split up
+        typedef tidy::vector<std::uint8_t> V;
+        std::hash<V> h;
+        for (std::size_t size : { 1, 3, 8, 15, 16, 17, 31, 32, 33, 64, 65, 100,
+                                  256, 257, 320, 1024, 1025, 1100, 5000 }) {
+            V a(size);
+            for (std::size_t i = 0; i < size; ++i)
+                a[i] = std::uint8_t(i * 31);
+            std::size_t ha = h(a);
+            assert(ha != h(V(a.begin(), a.end() - 1)));
+            for (std::size_t i = 0; i < size; ++i) {
+                V b = a;
+                b[i] ^= 1;
+                assert(h(b) != ha);
+            }
+        }
+    }
+}
@@ -0,0 +1,208 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyvector.h>
+
+// Non-trivial element types are destroyed before their memory is wiped.
+// Trivially relocatable types are moved without calling their constructors.
+// Bulk insertion moves each existing element at most once.
+
+#include "tidyvector.h"
+#include <cassert>
+
+#include "test_iterators.h"
+
+const int magic = 0x5a5a;
+
+struct Counted {
+    static int alive;
+    static int moves;
+    static int copies_until_throw; // negative to never throw
+
+    int value;
+    int check;
+
+    Counted(int v = 0) : value(v), check(magic) { ++alive; }
+    Counted(const Counted& other) : value(other.value), check(magic)
+    {
+        if (copies_until_throw == 0)
+            throw 1;
+        --copies_until_throw;
+        ++alive;
+        ++moves;
+    }
+    Counted& operator=(const Counted& other) { value = other.value; ++moves; return *this; }
+    ~Counted()
+    {
+        // the memory must not be wiped before the destructor runs
+        assert(check == magic);
+        --alive;
+    }
+};
+
+int Counted::alive = 0;
+int Counted::moves = 0;
+int Counted::copies_until_throw = -1;
+
+struct Relocatable : Counted {
+    Relocatable(int v = 0) : Counted(v) {}
+};
+
+namespace tidy {
+template<> struct is_trivially_relocatable<Relocatable> : std::true_type {};
+}
+
+// Not relocatable: holds a pointer to itself
+struct SelfRef : Counted {
+    SelfRef* self;
+
+    SelfRef(int v = 0) : Counted(v), self(this) {}
+    SelfRef(const SelfRef& other) : Counted(other), self(this) {}
+    SelfRef& operator=(const SelfRef& other) { Counted::operator=(other); return *this; }
+    bool valid() const { return self == this; }
+};
+
+template<class T>
+bool is_wiped(const T* p)
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(p);
+    for (unsigned i = 0; i < sizeof(T); ++i) {
+        if (bytes[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+template<class V>
+bool check(const V& v, int first)
+{
+    if (!v.__invariants())
+        return false;
+    for (unsigned i = 0; i < v.size(); ++i) {
+        if (v[i].value != first + int(i))
+            return false;
+    }
+    return true;
+}
+
+template<class V>
+void test_common()
+{
+    {
+        V v;
+        for (int i = 0; i < 10; ++i)
+            v.emplace_back(i);
+        assert(check(v, 0));
+        assert(Counted::alive == 10);
+
+        v.erase(v.begin(), v.begin() + 3);
+        assert(check(v, 3));
+        assert(Counted::alive == 7);
+        assert(is_wiped(v.data() + 7) && is_wiped(v.data() + 9));
+
+        v.pop_back();
+        assert(Counted::alive == 6);
+        assert(is_wiped(v.data() + 6));
+
+        v.insert(v.begin(), 3, typename V::value_type(0));
+        assert(v.size() == 9 && v[2].value == 0 && v[3].value == 3);
+        v.erase(v.begin(), v.begin() + 3);
+        assert(check(v, 3));
+
+        v.clear();
+        assert(Counted::alive == 0);
+        assert(is_wiped(v.data()));
+    }
+    assert(Counted::alive == 0);
+    {
+        typedef typename V::value_type T;
+        T source[] = {T(100), T(101), T(102), T(103), T(104), T(105)};
+        V v;
+        for (int i = 0; i < 6; ++i)
+            v.emplace_back(i);
+        v.shrink_to_fit();
+
+        // reallocates, the new elements are inserted into the new storage
+        v.insert(v.begin() + 2, source, source + 6);
+        assert(v.size() == 12);
+        assert(v[1].value == 1 && v[2].value == 100 && v[7].value == 105 &&
+               v[8].value == 2 && v[11].value == 5);
+        v.erase(v.begin() + 2, v.begin() + 8);
+        assert(check(v, 0));
+
+        // input iterators
+        v.insert(v.begin() + 3, input_iterator<const T*>(source),
+                 input_iterator<const T*>(source + 3));
+        assert(v.size() == 9);
+        assert(v[2].value == 2 && v[3].value == 100 && v[5].value == 102 &&
+               v[6].value == 3);
+        v.erase(v.begin() + 3, v.begin() + 6);
+        assert(check(v, 0));
+
+        // a throwing copy leaves the vector unchanged
+        for (int reserve = 0; reserve < 2; ++reserve) {
+            if (reserve)
+                v.reserve(100);
+            const T* old_data = v.data();
+            Counted::copies_until_throw = 2;
+            try {
+                v.insert(v.begin() + 1, source, source + 6);
+                assert(false);
+            } catch (int) {
+            }
+            Counted::copies_until_throw = -1;
+            assert(check(v, 0) && v.size() == 6);
+            assert(v.data() == old_data);
+            assert(is_wiped(v.data() + 6));
+        }
+        assert(Counted::alive == 12);
+    }
+    assert(Counted::alive == 0);
+}
+
+int main()
+{
+    static_assert(tidy::is_trivially_relocatable<int>::value, "");
+    static_assert(!tidy::is_trivially_relocatable<SelfRef>::value, "");
+
+    test_common<tidy::vector<Relocatable>>();
+    test_common<tidy::vector<SelfRef>>();
+
+    {
+        tidy::vector<Relocatable> v;
+        v.reserve(2);
+        v.emplace_back(0);
+        v.emplace_back(1);
+        const Relocatable* old_data = v.data();
+        Counted::moves = 0;
+
+        v.emplace_back(2);
+        v.emplace(v.begin(), -1);
+        v.erase(v.begin());
+        // relocatable elements are moved as bytes
+        assert(Counted::moves == 1); // the temporary of emplace
+        assert(check(v, 0));
+        assert(v.data() != old_data);
+
+        // inserting into the middle while growing copies only the new elements
+        Relocatable source[] = {Relocatable(10), Relocatable(11)};
+        v.shrink_to_fit();
+        Counted::moves = 0;
+        v.insert(v.begin() + 1, source, source + 2);
+        assert(Counted::moves == 2);
+        assert(v[0].value == 0 && v[1].value == 10 && v[2].value == 11 &&
+               v[3].value == 1);
+    }
+    {
+        tidy::vector<SelfRef> v;
+        for (int i = 0; i < 20; ++i)
+            v.insert(v.begin() + i / 2, SelfRef(i));
+        v.shrink_to_fit();
+        for (unsigned i = 0; i < v.size(); ++i)
+            assert(v[i].valid());
+    }
+    assert(Counted::alive == 0);
+}
@@ -33,14 +33,13 @@
 #include "tidyvector.h"
 #include <iterator>
 #include <type_traits>
+#include <cassert>
 
 #include "test_allocator.h"
 #include "../../Copyable.h"
 #include "min_allocator.h"
 
-#if TIDY_EXPECTED_FAIL
 struct A { tidy::vector<A> v; }; // incomplete type support
-#endif
 
 template <class T, class Allocator>
 void
@@ -78,6 +77,12 @@ int main()
     test<Copyable, test_allocator<Copyable> >();
     static_assert((std::is_same<tidy::vector<char>::allocator_type,
                                 std::allocator<char> >::value), "");
+    static_assert((std::is_same<tidy::vector<char>::container_type,
+                                tidy::vector<char> >::value), "");
+    {
+        const tidy::vector<int> v(3, 1);
+        assert(&v.container() == &v);
+    }
 #if __cplusplus >= 201103L
     static_assert((std::is_same<tidy::vector<int, min_allocator<int>>::value_type, int>::value), "");
     static_assert((std::is_same<tidy::vector<int, min_allocator<int>>::allocator_type, min_allocator<int> >::value), "");
@@ -21,7 +21,6 @@
 
 int main()
 {
-#if TIDY_EXPECTED_FAIL
     {
         tidy::vector<MoveOnly> v(100);
         v.resize(50);
@@ -44,7 +43,6 @@ int main()
         assert(v.capacity() >= 200);
         assert(is_contiguous_container_asan_correct(v)); 
     }
-#endif
     {
         tidy::vector<int> v(100);
         v.resize(50);
@@ -68,7 +66,6 @@ int main()
         assert(is_contiguous_container_asan_correct(v)); 
     }
 #if __cplusplus >= 201103L
-#if TIDY_EXPECTED_FAIL
     {
         tidy::vector<MoveOnly, min_allocator<MoveOnly>> v(100);
         v.resize(50);
@@ -81,5 +78,4 @@ int main()
         assert(is_contiguous_container_asan_correct(v)); 
     }
 #endif
-#endif
 }
@@ -29,7 +29,6 @@ int main()
         assert(v.size() == 101);
         assert(is_contiguous_container_asan_correct(v)); 
     }
-#if TIDY_EXPECTED_FAIL
     {
         tidy::vector<int, stack_allocator<int, 401> > v(100);
         v.push_back(1);
@@ -50,7 +49,6 @@ int main()
         assert(is_contiguous_container_asan_correct(v)); 
     }
 #endif
-#endif // TIDY_EXPECTED_FAIL
 #if __cplusplus >= 201103L
     {
         tidy::vector<int, min_allocator<int>> v(100);
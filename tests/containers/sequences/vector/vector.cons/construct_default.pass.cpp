@@ -27,12 +27,10 @@ template <class C>
 void
 test0()
 {
-#if TIDY_EXPECTED_FAIL
 #if TEST_STD_VER > 14
 	static_assert((noexcept(C{})), "" );
 #elif TEST_STD_VER >= 11
 	static_assert((noexcept(C()) == noexcept(typename C::allocator_type())), "" );
-#endif
 #endif
     C c;
     assert(c.__invariants());
@@ -52,12 +50,10 @@ template <class C>
 void
 test1(const typename C::allocator_type& a)
 {
-#if TIDY_EXPECTED_FAIL
 #if TEST_STD_VER > 14
 	static_assert((noexcept(C{typename C::allocator_type{}})), "" );
 #elif TEST_STD_VER >= 11
 	static_assert((noexcept(C(typename C::allocator_type())) == std::is_nothrow_copy_constructible<typename C::allocator_type>::value), "" );
-#endif
 #endif
     C c(a);
     assert(c.__invariants());
@@ -70,14 +66,10 @@ int main()
 {
     {
     test0<tidy::vector<int> >();
-#if TIDY_EXPECTED_FAIL
     test0<tidy::vector<NotConstructible> >();
-#endif
     test1<tidy::vector<int, test_allocator<int> > >(test_allocator<int>(3));
-#if TIDY_EXPECTED_FAIL
     test1<tidy::vector<NotConstructible, test_allocator<NotConstructible> > >
         (test_allocator<NotConstructible>(5));
-#endif
     }
     {
         tidy::vector<int, stack_allocator<int, 10> > v;
@@ -86,14 +78,10 @@ int main()
 #if TEST_STD_VER >= 11
     {
     test0<tidy::vector<int, min_allocator<int>> >();
-#if TIDY_EXPECTED_FAIL
     test0<tidy::vector<NotConstructible, min_allocator<NotConstructible>> >();
-#endif
     test1<tidy::vector<int, min_allocator<int> > >(min_allocator<int>{});
-#if TIDY_EXPECTED_FAIL
     test1<tidy::vector<NotConstructible, min_allocator<NotConstructible> > >
         (min_allocator<NotConstructible>{});
-#endif
     }
     {
         tidy::vector<int, min_allocator<int> > v;
@@ -63,16 +63,12 @@ test(typename C::size_type n)
 int main()
 {
     test<tidy::vector<int> >(50);
-#if TIDY_EXPECTED_FAIL
     test<tidy::vector<DefaultOnly> >(500);
     assert(DefaultOnly::count == 0);
-#endif
 #if __cplusplus >= 201103L
     test<tidy::vector<int, min_allocator<int>> >(50);
-#if TIDY_EXPECTED_FAIL
     test<tidy::vector<DefaultOnly, min_allocator<DefaultOnly>> >(500);
     test2<tidy::vector<DefaultOnly, test_allocator<DefaultOnly>> >( 100, test_allocator<DefaultOnly>(23));
     assert(DefaultOnly::count == 0);
 #endif
-#endif
 }
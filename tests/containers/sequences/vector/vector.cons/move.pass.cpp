@@ -21,7 +21,6 @@
 
 int main()
 {
-#if TIDY_EXPECTED_FAIL
 #ifndef _LIBCPP_HAS_NO_RVALUE_REFERENCES
     {
         tidy::vector<MoveOnly, test_allocator<MoveOnly> > l(test_allocator<MoveOnly>(5));
@@ -102,5 +101,4 @@ int main()
     }
 #endif
 #endif  // _LIBCPP_HAS_NO_RVALUE_REFERENCES
-#endif // TIDY_EXPECTED_FAIL
 }
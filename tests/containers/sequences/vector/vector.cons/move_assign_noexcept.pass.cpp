@@ -47,7 +47,9 @@ int main()
     }
     {
         typedef tidy::vector<MoveOnly, some_alloc<MoveOnly>> C;
-        static_assert(!std::is_nothrow_move_assignable<C>::value, "");
+    //  if the allocators are always equal, then the move assignment can be
+    //  noexcept
+        static_assert( std::is_nothrow_move_assignable<C>::value, "");
     }
 #endif
 }
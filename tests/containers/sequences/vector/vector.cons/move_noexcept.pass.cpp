@@ -45,12 +45,9 @@ int main()
     }
     {
         typedef tidy::vector<MoveOnly, some_alloc<MoveOnly>> C;
-    //  In C++17, move constructors for allocators are not allowed to throw
-#if TEST_STD_VER > 14
+    //  Allocators are not allowed to throw on copy or move, thus tidy
+    //  containers have unconditionally noexcept move constructors
         static_assert( std::is_nothrow_move_constructible<C>::value, "");
-#else
-        static_assert(!std::is_nothrow_move_constructible<C>::value, "");
-#endif
     }
 #endif
 }
@@ -0,0 +1,83 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyvector.h>
+
+// template <class T, class Allocator, class U>
+//   typename vector<T, Allocator>::size_type
+//   erase(vector<T, Allocator>& c, const U& value);
+
+#include "tidyvector.h"
+#include <cassert>
+#include <type_traits>
+
+#include "min_allocator.h"
+#include "test_allocator.h"
+
+template <class S, class U>
+void test0(S s, U val, S expected, size_t expected_erased_count)
+{
+    static_assert(std::is_same<typename S::size_type,
+                               decltype(tidy::erase(s, val))>::value, "");
+    assert(expected_erased_count == tidy::erase(s, val));
+    assert(s.__invariants());
+    assert(s == expected);
+}
+
+template <class S>
+void test()
+{
+    test0(S(), 1, S(), 0);
+
+    test0(S({1}), 1, S(), 1);
+    test0(S({1}), 2, S({1}), 0);
+
+    test0(S({1, 2}), 1, S({2}), 1);
+    test0(S({1, 2}), 2, S({1}), 1);
+    test0(S({1, 2}), 3, S({1, 2}), 0);
+    test0(S({1, 1}), 1, S(), 2);
+    test0(S({1, 1}), 3, S({1, 1}), 0);
+
+    test0(S({1, 2, 3}), 1, S({2, 3}), 1);
+    test0(S({1, 2, 3}), 2, S({1, 3}), 1);
+    test0(S({1, 2, 3}), 3, S({1, 2}), 1);
+    test0(S({1, 2, 3}), 4, S({1, 2, 3}), 0);
+
+    test0(S({1, 1, 1}), 1, S(), 3);
+    test0(S({1, 1, 1}), 2, S({1, 1, 1}), 0);
+    test0(S({1, 1, 2}), 1, S({2}), 2);
+    test0(S({1, 1, 2}), 2, S({1, 1}), 1);
+    test0(S({1, 1, 2}), 3, S({1, 1, 2}), 0);
+    test0(S({1, 2, 2}), 1, S({2, 2}), 1);
+    test0(S({1, 2, 2}), 2, S({1}), 2);
+    test0(S({1, 2, 2}), 3, S({1, 2, 2}), 0);
+
+    // Test cross-type erasure
+    using opt = long;
+    test0(S({1, 2, 1}), opt(), S({1, 2, 1}), 0);
+    test0(S({1, 2, 1}), opt(1), S({2}), 2);
+    test0(S({1, 2, 1}), opt(2), S({1, 1}), 1);
+    test0(S({1, 2, 1}), opt(3), S({1, 2, 1}), 0);
+}
+
+int main()
+{
+    test<tidy::vector<int>>();
+    test<tidy::vector<int, min_allocator<int>>>();
+    test<tidy::vector<int, test_allocator<int>>>();
+
+    test<tidy::vector<long>>();
+    test<tidy::vector<double>>();
+
+    {
+        // the vacated tail is wiped
+        tidy::vector<int> v = {1, 2, 1, 3, 1};
+        const int* data = v.data();
+        assert(tidy::erase(v, 1) == 3);
+        assert(v == tidy::vector<int>({2, 3}));
+        assert(data[2] == 0 && data[3] == 0 && data[4] == 0);
+    }
+}
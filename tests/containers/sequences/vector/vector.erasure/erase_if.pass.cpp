@@ -0,0 +1,86 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyvector.h>
+
+// template <class T, class Allocator, class Predicate>
+//   typename vector<T, Allocator>::size_type
+//   erase_if(vector<T, Allocator>& c, Predicate pred);
+
+#include "tidyvector.h"
+#include <cassert>
+#include <type_traits>
+
+#include "min_allocator.h"
+#include "test_allocator.h"
+
+template <class S, class Pred>
+void test0(S s, Pred p, S expected, size_t expected_erased_count)
+{
+    static_assert(std::is_same<typename S::size_type,
+                               decltype(tidy::erase_if(s, p))>::value, "");
+    assert(expected_erased_count == tidy::erase_if(s, p));
+    assert(s.__invariants());
+    assert(s == expected);
+}
+
+template <typename S>
+void test()
+{
+    auto is1 = [](int v) { return v == 1; };
+    auto is2 = [](int v) { return v == 2; };
+    auto is3 = [](int v) { return v == 3; };
+    auto is4 = [](int v) { return v == 4; };
+    auto True  = [](int) { return true; };
+    auto False = [](int) { return false; };
+
+    test0(S(), is1, S(), 0);
+
+    test0(S({1}), is1, S(), 1);
+    test0(S({1}), is2, S({1}), 0);
+
+    test0(S({1, 2}), is1, S({2}), 1);
+    test0(S({1, 2}), is2, S({1}), 1);
+    test0(S({1, 2}), is3, S({1, 2}), 0);
+    test0(S({1, 1}), is1, S(), 2);
+    test0(S({1, 1}), is3, S({1, 1}), 0);
+
+    test0(S({1, 2, 3}), is1, S({2, 3}), 1);
+    test0(S({1, 2, 3}), is2, S({1, 3}), 1);
+    test0(S({1, 2, 3}), is3, S({1, 2}), 1);
+    test0(S({1, 2, 3}), is4, S({1, 2, 3}), 0);
+
+    test0(S({1, 1, 1}), is1, S(), 3);
+    test0(S({1, 1, 1}), is2, S({1, 1, 1}), 0);
+    test0(S({1, 1, 2}), is1, S({2}), 2);
+    test0(S({1, 1, 2}), is2, S({1, 1}), 1);
+    test0(S({1, 1, 2}), is3, S({1, 1, 2}), 0);
+    test0(S({1, 2, 2}), is1, S({2, 2}), 1);
+    test0(S({1, 2, 2}), is2, S({1}), 2);
+    test0(S({1, 2, 2}), is3, S({1, 2, 2}), 0);
+
+    test0(S({1, 2, 3}), True, S(), 3);
+    test0(S({1, 2, 3}), False, S({1, 2, 3}), 0);
+}
+
+int main()
+{
+    test<tidy::vector<int>>();
+    test<tidy::vector<int, min_allocator<int>>>();
+    test<tidy::vector<int, test_allocator<int>>>();
+
+    test<tidy::vector<long>>();
+    test<tidy::vector<double>>();
+
+    {
+        // the vacated tail is wiped
+        tidy::vector<int> v = {1, 2, 3, 4, 5, 6};
+        const int* data = v.data();
+        assert(tidy::erase_if(v, [](int x) { return x % 2 == 0; }) == 3);
+        assert(v == tidy::vector<int>({1, 3, 5}));
+        assert(data[3] == 0 && data[4] == 0 && data[5] == 0);
+    }
+}
@@ -56,7 +56,6 @@ public:
 
 int main()
 {
-#if TIDY_EXPECTED_FAIL
 #ifndef _LIBCPP_HAS_NO_RVALUE_REFERENCES
     {
         tidy::vector<A> c;
@@ -106,5 +105,4 @@ int main()
     }
 #endif
 #endif  // _LIBCPP_HAS_NO_RVALUE_REFERENCES
-#endif // TIDY_EXPECTED_FAIL
 }
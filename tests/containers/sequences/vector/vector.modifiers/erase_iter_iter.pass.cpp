@@ -27,16 +27,16 @@ int main()
         assert(is_contiguous_container_asan_correct(l1)); 
         tidy::vector<int>::iterator i = l1.erase(l1.cbegin(), l1.cbegin());
         assert(l1.size() == 3);
-        assert(distance(l1.cbegin(), l1.cend()) == 3);
+        assert(std::distance(l1.cbegin(), l1.cend()) == 3);
         assert(i == l1.begin());
         assert(is_contiguous_container_asan_correct(l1)); 
     }
     {
         tidy::vector<int> l1(a1, a1+3);
         assert(is_contiguous_container_asan_correct(l1)); 
-        tidy::vector<int>::iterator i = l1.erase(l1.cbegin(), next(l1.cbegin()));
+        tidy::vector<int>::iterator i = l1.erase(l1.cbegin(), std::next(l1.cbegin()));
         assert(l1.size() == 2);
-        assert(distance(l1.cbegin(), l1.cend()) == 2);
+        assert(std::distance(l1.cbegin(), l1.cend()) == 2);
         assert(i == l1.begin());
         assert(l1 == tidy::vector<int>(a1+1, a1+3));
         assert(is_contiguous_container_asan_correct(l1)); 
@@ -44,9 +44,9 @@ int main()
     {
         tidy::vector<int> l1(a1, a1+3);
         assert(is_contiguous_container_asan_correct(l1)); 
-        tidy::vector<int>::iterator i = l1.erase(l1.cbegin(), next(l1.cbegin(), 2));
+        tidy::vector<int>::iterator i = l1.erase(l1.cbegin(), std::next(l1.cbegin(), 2));
         assert(l1.size() == 1);
-        assert(distance(l1.cbegin(), l1.cend()) == 1);
+        assert(std::distance(l1.cbegin(), l1.cend()) == 1);
         assert(i == l1.begin());
         assert(l1 == tidy::vector<int>(a1+2, a1+3));
         assert(is_contiguous_container_asan_correct(l1)); 
@@ -54,13 +54,12 @@ int main()
     {
         tidy::vector<int> l1(a1, a1+3);
         assert(is_contiguous_container_asan_correct(l1)); 
-        tidy::vector<int>::iterator i = l1.erase(l1.cbegin(), next(l1.cbegin(), 3));
+        tidy::vector<int>::iterator i = l1.erase(l1.cbegin(), std::next(l1.cbegin(), 3));
         assert(l1.size() == 0);
-        assert(distance(l1.cbegin(), l1.cend()) == 0);
+        assert(std::distance(l1.cbegin(), l1.cend()) == 0);
         assert(i == l1.begin());
         assert(is_contiguous_container_asan_correct(l1)); 
     }
-#if TIDY_EXPECTED_FAIL
     {
         tidy::vector<tidy::vector<int> > outer(2, tidy::vector<int>(1));
         assert(is_contiguous_container_asan_correct(outer)); 
@@ -74,23 +73,22 @@ int main()
         assert(is_contiguous_container_asan_correct(outer[0])); 
         assert(is_contiguous_container_asan_correct(outer[1])); 
     }
-#endif
 #if __cplusplus >= 201103L
     {
         tidy::vector<int, min_allocator<int>> l1(a1, a1+3);
         assert(is_contiguous_container_asan_correct(l1)); 
         tidy::vector<int, min_allocator<int>>::iterator i = l1.erase(l1.cbegin(), l1.cbegin());
         assert(l1.size() == 3);
-        assert(distance(l1.cbegin(), l1.cend()) == 3);
+        assert(std::distance(l1.cbegin(), l1.cend()) == 3);
         assert(i == l1.begin());
         assert(is_contiguous_container_asan_correct(l1)); 
     }
     {
         tidy::vector<int, min_allocator<int>> l1(a1, a1+3);
         assert(is_contiguous_container_asan_correct(l1)); 
-        tidy::vector<int, min_allocator<int>>::iterator i = l1.erase(l1.cbegin(), next(l1.cbegin()));
+        tidy::vector<int, min_allocator<int>>::iterator i = l1.erase(l1.cbegin(), std::next(l1.cbegin()));
         assert(l1.size() == 2);
-        assert(distance(l1.cbegin(), l1.cend()) == 2);
+        assert(std::distance(l1.cbegin(), l1.cend()) == 2);
         assert(i == l1.begin());
         assert((l1 == tidy::vector<int, min_allocator<int>>(a1+1, a1+3)));
         assert(is_contiguous_container_asan_correct(l1)); 
@@ -98,9 +96,9 @@ int main()
     {
         tidy::vector<int, min_allocator<int>> l1(a1, a1+3);
         assert(is_contiguous_container_asan_correct(l1)); 
-        tidy::vector<int, min_allocator<int>>::iterator i = l1.erase(l1.cbegin(), next(l1.cbegin(), 2));
+        tidy::vector<int, min_allocator<int>>::iterator i = l1.erase(l1.cbegin(), std::next(l1.cbegin(), 2));
         assert(l1.size() == 1);
-        assert(distance(l1.cbegin(), l1.cend()) == 1);
+        assert(std::distance(l1.cbegin(), l1.cend()) == 1);
         assert(i == l1.begin());
         assert((l1 == tidy::vector<int, min_allocator<int>>(a1+2, a1+3)));
         assert(is_contiguous_container_asan_correct(l1)); 
@@ -108,13 +106,12 @@ int main()
     {
         tidy::vector<int, min_allocator<int>> l1(a1, a1+3);
         assert(is_contiguous_container_asan_correct(l1)); 
-        tidy::vector<int, min_allocator<int>>::iterator i = l1.erase(l1.cbegin(), next(l1.cbegin(), 3));
+        tidy::vector<int, min_allocator<int>>::iterator i = l1.erase(l1.cbegin(), std::next(l1.cbegin(), 3));
         assert(l1.size() == 0);
-        assert(distance(l1.cbegin(), l1.cend()) == 0);
+        assert(std::distance(l1.cbegin(), l1.cend()) == 0);
         assert(i == l1.begin());
         assert(is_contiguous_container_asan_correct(l1)); 
     }
-#if TIDY_EXPECTED_FAIL
     {
         tidy::vector<tidy::vector<int, min_allocator<int>>, min_allocator<tidy::vector<int, min_allocator<int>>>> outer(2, tidy::vector<int, min_allocator<int>>(1));
         assert(is_contiguous_container_asan_correct(outer)); 
@@ -129,5 +126,4 @@ int main()
         assert(is_contiguous_container_asan_correct(outer[1])); 
     }
 #endif
-#endif
 }
@@ -26,7 +26,6 @@
 int main()
 {
 #ifndef _LIBCPP_HAS_NO_RVALUE_REFERENCES
-#if TIDY_EXPECTED_FAIL
     {
         tidy::vector<MoveOnly> v(100);
         tidy::vector<MoveOnly>::iterator i = v.insert(v.cbegin() + 10, MoveOnly(3));
@@ -53,7 +52,6 @@ int main()
         for (++j; j < 101; ++j)
             assert(v[j] == MoveOnly());
     }
-#endif
 #if _LIBCPP_DEBUG >= 1
     {
         tidy::vector<int> v1(3);
@@ -63,7 +61,6 @@ int main()
     }
 #endif
 #if __cplusplus >= 201103L
-#if TIDY_EXPECTED_FAIL
     {
         tidy::vector<MoveOnly, min_allocator<MoveOnly>> v(100);
         tidy::vector<MoveOnly, min_allocator<MoveOnly>>::iterator i = v.insert(v.cbegin() + 10, MoveOnly(3));
@@ -77,7 +74,6 @@ int main()
         for (++j; j < 101; ++j)
             assert(v[j] == MoveOnly());
     }
-#endif
 #if _LIBCPP_DEBUG >= 1
     {
         tidy::vector<int, min_allocator<int>> v1(3);
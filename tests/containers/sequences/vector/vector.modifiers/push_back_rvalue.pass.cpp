@@ -21,8 +21,6 @@
 
 int main()
 {
-// the container supports only trivial types
-#if TIDY_EXPECTED_FAIL
 #ifndef _LIBCPP_HAS_NO_RVALUE_REFERENCES
     {
         tidy::vector<MoveOnly> c;
@@ -111,5 +109,4 @@ int main()
     }
 #endif
 #endif  // _LIBCPP_HAS_NO_RVALUE_REFERENCES
-#endif // TIDY_EXPECTED_FAIL
 }
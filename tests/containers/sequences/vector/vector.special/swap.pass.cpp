@@ -45,7 +45,7 @@ int main()
         swap(c1, c2);
         assert(c1 == tidy::vector<int>(a2, a2+sizeof(a2)/sizeof(a2[0])));
         assert(c2.empty());
-        assert(distance(c2.begin(), c2.end()) == 0);
+        assert(std::distance(c2.begin(), c2.end()) == 0);
         assert(is_contiguous_container_asan_correct(c1)); 
         assert(is_contiguous_container_asan_correct(c2)); 
     }
@@ -58,7 +58,7 @@ int main()
         assert(is_contiguous_container_asan_correct(c2)); 
         swap(c1, c2);
         assert(c1.empty());
-        assert(distance(c1.begin(), c1.end()) == 0);
+        assert(std::distance(c1.begin(), c1.end()) == 0);
         assert(c2 == tidy::vector<int>(a1, a1+sizeof(a1)/sizeof(a1[0])));
         assert(is_contiguous_container_asan_correct(c1)); 
         assert(is_contiguous_container_asan_correct(c2)); 
@@ -72,9 +72,9 @@ int main()
         assert(is_contiguous_container_asan_correct(c2)); 
         swap(c1, c2);
         assert(c1.empty());
-        assert(distance(c1.begin(), c1.end()) == 0);
+        assert(std::distance(c1.begin(), c1.end()) == 0);
         assert(c2.empty());
-        assert(distance(c2.begin(), c2.end()) == 0);
+        assert(std::distance(c2.begin(), c2.end()) == 0);
         assert(is_contiguous_container_asan_correct(c1)); 
         assert(is_contiguous_container_asan_correct(c2)); 
     }
@@ -133,7 +133,7 @@ int main()
         swap(c1, c2);
         assert((c1 == tidy::vector<int, min_allocator<int>>(a2, a2+sizeof(a2)/sizeof(a2[0]))));
         assert(c2.empty());
-        assert(distance(c2.begin(), c2.end()) == 0);
+        assert(std::distance(c2.begin(), c2.end()) == 0);
         assert(is_contiguous_container_asan_correct(c1)); 
         assert(is_contiguous_container_asan_correct(c2)); 
     }
@@ -146,7 +146,7 @@ int main()
         assert(is_contiguous_container_asan_correct(c2)); 
         swap(c1, c2);
         assert(c1.empty());
-        assert(distance(c1.begin(), c1.end()) == 0);
+        assert(std::distance(c1.begin(), c1.end()) == 0);
         assert((c2 == tidy::vector<int, min_allocator<int>>(a1, a1+sizeof(a1)/sizeof(a1[0]))));
         assert(is_contiguous_container_asan_correct(c1)); 
         assert(is_contiguous_container_asan_correct(c2)); 
@@ -160,9 +160,9 @@ int main()
         assert(is_contiguous_container_asan_correct(c2)); 
         swap(c1, c2);
         assert(c1.empty());
-        assert(distance(c1.begin(), c1.end()) == 0);
+        assert(std::distance(c1.begin(), c1.end()) == 0);
         assert(c2.empty());
-        assert(distance(c2.begin(), c2.end()) == 0);
+        assert(std::distance(c2.begin(), c2.end()) == 0);
         assert(is_contiguous_container_asan_correct(c1)); 
         assert(is_contiguous_container_asan_correct(c2)); 
     }
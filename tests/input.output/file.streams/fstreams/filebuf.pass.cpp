@@ -0,0 +1,118 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyfstream.h>
+
+// template <class charT, class traits = char_traits<charT> >
+// class basic_filebuf
+
+#include "tidyfstream.h"
+#include "tidystring.h"
+#include <cassert>
+#include <cstdio>
+#include <vector>
+
+const char* path = "tidy_filebuf_test.tmp";
+
+// Exposes the get area to check that it's wiped
+struct test_filebuf : tidy::filebuf {
+    explicit test_filebuf(std::size_t size) : tidy::filebuf(size) {}
+    char* get_begin() const { return eback(); }
+    char* get_end() const { return egptr(); }
+};
+
+int main()
+{
+    {
+        tidy::filebuf fb;
+        assert(!fb.is_open());
+        assert(fb.buffer_size() == 64 * 1024);
+        assert(fb.open(path, std::ios_base::out) == &fb);
+        assert(fb.is_open());
+        assert(fb.open(path, std::ios_base::out) == nullptr);
+        assert(fb.sputn("line one\nline two\n", 18) == 18);
+        assert(fb.close() == &fb);
+        assert(!fb.is_open());
+        assert(fb.close() == nullptr);
+    }
+    {
+        tidy::ifstream in(path);
+        assert(in.is_open());
+        tidy::string s;
+        assert(getline(in, s) && s == "line one");
+        assert(getline(in, s) && s == "line two");
+        assert(!getline(in, s));
+    }
+    {
+        tidy::ifstream in("tidy_filebuf_missing.tmp");
+        assert(!in.is_open() && in.fail());
+    }
+    {
+        // writes and reads larger than the buffer bypass it
+        std::vector<char> data(100000);
+        for (std::size_t i = 0; i < data.size(); ++i)
+            data[i] = char(i * 7);
+
+        tidy::basic_filebuf<char> out(1024);
+        out.open(path, std::ios_base::out | std::ios_base::trunc);
+        assert(out.sputc('x') == 'x');
+        assert(out.sputn(data.data(), data.size()) == std::streamsize(data.size()));
+        assert(out.sputc('y') == 'y');
+        out.close();
+
+        test_filebuf in(1024);
+        in.open(path, std::ios_base::in);
+        assert(in.sbumpc() == 'x');
+        std::vector<char> read(data.size());
+        assert(in.sgetn(read.data(), read.size()) == std::streamsize(read.size()));
+        assert(read == data);
+        assert(in.sbumpc() == 'y');
+        assert(in.sgetc() == std::char_traits<char>::eof());
+
+        // small reads go through the buffer, which is wiped on close
+        in.pubseekpos(10);
+        char small[10];
+        assert(in.sgetn(small, 10) == 10);
+        assert(std::equal(small, small + 10, data.begin() + 9));
+        assert(in.pubseekoff(0, std::ios_base::cur) == 20);
+        char* buf_begin = in.get_begin();
+        assert(buf_begin != nullptr && in.get_end() - buf_begin == 1024);
+        in.pubseekoff(0, std::ios_base::beg);
+        assert(in.get_begin() == nullptr);
+        assert(in.sgetc() == 'x');
+        in.close();
+    }
+    {
+        tidy::fstream f(path, std::ios_base::in | std::ios_base::out | std::ios_base::trunc);
+        assert(f.is_open());
+        f << "alpha beta";
+        f.seekg(0);
+        tidy::string word;
+        f >> word;
+        assert(word == "alpha");
+        f.seekp(0, std::ios_base::end);
+        f << " gamma";
+        f.seekg(6);
+        f >> word;
+        assert(word == "beta");
+        f >> word;
+        assert(word == "gamma");
+        f.clear();
+        assert(f.tellg() == 16);
+    }
+    {
+        tidy::ofstream out(path, std::ios_base::app);
+        out << "!";
+        out.close();
+        assert(out.good());
+        tidy::ifstream in(path, std::ios_base::ate);
+        assert(in.tellg() == 17);
+        tidy::ifstream in2(std::move(in));
+        in2.seekg(-1, std::ios_base::end);
+        assert(in2.get() == '!');
+    }
+    std::remove(path);
+}
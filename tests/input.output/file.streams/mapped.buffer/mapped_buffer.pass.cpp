@@ -0,0 +1,158 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidymappedbuffer.h>
+
+// class mapped_buffer
+
+#include "tidymappedbuffer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+const char* path = "tidy_mapped_buffer_test.tmp";
+
+void write_file(const std::string& data)
+{
+    std::FILE* f = std::fopen(path, "wb");
+    assert(f != nullptr);
+    assert(std::fwrite(data.data(), 1, data.size(), f) == data.size());
+    std::fclose(f);
+}
+
+std::string read_back()
+{
+    std::string result;
+    std::FILE* f = std::fopen(path, "rb");
+    assert(f != nullptr);
+    int c;
+    while ((c = std::fgetc(f)) != EOF)
+        result.push_back(char(c));
+    std::fclose(f);
+    return result;
+}
+
+#ifdef __linux__
+// Returns the amount of anonymous memory, i.e. private copies of file pages,
+// within the given range according to /proc/self/smaps
+long anonymous_kb(const void* addr, std::size_t size)
+{
+    std::uintptr_t first = reinterpret_cast<std::uintptr_t>(addr);
+    std::uintptr_t last = first + size;
+    std::FILE* f = std::fopen("/proc/self/smaps", "r");
+    assert(f != nullptr);
+    char line[512];
+    bool inside = false;
+    long total = 0;
+    while (std::fgets(line, sizeof(line), f)) {
+        unsigned long start, end;
+        if (std::sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+            // mprotect splits the mapping into several areas
+            inside = start >= first && start < last;
+            continue;
+        }
+        long kb;
+        if (inside && std::sscanf(line, "Anonymous: %ld kB", &kb) == 1)
+            total += kb;
+    }
+    std::fclose(f);
+    return total;
+}
+
+void test_private_copies(const std::string& data)
+{
+    long page_kb = ::sysconf(_SC_PAGESIZE) / 1024;
+    for (unsigned opts : { 0u, unsigned(tidy::mapped_buffer::lock_pages) }) {
+        tidy::mapped_buffer m(path, opts);
+        assert(std::equal(m.begin(), m.end(), data.begin()));
+        assert(anonymous_kb(m.data(), m.size()) == 0);
+
+        std::uint8_t* p = m.mutable_data(50000, 1);
+        *p = 1;
+        assert(anonymous_kb(m.data(), m.size()) == page_kb);
+
+        // a locked mapping is copied when it's made writable, otherwise
+        // only the pages that are written to are copied
+        if (!m.is_locked()) {
+            p = m.mutable_data();
+            p[0] = 1;
+            assert(anonymous_kb(m.data(), m.size()) == 2 * page_kb);
+        }
+    }
+}
+#endif
+
+int main()
+{
+    {
+        tidy::mapped_buffer m;
+        assert(!m.is_open());
+        assert(m.empty() && m.size() == 0 && m.begin() == m.end());
+    }
+    {
+        write_file("");
+        tidy::mapped_buffer m(path);
+        assert(m.empty());
+    }
+
+    std::string data;
+    for (int i = 0; i < 100000; ++i)
+        data.push_back(char(i % 127));
+    write_file(data);
+    {
+        tidy::mapped_buffer m(std::string(path), tidy::mapped_buffer::prefetch);
+        assert(m.is_open());
+        assert(m.size() == data.size());
+        assert(std::equal(m.begin(), m.end(), data.begin()));
+        assert(std::equal(m.rbegin(), m.rend(), data.rbegin()));
+        assert(m[1] == 1 && m.at(250) == 123 && m.front() == 0);
+        assert(m.back() == std::uint8_t(data.back()));
+        try {
+            m.at(m.size());
+            assert(false);
+        } catch (const std::out_of_range&) {
+        }
+
+        std::uint8_t* p = m.mutable_data(10, 5);
+        assert(p == m.data() + 10);
+        std::fill(p, p + 5, 0xff);
+        assert(m[10] == 0xff && m[14] == 0xff && m[15] == 15);
+
+        tidy::mapped_buffer m2(std::move(m));
+        assert(!m.is_open() && m2.size() == data.size());
+        assert(m2[12] == 0xff);
+        m = std::move(m2);
+        assert(m[12] == 0xff);
+    }
+    // the file is not affected by the modifications
+    assert(read_back() == data);
+#ifdef __linux__
+    test_private_copies(data);
+#endif
+    {
+        tidy::mapped_buffer m(path, tidy::mapped_buffer::lock_pages);
+        if (m.is_locked())
+            assert(std::equal(m.begin(), m.end(), data.begin()));
+        std::uint8_t* p = m.mutable_data();
+        p[0] = 42;
+        m.close();
+        assert(!m.is_open() && !m.is_locked());
+        m.open(path);
+        assert(m[0] == 0);
+    }
+    std::remove(path);
+    try {
+        tidy::mapped_buffer m(path);
+        assert(false);
+    } catch (const std::system_error& e) {
+        assert(e.code() == std::errc::no_such_file_or_directory);
+    }
+}
@@ -0,0 +1,72 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyfstream.h>
+
+// string read_file(const char* path);
+// vector<uint8_t> read_file_bytes(const char* path);
+
+#include "tidyfstream.h"
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <system_error>
+
+const char* path = "tidy_read_file_test.tmp";
+
+void write_file(const std::string& data)
+{
+    std::FILE* f = std::fopen(path, "wb");
+    assert(f != nullptr);
+    assert(std::fwrite(data.data(), 1, data.size(), f) == data.size());
+    std::fclose(f);
+}
+
+int main()
+{
+    {
+        write_file("");
+        tidy::string s = tidy::read_file(path);
+        assert(s.empty());
+        assert(tidy::read_file_bytes(path).empty());
+    }
+    {
+        write_file(std::string("a\0b\nc", 5));
+        tidy::string s = tidy::read_file(std::string(path));
+        assert(s.size() == 5);
+        assert(s == tidy::string("a\0b\nc", 5));
+        assert(s.capacity() == 6);
+
+        tidy::vector<std::uint8_t> v = tidy::read_file_bytes(path);
+        assert(v.size() == 5);
+        assert(v[1] == 0 && v[4] == 'c');
+        assert(v.capacity() == 6);
+    }
+    {
+        std::string data;
+        for (int i = 0; i < 3000000; ++i)
+            data.push_back(char(i % 251));
+        write_file(data);
+        tidy::string s = tidy::read_file(path);
+        assert(s.size() == data.size());
+        assert(std::string(s.data(), s.size()) == data);
+    }
+#ifdef __linux__
+    {
+        // the size of files in /proc is reported as zero
+        tidy::string s = tidy::read_file("/proc/self/status");
+        assert(s.size() > 0);
+        assert(s.find("Name:") == 0);
+    }
+#endif
+    std::remove(path);
+    try {
+        tidy::read_file(path);
+        assert(false);
+    } catch (const std::system_error& e) {
+        assert(e.code() == std::errc::no_such_file_or_directory);
+    }
+}
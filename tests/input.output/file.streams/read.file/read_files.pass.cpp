@@ -0,0 +1,95 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyfileloader.h>
+
+// template<class Container = string>
+// vector<loaded_file<Container>> read_files(const vector<string>& paths,
+//                                           read_files_backend backend, unsigned max_threads);
+
+#include "tidyfileloader.h"
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+std::vector<std::string> all_contents;
+
+std::string make_contents(std::size_t index)
+{
+    // a few files are larger than a single read
+    std::size_t size = index % 200 == 7 ? 3000000 : index * 13 % 5000;
+    std::string data;
+    for (std::size_t i = 0; i < size; ++i)
+        data.push_back(char((i + index) % 127));
+    return data;
+}
+
+std::string file_name(std::size_t index)
+{
+    return "tidy_read_files_test_" + std::to_string(index) + ".tmp";
+}
+
+template<class Container>
+void check(const std::vector<std::string>& paths,
+           const std::vector<tidy::loaded_file<Container>>& results)
+{
+    assert(results.size() == paths.size());
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        if (i % 100 == 99) {
+            assert(results[i].error == std::errc::no_such_file_or_directory);
+            assert(results[i].data.empty());
+            continue;
+        }
+        assert(!results[i].error);
+        const std::string& expected = all_contents[i];
+        assert(results[i].data.size() == expected.size());
+        assert(std::equal(expected.begin(), expected.end(), results[i].data.begin()));
+    }
+}
+
+int main()
+{
+    std::vector<std::string> paths;
+    for (std::size_t i = 0; i < 600; ++i) {
+        paths.push_back(file_name(i));
+        all_contents.push_back(make_contents(i));
+        if (i % 100 == 99)
+            continue; // missing file
+        const std::string& data = all_contents.back();
+        std::FILE* f = std::fopen(paths.back().c_str(), "wb");
+        assert(f != nullptr);
+        assert(std::fwrite(data.data(), 1, data.size(), f) == data.size());
+        std::fclose(f);
+    }
+
+    assert(tidy::read_files(std::vector<std::string>()).empty());
+
+    check(paths, tidy::read_files(paths));
+    check(paths, tidy::read_files(paths, tidy::read_files_backend::threads));
+    check(paths, tidy::read_files(paths, tidy::read_files_backend::threads, 1));
+    check(paths, tidy::read_files<tidy::vector<std::uint8_t>>(paths));
+    check(paths, tidy::read_files<tidy::vector<std::uint8_t>>(
+                     paths, tidy::read_files_backend::threads, 3));
+
+    auto future = tidy::read_files_async(paths);
+    check(paths, future.get());
+
+#ifdef __linux__
+    {
+        // the size of files in /proc is reported as zero
+        std::vector<std::string> proc(3, "/proc/self/status");
+        auto results = tidy::read_files(proc);
+        for (auto& r : results) {
+            assert(!r.error);
+            assert(r.data.find("Name:") == 0);
+        }
+    }
+#endif
+
+    for (auto& p : paths)
+        std::remove(p.c_str());
+}
@@ -0,0 +1,60 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidysstream.h>
+
+// template <class charT, class traits = char_traits<charT>, class Allocator = allocator<charT> >
+// class basic_stringbuf
+
+// The buffer grows geometrically, the old buffers are wiped and str() &&
+// doesn't copy the contents.
+
+#include "tidysstream.h"
+#include <cassert>
+
+#include "wipe_checking_allocator.h"
+
+typedef wipe_checking_allocator<char> A;
+typedef tidy::basic_stringbuf<char, std::char_traits<char>, A> SB;
+typedef tidy::basic_ostringstream<char, std::char_traits<char>, A> OS;
+
+int main()
+{
+    {
+        SB sb(std::ios_base::out);
+        int allocations = A::allocations;
+        for (int i = 0; i < 100000; ++i)
+            assert(sb.sputc(char('a' + i % 26)) == 'a' + i % 26);
+        // geometric growth
+        assert(A::allocations - allocations < 20);
+
+        SB::string_type s = sb.str();
+        assert(s.size() == 100000);
+        for (int i = 0; i < 100000; ++i)
+            assert(s[i] == 'a' + i % 26);
+
+        allocations = A::allocations;
+        SB::string_type moved = std::move(sb).str();
+        assert(A::allocations == allocations);
+        assert(moved == s);
+        assert(sb.str().empty());
+
+        sb.sputn("abc", 3);
+        assert(sb.str() == "abc");
+    }
+    {
+        OS os;
+        os << "host=db.example.com;password=" << 123456789 << ";port=" << 5432;
+        const char* expected = "host=db.example.com;password=123456789;port=5432";
+        assert(os.str() == expected);
+
+        int allocations = A::allocations;
+        OS::string_type s = std::move(os).str();
+        assert(A::allocations == allocations);
+        assert(s == expected);
+        assert(os.str().empty());
+    }
+}
@@ -0,0 +1,90 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidysstream.h>
+
+// basic_istringstream, basic_ostringstream and basic_stringstream
+
+#include "tidysstream.h"
+#include <cassert>
+#include <utility>
+
+int main()
+{
+    {
+        tidy::istringstream is(tidy::string(" 123 4.5 abc"));
+        int i = 0;
+        double d = 0;
+        is >> i >> d;
+        assert(i == 123 && d == 4.5);
+        char c1 = 0, c2 = 0;
+        is >> c1 >> c2;
+        assert(c1 == 'a' && c2 == 'b');
+        assert(is.rdbuf()->sungetc() == 'b');
+        assert(is.str() == " 123 4.5 abc");
+
+        is.str("7");
+        is.clear();
+        is >> i;
+        assert(i == 7);
+    }
+    {
+        tidy::ostringstream os;
+        os << "abc" << 1;
+        assert(os.str() == "abc1");
+        assert(os.tellp() == 4);
+        os.seekp(1);
+        os << 'X';
+        assert(os.str() == "aXc1");
+
+        tidy::ostringstream os2(std::move(os));
+        os2 << "de";
+        assert(os2.str() == "aXde");
+
+        tidy::ostringstream os3(tidy::string("123"), std::ios_base::ate);
+        os3 << "45";
+        assert(os3.str() == "12345");
+        os3.swap(os2);
+        assert(os3.str() == "aXde" && os2.str() == "12345");
+        os2 = std::move(os3);
+        assert(os2.str() == "aXde");
+    }
+    {
+        tidy::stringstream ss;
+        ss << "first second";
+        tidy::string word;
+        std::string std_word;
+        ss >> std_word;
+        assert(std_word == "first");
+        ss << " third";
+        ss.seekg(0, std::ios_base::end);
+        assert(ss.tellg() == 18);
+        ss.seekg(-5, std::ios_base::cur);
+        char buf[6] = {};
+        ss.read(buf, 5);
+        assert(tidy::string(buf) == "third");
+        assert(std::move(ss).str() == "first second third");
+    }
+    {
+        tidy::wstringstream ss;
+        ss << L"wide " << 42;
+        assert(ss.str() == L"wide 42");
+        int i = 0;
+        ss.seekg(5);
+        ss >> i;
+        assert(i == 42);
+    }
+    {
+        tidy::stringbuf sb(tidy::string("abc"), std::ios_base::in);
+        assert(sb.sputc('x') == std::char_traits<char>::eof());
+        assert(sb.sbumpc() == 'a');
+        assert(sb.sputbackc('z') == std::char_traits<char>::eof());
+        assert(sb.sputbackc('a') == 'a');
+        assert(sb.pubseekoff(0, std::ios_base::end, std::ios_base::in) == 3);
+        assert(sb.pubseekoff(1, std::ios_base::end, std::ios_base::in) == -1);
+        assert(sb.pubseekoff(0, std::ios_base::beg, std::ios_base::out) == -1);
+    }
+}
@@ -0,0 +1,77 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidyhash.h>
+
+// template<class CharT, class Traits, class Alloc>
+// struct hash<basic_string<CharT, Traits, Alloc>>
+
+#include "tidyhash.h"
+#include "tidystring.h"
+#include "tidystaticstring.h"
+#include "tidyunorderedflatmap.h"
+#include <cassert>
+#include <set>
+#include <string>
+#include <type_traits>
+
+template<class S>
+void test()
+{
+    typedef typename S::value_type C;
+    typedef std::hash<S> H;
+    static_assert(std::is_same<typename H::argument_type, S>::value, "");
+    static_assert(std::is_same<typename H::result_type, std::size_t>::value, "");
+
+    const C a[] = { 'a', 'b', 'c', 'd', 0 };
+    const C b[] = { 'a', 'b', 'c', 'e', 0 };
+    H h;
+    assert(h(S(a)) == h(S(a)));
+    assert(h(S(a)) != h(S(b)));
+    assert(h(S()) == h(S()));
+    assert(h(S()) != h(S(a, 1)));
+}
+
+int main()
+{
+    test<tidy::string>();
+    test<tidy::wstring>();
+    test<tidy::u16string>();
+    test<tidy::u32string>();
+
+    {
+        // the hash covers every byte for all lengths, including the
+        // overlapping reads of the tail
+        std::hash<tidy::string> h;
+        std::set<std::size_t> seen;
+        std::size_t count = 0;
+        for (std::size_t len = 0; len < 100; ++len) {
+            tidy::string s(len, 'x');
+            seen.insert(h(s));
+            ++count;
+            for (std::size_t i = 0; i < len; ++i) {
+                s[i] = 'y';
+                seen.insert(h(s));
+                ++count;
+                s[i] = 'x';
+            }
+        }
+        assert(seen.size() == count);
+    }
+    {
+        // the contents, not the allocator, determine the hash
+        tidy::string s = "some secret";
+        tidy::static_string<20> ss = "some secret";
+        assert(std::hash<tidy::string>()(s) == std::hash<tidy::static_string<20>>()(ss));
+    }
+    {
+        tidy::unordered_flat_map<tidy::string, int> m;
+        m["one"] = 1;
+        m["two"] = 2;
+        assert(m.at("one") == 1);
+        assert(m.at("two") == 2);
+    }
+}
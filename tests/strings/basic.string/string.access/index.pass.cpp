@@ -52,6 +52,14 @@ int main()
     assert(s2[0] == '\0');
     }
 #endif
+    {
+    // the terminator of an empty string is not shared with other strings
+    tidy::string a, b;
+    assert(&a[0] != &b[0]);
+    a[a.size()] = '\0';
+    assert(a.empty() && b.empty());
+    assert(b.c_str()[0] == '\0');
+    }
 #ifdef _LIBCPP_DEBUG
     {
         tidy::string s;
@@ -24,12 +24,10 @@ void
 test()
 {
     {
-#if TIDY_EXPECTED_FAIL
 #if TEST_STD_VER > 14
     static_assert((noexcept(S{})), "" );
 #elif TEST_STD_VER >= 11
     static_assert((noexcept(S()) == noexcept(typename S::allocator_type())), "" );
-#endif
 #endif
     S s;
     assert(s.__invariants());
@@ -39,12 +37,10 @@ test()
     assert(s.get_allocator() == typename S::allocator_type());
     }
     {
-#if TIDY_EXPECTED_FAIL
 #if TEST_STD_VER > 14
     static_assert((noexcept(S{typename S::allocator_type{}})), "" );
 #elif TEST_STD_VER >= 11
     static_assert((noexcept(S(typename S::allocator_type())) == std::is_nothrow_copy_constructible<typename S::allocator_type>::value), "" );
-#endif
 #endif
     S s(typename S::allocator_type(5));
     assert(s.__invariants());
@@ -62,12 +58,10 @@ void
 test2()
 {
     {
-#if TIDY_EXPECTED_FAIL
 #if TEST_STD_VER > 14
 	static_assert((noexcept(S{})), "" );
 #elif TEST_STD_VER >= 11
 	static_assert((noexcept(S()) == noexcept(typename S::allocator_type())), "" );
-#endif
 #endif
     S s;
     assert(s.__invariants());
@@ -77,12 +71,10 @@ test2()
     assert(s.get_allocator() == typename S::allocator_type());
     }
     {
-#if TIDY_EXPECTED_FAIL
 #if TEST_STD_VER > 14
 	static_assert((noexcept(S{typename S::allocator_type{}})), "" );
 #elif TEST_STD_VER >= 11
 	static_assert((noexcept(S(typename S::allocator_type())) == std::is_nothrow_copy_constructible<typename S::allocator_type>::value), "" );
-#endif
 #endif
     S s(typename S::allocator_type{});
     assert(s.__invariants());
@@ -42,7 +42,8 @@ int main()
     }
     {
         typedef tidy::basic_string<char, std::char_traits<char>, some_alloc<char>> C;
-        static_assert(!std::is_nothrow_destructible<C>::value, "");
+    //  tidy containers declare their destructors noexcept unconditionally
+        static_assert( std::is_nothrow_destructible<C>::value, "");
     }
 #endif
 }
@@ -48,12 +48,10 @@ int main()
     {
     typedef test_allocator<char> A;
     typedef tidy::basic_string<char, std::char_traits<char>, A> S;
-#if TIDY_EXPECTED_FAIL
 #if TEST_STD_VER > 14
 	static_assert((noexcept(S{})), "" );
 #elif TEST_STD_VER >= 11
 	static_assert((noexcept(S()) == std::is_nothrow_move_constructible<A>::value), "" );
-#endif
 #endif
     test(S(), A(3));
     test(S("1"), A(5));
@@ -64,12 +62,10 @@ int main()
     {
     typedef test_allocator<char> A;
     typedef tidy::basic_string<char, std::char_traits<char>, A> S;
-#if TIDY_EXPECTED_FAIL
 #if TEST_STD_VER > 14
 	static_assert((noexcept(S{})), "" );
 #elif TEST_STD_VER >= 11
 	static_assert((noexcept(S()) == std::is_nothrow_move_constructible<A>::value), "" );
-#endif
 #endif
     S s1 ( "Twas brillig, and the slivy toves did gyre and gymbal in the wabe" );
     S s2 (std::move(s1), A(1));
@@ -80,12 +76,10 @@ int main()
     {
     typedef min_allocator<char> A;
     typedef tidy::basic_string<char, std::char_traits<char>, A> S;
-#if TIDY_EXPECTED_FAIL
 #if TEST_STD_VER > 14
 	static_assert((noexcept(S{})), "" );
 #elif TEST_STD_VER >= 11
 	static_assert((noexcept(S()) == std::is_nothrow_move_constructible<A>::value), "" );
-#endif
 #endif
     test(S(), A());
     test(S("1"), A());
@@ -42,7 +42,9 @@ int main()
     }
     {
         typedef tidy::basic_string<char, std::char_traits<char>, some_alloc<char>> C;
-        static_assert(!std::is_nothrow_move_assignable<C>::value, "");
+    //  if the allocators are always equal, then the move assignment can be
+    //  noexcept
+        static_assert( std::is_nothrow_move_assignable<C>::value, "");
     }
 #endif
 }
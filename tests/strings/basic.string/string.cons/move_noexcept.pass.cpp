@@ -41,11 +41,9 @@ int main()
     }
     {
         typedef tidy::basic_string<char, std::char_traits<char>, some_alloc<char>> C;
-#if TEST_STD_VER <= 14
-        static_assert(!std::is_nothrow_move_constructible<C>::value, "");
-#else
+    //  Allocators are not allowed to throw on copy or move, thus tidy
+    //  containers have unconditionally noexcept move constructors
         static_assert( std::is_nothrow_move_constructible<C>::value, "");
-#endif
     }
 #endif
 }
@@ -0,0 +1,81 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidystring.h>
+
+// template <class charT, class traits, class Allocator, class U>
+//   typename basic_string<charT, traits, Allocator>::size_type
+//   erase(basic_string<charT, traits, Allocator>& c, const U& value);
+
+#include "tidystring.h"
+#include <cassert>
+#include <type_traits>
+
+#include "min_allocator.h"
+#include "test_allocator.h"
+
+template <class S, class U>
+void test0(S s, U val, S expected, size_t expected_erased_count)
+{
+    static_assert(std::is_same<typename S::size_type,
+                               decltype(tidy::erase(s, val))>::value, "");
+    assert(expected_erased_count == tidy::erase(s, val));
+    assert(s.__invariants());
+    assert(s == expected);
+}
+
+template <class S>
+void test()
+{
+    test0(S(""), 'a', S(""), 0);
+
+    test0(S("a"), 'a', S(""), 1);
+    test0(S("a"), 'b', S("a"), 0);
+
+    test0(S("ab"), 'a', S("b"), 1);
+    test0(S("ab"), 'b', S("a"), 1);
+    test0(S("ab"), 'c', S("ab"), 0);
+    test0(S("aa"), 'a', S(""), 2);
+    test0(S("aa"), 'c', S("aa"), 0);
+
+    test0(S("abc"), 'a', S("bc"), 1);
+    test0(S("abc"), 'b', S("ac"), 1);
+    test0(S("abc"), 'c', S("ab"), 1);
+    test0(S("abc"), 'd', S("abc"), 0);
+
+    test0(S("aab"), 'a', S("b"), 2);
+    test0(S("aab"), 'b', S("aa"), 1);
+    test0(S("aab"), 'c', S("aab"), 0);
+    test0(S("abb"), 'a', S("bb"), 1);
+    test0(S("abb"), 'b', S("a"), 2);
+    test0(S("abb"), 'c', S("abb"), 0);
+
+    test0(S("aaa"), 'a', S(""), 3);
+    test0(S("aaa"), 'b', S("aaa"), 0);
+
+    // Test cross-type erasure
+    using opt = int;
+    test0(S("aba"), opt(), S("aba"), 0);
+    test0(S("aba"), opt('a'), S("b"), 2);
+    test0(S("aba"), opt('b'), S("aa"), 1);
+    test0(S("aba"), opt('c'), S("aba"), 0);
+}
+
+int main()
+{
+    test<tidy::string>();
+    test<tidy::basic_string<char, std::char_traits<char>, min_allocator<char>>>();
+    test<tidy::basic_string<char, std::char_traits<char>, test_allocator<char>>>();
+
+    {
+        // the vacated tail is wiped and the string stays terminated
+        tidy::string s("xaxbx");
+        const char* data = s.data();
+        assert(tidy::erase(s, 'x') == 3);
+        assert(s == "ab");
+        assert(data[2] == 0 && data[3] == 0 && data[4] == 0 && data[5] == 0);
+    }
+}
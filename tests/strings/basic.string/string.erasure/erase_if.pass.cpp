@@ -0,0 +1,75 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidystring.h>
+
+// template <class charT, class traits, class Allocator, class Predicate>
+//   typename basic_string<charT, traits, Allocator>::size_type
+//   erase_if(basic_string<charT, traits, Allocator>& c, Predicate pred);
+
+#include "tidystring.h"
+#include <cassert>
+#include <type_traits>
+
+#include "min_allocator.h"
+#include "test_allocator.h"
+
+template <class S, class Pred>
+void test0(S s, Pred p, S expected, size_t expected_erased_count)
+{
+    static_assert(std::is_same<typename S::size_type,
+                               decltype(tidy::erase_if(s, p))>::value, "");
+    assert(expected_erased_count == tidy::erase_if(s, p));
+    assert(s.__invariants());
+    assert(s == expected);
+}
+
+template <typename S>
+void test()
+{
+    auto isA = [](char ch) { return ch == 'a'; };
+    auto isB = [](char ch) { return ch == 'b'; };
+    auto isC = [](char ch) { return ch == 'c'; };
+    auto isD = [](char ch) { return ch == 'd'; };
+    auto True  = [](char) { return true; };
+    auto False = [](char) { return false; };
+
+    test0(S(""), isA, S(""), 0);
+
+    test0(S("a"), isA, S(""), 1);
+    test0(S("a"), isB, S("a"), 0);
+
+    test0(S("ab"), isA, S("b"), 1);
+    test0(S("ab"), isB, S("a"), 1);
+    test0(S("ab"), isC, S("ab"), 0);
+    test0(S("aa"), isA, S(""), 2);
+    test0(S("aa"), isC, S("aa"), 0);
+
+    test0(S("abc"), isA, S("bc"), 1);
+    test0(S("abc"), isB, S("ac"), 1);
+    test0(S("abc"), isC, S("ab"), 1);
+    test0(S("abc"), isD, S("abc"), 0);
+
+    test0(S("aab"), isA, S("b"), 2);
+    test0(S("aab"), isB, S("aa"), 1);
+    test0(S("aab"), isC, S("aab"), 0);
+    test0(S("abb"), isA, S("bb"), 1);
+    test0(S("abb"), isB, S("a"), 2);
+    test0(S("abb"), isC, S("abb"), 0);
+
+    test0(S("aaa"), isA, S(""), 3);
+    test0(S("aaa"), isB, S("aaa"), 0);
+
+    test0(S("aba"), False, S("aba"), 0);
+    test0(S("aba"), True, S(""), 3);
+}
+
+int main()
+{
+    test<tidy::string>();
+    test<tidy::basic_string<char, std::char_traits<char>, min_allocator<char>>>();
+    test<tidy::basic_string<char, std::char_traits<char>, test_allocator<char>>>();
+}
@@ -0,0 +1,123 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidystring.h>
+
+// getline reads the buffered characters of the stream buffer in bulk
+
+#include "tidystring.h"
+#include "tidysstream.h"
+#include <cassert>
+#include <cstring>
+#include <sstream>
+#include <streambuf>
+
+#include "wipe_checking_allocator.h"
+
+typedef tidy::basic_string<char, std::char_traits<char>, wipe_checking_allocator<char>> S;
+
+// Exposes the source in chunks of the given size
+struct chunked_buf : std::streambuf {
+    const char* data;
+    std::size_t size;
+    std::size_t pos;
+    std::size_t chunk;
+
+    chunked_buf(const char* d, std::size_t c) :
+        data(d), size(std::strlen(d)), pos(0), chunk(c) {}
+
+    int_type underflow() override
+    {
+        if (pos == size)
+            return traits_type::eof();
+        std::size_t n = std::min(chunk, size - pos);
+        char* p = const_cast<char*>(data + pos);
+        setg(p, p, p + n);
+        pos += n;
+        return traits_type::to_int_type(*p);
+    }
+};
+
+// Provides no get area at all
+struct unbuffered_buf : std::streambuf {
+    const char* data;
+    explicit unbuffered_buf(const char* d) : data(d) {}
+
+    int_type underflow() override
+    {
+        return *data ? traits_type::to_int_type(*data) : traits_type::eof();
+    }
+    int_type uflow() override
+    {
+        return *data ? traits_type::to_int_type(*data++) : traits_type::eof();
+    }
+};
+
+template<class Buf>
+void test_lines(Buf& buf)
+{
+    std::istream in(&buf);
+    S s;
+    assert(getline(in, s));
+    assert(s == "first line");
+    assert(getline(in, s));
+    assert(s.empty());
+    assert(getline(in, s));
+    assert(s == "a somewhat longer third line");
+    assert(getline(in, s) && !in.eof());
+    assert(s == "last");
+    assert(!getline(in, s) && in.eof() && s.empty());
+}
+
+const char* text = "first line\n\na somewhat longer third line\nlast\n";
+
+int main()
+{
+    for (std::size_t chunk = 1; chunk < 12; ++chunk) {
+        chunked_buf buf(text, chunk);
+        test_lines(buf);
+    }
+    {
+        unbuffered_buf buf(text);
+        test_lines(buf);
+    }
+    {
+        // the last line lacks the delimiter
+        std::istringstream in("abc\ndef");
+        S s;
+        getline(in, s);
+        assert(s == "abc" && !in.eof());
+        getline(in, s);
+        assert(s == "def" && in.eof() && !in.fail());
+    }
+    {
+        // the capacity of the destination is reused
+        std::istringstream in("password1\npassword2\n");
+        S s;
+        s.reserve(32);
+        int allocations = wipe_checking_allocator<char>::allocations;
+        getline(in, s);
+        getline(in, s);
+        assert(s == "password2");
+        assert(wipe_checking_allocator<char>::allocations == allocations);
+    }
+    {
+        tidy::istringstream in(tidy::string("k1=v1;k2=v2"));
+        tidy::string s;
+        getline(in, s, '=');
+        assert(s == "k1");
+        getline(in, s, ';');
+        assert(s == "v1");
+        tidy::getline(in, s);
+        assert(s == "k2=v2");
+    }
+    {
+        std::wistringstream in(L"wide\nlines");
+        tidy::wstring s;
+        getline(in, s);
+        assert(s == L"wide");
+    }
+}
@@ -0,0 +1,150 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidystring.h>
+
+// operator<< and operator>> work on the stream buffer directly without
+// staging the contents in other strings
+
+#include "tidystring.h"
+#include <cassert>
+#include <sstream>
+#include <streambuf>
+
+#include "wipe_checking_allocator.h"
+
+typedef tidy::basic_string<char, std::char_traits<char>, wipe_checking_allocator<char>> S;
+
+// A stream buffer that accepts only a limited number of characters
+struct limited_buf : std::streambuf {
+    int left;
+    explicit limited_buf(int n) : left(n) {}
+    int_type overflow(int_type c) override
+    {
+        if (left-- <= 0)
+            return traits_type::eof();
+        return c;
+    }
+};
+
+// A stream buffer without a get area
+struct unbuffered_buf : std::streambuf {
+    const char* p;
+    explicit unbuffered_buf(const char* s) : p(s) {}
+    int_type underflow() override { return *p ? traits_type::to_int_type(*p) : traits_type::eof(); }
+    int_type uflow() override { return *p ? traits_type::to_int_type(*p++) : traits_type::eof(); }
+};
+
+struct throwing_buf : std::streambuf {
+    int_type underflow() override { throw 1; }
+};
+
+int main()
+{
+    {
+        S s("secret");
+        std::ostringstream out;
+        int allocations = wipe_checking_allocator<char>::allocations;
+        out << s;
+        assert(wipe_checking_allocator<char>::allocations == allocations);
+        assert(out.str() == "secret");
+
+        out.str("");
+        out.width(9);
+        out.fill('*');
+        out << s << s;
+        assert(out.str() == "***secretsecret");
+
+        out.str("");
+        out.width(9);
+        out << std::left << s;
+        assert(out.str() == "secret***");
+    }
+    {
+        S s(std::string("a\0b", 3).c_str(), 3);
+        std::ostringstream out;
+        out << s;
+        assert(out.str() == std::string("a\0b", 3));
+    }
+    {
+        limited_buf buf(3);
+        std::ostream out(&buf);
+        out << S("abcdef");
+        assert(out.bad());
+    }
+    {
+        std::istringstream in("  first second\tthird");
+        S s("old");
+        s.reserve(64);
+        int allocations = wipe_checking_allocator<char>::allocations;
+        in >> s;
+        assert(wipe_checking_allocator<char>::allocations == allocations);
+        assert(s == "first");
+        in.width(3);
+        in >> s;
+        assert(s == "sec" && in.width() == 0);
+        in >> s;
+        assert(s == "ond");
+        in >> s;
+        assert(s == "third" && in.eof() && !in.fail());
+        in >> s;
+        assert(in.fail());
+    }
+    {
+        std::istringstream in(" x");
+        in >> std::noskipws;
+        S s;
+        in >> s;
+        assert(in.fail() && s.empty());
+    }
+    {
+        // long words are appended in one run
+        std::string long_word(1000, 'q');
+        std::istringstream in(long_word + " tail");
+        S s;
+        in >> s;
+        assert(s.size() == 1000 && s == long_word.c_str());
+        in >> s;
+        assert(s == "tail");
+    }
+    {
+        unbuffered_buf buf(" one two");
+        std::istream in(&buf);
+        S s;
+        in >> s;
+        assert(s == "one");
+        in.width(2);
+        in >> s;
+        assert(s == "tw" && !in.eof());
+        in >> s;
+        assert(s == "o" && in.eof() && !in.fail());
+    }
+    {
+        std::wistringstream in(L"wide words");
+        tidy::wstring s;
+        in >> s;
+        assert(s == L"wide");
+        std::wostringstream out;
+        out << s;
+        assert(out.str() == L"wide");
+    }
+    {
+        throwing_buf buf;
+        std::istream in(&buf);
+        S s;
+        in >> s;
+        assert(in.bad());
+
+        std::istream in2(&buf);
+        in2.exceptions(std::ios_base::badbit);
+        try {
+            in2 >> s;
+            assert(false);
+        } catch (int) {
+        }
+        assert(in2.bad());
+    }
+}
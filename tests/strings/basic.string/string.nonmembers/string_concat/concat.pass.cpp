@@ -0,0 +1,69 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidystring.h>
+
+// template<class charT, class traits, class Allocator, class... Pieces>
+//   basic_string<charT,traits,Allocator>
+//   concat(const basic_string<charT,traits,Allocator>& first, const Pieces&... rest);
+
+#include "tidystring.h"
+#include "tidystaticstring.h"
+#include <cassert>
+#include <stdexcept>
+#include <string>
+
+#include "test_allocator.h"
+
+// Exposes the total number of allocations made through test_allocator
+struct allocation_counter : test_alloc_base {
+    static int total() { return time_to_throw; }
+};
+
+int main()
+{
+    {
+        tidy::string user("user");
+        std::string realm("realm");
+        tidy::string r = tidy::concat(user, ':', realm, ":", "secret");
+        assert(r == "user:realm:secret");
+        assert(r.capacity() == r.size());
+
+        assert(tidy::concat(user) == "user");
+        assert(tidy::concat(tidy::string(), "", tidy::string()).empty());
+    }
+    {
+        tidy::wstring a(L"a");
+        assert(tidy::concat(a, L'b', L"cd", std::wstring(L"e")) == L"abcde");
+    }
+    {
+        typedef tidy::basic_string<char, std::char_traits<char>, test_allocator<char>> S;
+        S a("Authorization", test_allocator<char>(3));
+        S b("c2VjcmV0", test_allocator<char>(4));
+        tidy::static_string<8> c("Basic");
+
+        int allocs = allocation_counter::total();
+        S r = tidy::concat(a, ": ", c, ' ', b, "\r\n");
+        assert(allocation_counter::total() == allocs + 1);
+        assert(r == "Authorization: Basic c2VjcmV0\r\n");
+        assert(r.get_allocator() == test_allocator<char>(3));
+
+        // operator+ of two lvalues allocates once too
+        allocs = allocation_counter::total();
+        S r2 = a + b;
+        assert(allocation_counter::total() == allocs + 1);
+        assert(r2 == "Authorizationc2VjcmV0");
+    }
+    {
+        tidy::static_string<5> a("abc");
+        assert(tidy::concat(a, "de") == "abcde");
+        try {
+            tidy::concat(a, "def");
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+    }
+}
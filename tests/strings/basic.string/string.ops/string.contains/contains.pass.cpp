@@ -0,0 +1,39 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidystring.h>
+
+// bool contains(const charT* s) const noexcept;
+// bool contains(const basic_string& str) const noexcept;
+// bool contains(const stdstring_type& str) const noexcept;
+// bool contains(charT c) const noexcept;
+
+#include "tidystring.h"
+#include <cassert>
+#include <string>
+
+int main()
+{
+    tidy::string s = "abcde";
+    tidy::string empty;
+
+    assert(s.contains(""));
+    assert(s.contains("bcd"));
+    assert(s.contains("abcde"));
+    assert(!s.contains("abcdef"));
+    assert(!s.contains("ce"));
+    assert(empty.contains(""));
+    assert(!empty.contains("a"));
+
+    assert(s.contains(tidy::string("cd")));
+    assert(!s.contains(tidy::string("dc")));
+    assert(s.contains(std::string("de")));
+    assert(!s.contains(std::string("x")));
+
+    assert(s.contains('c'));
+    assert(!s.contains('x'));
+    assert(!empty.contains('a'));
+}
@@ -0,0 +1,40 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidystring.h>
+
+// bool ends_with(const charT* s) const noexcept;
+// bool ends_with(const basic_string& str) const noexcept;
+// bool ends_with(const stdstring_type& str) const noexcept;
+// bool ends_with(charT c) const noexcept;
+
+#include "tidystring.h"
+#include <cassert>
+#include <string>
+
+int main()
+{
+    tidy::string s = "abcde";
+    tidy::string empty;
+
+    assert(s.ends_with(""));
+    assert(s.ends_with("e"));
+    assert(s.ends_with("abcde"));
+    assert(!s.ends_with("xabcde"));
+    assert(!s.ends_with("d"));
+    assert(empty.ends_with(""));
+    assert(!empty.ends_with("a"));
+
+    assert(s.ends_with(tidy::string("cde")));
+    assert(!s.ends_with(tidy::string("cdf")));
+    assert(s.ends_with(empty));
+    assert(s.ends_with(std::string("de")));
+    assert(!s.ends_with(std::string("cd")));
+
+    assert(s.ends_with('e'));
+    assert(!s.ends_with('d'));
+    assert(!empty.ends_with('e'));
+}
@@ -0,0 +1,41 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidystring.h>
+
+// bool starts_with(const charT* s) const noexcept;
+// bool starts_with(const basic_string& str) const noexcept;
+// bool starts_with(const stdstring_type& str) const noexcept;
+// bool starts_with(charT c) const noexcept;
+
+#include "tidystring.h"
+#include <cassert>
+#include <string>
+
+int main()
+{
+    tidy::string s = "abcde";
+    tidy::string empty;
+
+    assert(s.starts_with(""));
+    assert(s.starts_with("a"));
+    assert(s.starts_with("abcde"));
+    assert(!s.starts_with("abcdef"));
+    assert(!s.starts_with("b"));
+    assert(empty.starts_with(""));
+    assert(!empty.starts_with("a"));
+
+    assert(s.starts_with(tidy::string("abc")));
+    assert(!s.starts_with(tidy::string("abd")));
+    assert(s.starts_with(empty));
+    assert(s.starts_with(std::string("ab")));
+    assert(!s.starts_with(std::string("bc")));
+
+    assert(s.starts_with('a'));
+    assert(!s.starts_with('b'));
+    assert(!empty.starts_with('a'));
+    assert(!empty.starts_with('\0'));
+}
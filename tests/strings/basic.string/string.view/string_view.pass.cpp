@@ -0,0 +1,119 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidystring.h>
+
+// Interoperation with std::basic_string_view, C++17 and later
+
+#include "tidystring.h"
+#include "tidystaticstring.h"
+#include <cassert>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+static_assert(TIDY_HAS_STRING_VIEW, "");
+
+int main()
+{
+    using namespace std::literals;
+    std::string_view buf = "key=value;other"sv;
+    std::string_view key = buf.substr(0, 3);
+    std::string_view value = buf.substr(4, 5);
+
+    {
+        // construction
+        static_assert(!std::is_convertible<std::string_view, tidy::string>::value, "");
+        tidy::string s(key);
+        assert(s == "key");
+        tidy::string s2(buf, 4, 5);
+        assert(s2 == "value");
+        bool thrown = false;
+        try {
+            tidy::string s3(buf, 100, 1);
+        } catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    {
+        // conversion
+        tidy::string s = "abc";
+        std::string_view sv = s;
+        assert(sv.data() == s.data());
+        assert(sv.size() == 3);
+        std::string_view empty = tidy::string();
+        assert(empty.empty());
+    }
+    {
+        // assign, append, insert
+        tidy::string s;
+        s = key;
+        assert(s == "key");
+        s.assign(value);
+        assert(s == "value");
+        s.assign(buf, 10);
+        assert(s == "other");
+        s.append(key);
+        assert(s == "otherkey");
+        s.append(buf, 3, 1);
+        assert(s == "otherkey=");
+        s += value;
+        assert(s == "otherkey=value");
+        s.insert(0, "x"sv);
+        assert(s == "xotherkey=value");
+        s.insert(1, buf, 3, 1);
+        assert(s == "x=otherkey=value");
+    }
+    {
+        // compare and comparison operators
+        tidy::string s = "key";
+        assert(s.compare(key) == 0);
+        assert(s.compare(value) < 0);
+        assert(s.compare(0, 2, "ke"sv) == 0);
+        assert(s.compare(1, 2, buf, 1, 2) == 0);
+
+        assert(s == key);
+        assert(key == s);
+        assert(s != value);
+        assert(value != s);
+        assert(s < value);
+        assert(value > s);
+        assert(s <= key);
+        assert(key >= s);
+        assert(!(s > key));
+        assert(!(key < s));
+
+        tidy::static_string<8> ss = "key";
+        assert(ss == key);
+        assert(key == ss);
+    }
+    {
+        // search
+        tidy::string s = "abcabc";
+        assert(s.find("bc"sv) == 1);
+        assert(s.find("bc"sv, 2) == 4);
+        assert(s.rfind("bc"sv) == 4);
+        assert(s.find_first_of("cb"sv) == 1);
+        assert(s.find_first_not_of("ab"sv) == 2);
+        assert(s.find_last_of("ab"sv) == 4);
+        assert(s.find_last_not_of("bc"sv) == 3);
+        assert(s.starts_with("ab"sv));
+        assert(!s.starts_with("b"sv));
+        assert(s.ends_with("bc"sv));
+        assert(!s.ends_with("b"sv));
+        assert(s.contains("ca"sv));
+        assert(!s.contains("cb"sv));
+    }
+    {
+        tidy::string s = tidy::concat(tidy::string("a"), key, '=', value);
+        assert(s == "akey=value");
+    }
+    {
+        tidy::wstring s(L"wide"sv);
+        assert(s == L"wide"sv);
+    }
+}
@@ -0,0 +1,86 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidystaticstring.h>
+
+// Characters are always stored within the object and exceeding the capacity
+// throws
+
+#include "tidystaticstring.h"
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+typedef tidy::static_string<8> S;
+
+int main()
+{
+    {
+        S s;
+        assert(s.empty());
+        assert(s.capacity() == 8);
+        assert(s.max_size() == 8);
+        assert(*s.c_str() == 0);
+
+        s = "abcd";
+        const char* data = s.data();
+        s += "efgh";
+        assert(s == "abcdefgh");
+        assert(s.data() == data);
+        assert(s.c_str()[8] == 0);
+
+        try {
+            s.push_back('i');
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        try {
+            s.append("ij");
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        try {
+            s.insert(0, "x");
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        try {
+            s.reserve(9);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(s == "abcdefgh");
+        assert(s.__invariants());
+
+        s.erase(2);
+        assert(s == "ab");
+        for (int i = 2; i < 9; ++i)
+            assert(data[i] == 0);
+        s.clear();
+        assert(data[0] == 0 && data[1] == 0);
+    }
+    {
+        S s1("abc");
+        S s2("defgh");
+        s1.swap(s2);
+        assert(s1 == "defgh" && s2 == "abc");
+
+        S s3(std::move(s1));
+        assert(s3 == "defgh" && s1.empty());
+        assert(s1.__invariants());
+
+        S s4 = s3 + s2;
+        assert(s4 == "defghabc");
+        assert(s4.compare(s3) > 0);
+        assert(s4.find("abc") == 5);
+        assert(s4.substr(1, 3) == "efg");
+    }
+    {
+        tidy::wstatic_string<3> s(L"abc");
+        assert(s.size() == 3);
+        assert(s[2] == L'c');
+    }
+}
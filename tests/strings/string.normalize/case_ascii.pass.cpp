@@ -0,0 +1,77 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidystring.h>
+
+// template<class CharT, class Traits, class Alloc>
+// basic_string<CharT, Traits, Alloc>& to_lower_ascii(basic_string<CharT, Traits, Alloc>& str);
+// template<class CharT, class Traits, class Alloc>
+// basic_string<CharT, Traits, Alloc>& to_upper_ascii(basic_string<CharT, Traits, Alloc>& str);
+
+#include "tidystring.h"
+#include <cassert>
+#include <cctype>
+#include <string>
+
+void test_all_bytes()
+{
+    // covers both the vectorized loop and the tail
+    tidy::string s;
+    for (int i = 0; i < 256 + 7; ++i)
+        s.push_back(char(i));
+    const char* data = s.data();
+
+    tidy::string lower = s;
+    tidy::to_lower_ascii(lower);
+    tidy::string upper = s;
+    tidy::to_upper_ascii(upper);
+    for (std::size_t i = 0; i < s.size(); ++i) {
+        unsigned char c = s[i];
+        unsigned char expected_lower = c >= 'A' && c <= 'Z' ? c + 32 : c;
+        unsigned char expected_upper = c >= 'a' && c <= 'z' ? c - 32 : c;
+        assert((unsigned char)lower[i] == expected_lower);
+        assert((unsigned char)upper[i] == expected_upper);
+    }
+
+    tidy::to_upper_ascii(s);
+    assert(s == upper);
+    assert(s.data() == data);
+}
+
+int main()
+{
+    {
+        tidy::string s;
+        assert(&tidy::to_lower_ascii(s) == &s);
+        assert(tidy::to_upper_ascii(s).empty());
+    }
+    {
+        tidy::string s("Hello, World! @[`{");
+        tidy::to_lower_ascii(s);
+        assert(s == "hello, world! @[`{");
+        tidy::to_upper_ascii(s);
+        assert(s == "HELLO, WORLD! @[`{");
+    }
+    {
+        tidy::string s("User.Name@Example.COM with a longer tail");
+        tidy::to_lower_ascii(s);
+        assert(s == "user.name@example.com with a longer tail");
+    }
+    {
+        tidy::wstring s(L"Mixed Ä Case");
+        tidy::to_upper_ascii(s);
+        assert(s == L"MIXED Ä CASE");
+        tidy::to_lower_ascii(s);
+        assert(s == L"mixed Ä case");
+    }
+    {
+        tidy::u16string s(u"AbC");
+        tidy::to_lower_ascii(s);
+        assert(s == u"abc");
+    }
+
+    test_all_bytes();
+}
@@ -0,0 +1,56 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidystring.h>
+
+// template<class CharT, class Traits, class Alloc>
+// basic_string<CharT, Traits, Alloc>&
+//     translate(basic_string<CharT, Traits, Alloc>& str, const CharT (&table)[256]);
+
+#include "tidystring.h"
+#include <cassert>
+#include <string>
+
+int main()
+{
+    char identity[256];
+    for (int i = 0; i < 256; ++i)
+        identity[i] = char(i);
+
+    {
+        tidy::string s;
+        assert(&tidy::translate(s, identity) == &s);
+        assert(s.empty());
+    }
+    {
+        // normalizes a license key: separators are mapped to dashes, letters
+        // to upper case and then the dashes are stripped
+        char table[256];
+        for (int i = 0; i < 256; ++i)
+            table[i] = char(i >= 'a' && i <= 'z' ? i - 32 : i);
+        table[(unsigned char)' '] = '-';
+        table[(unsigned char)'_'] = '-';
+
+        tidy::string s("ab12_cd34 ef56-GH78");
+        const char* data = s.data();
+        tidy::translate(s, table);
+        assert(s == "AB12-CD34-EF56-GH78");
+        tidy::erase(s, '-');
+        assert(s == "AB12CD34EF56GH78");
+        assert(s.data() == data);
+    }
+    {
+        char table[256];
+        for (int i = 0; i < 256; ++i)
+            table[i] = char(255 - i);
+        tidy::string s;
+        for (int i = 0; i < 256; ++i)
+            s.push_back(char(i));
+        tidy::translate(s, table);
+        for (int i = 0; i < 256; ++i)
+            assert((unsigned char)s[i] == 255 - i);
+    }
+}
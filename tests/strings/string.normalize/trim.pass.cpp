@@ -0,0 +1,94 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidystring.h>
+
+// template<class CharT, class Traits, class Alloc>
+// basic_string<CharT, Traits, Alloc>&
+//     trim(basic_string<CharT, Traits, Alloc>& str, const CharT* chars = whitespace);
+// trim_left and trim_right have the same signature
+
+#include "tidystring.h"
+#include <cassert>
+#include <string>
+
+template<class S>
+void test_trim(const char* in, const char* left, const char* right, const char* both)
+{
+    S s(in);
+    tidy::trim_left(s);
+    assert(s == left);
+
+    s = in;
+    tidy::trim_right(s);
+    assert(s == right);
+
+    s = in;
+    assert(&tidy::trim(s) == &s);
+    assert(s == both);
+}
+
+void test_no_reallocation()
+{
+    tidy::string s("  \t a long enough value to be allocated on the heap \r\n");
+    s.reserve(100);
+    const char* data = s.data();
+    std::size_t capacity = s.capacity();
+    std::size_t old_size = s.size();
+
+    tidy::trim(s);
+    assert(s == "a long enough value to be allocated on the heap");
+    assert(s.data() == data);
+    assert(s.capacity() == capacity);
+    assert(s.data()[s.size()] == '\0');
+
+    // the vacated tail has been wiped
+    for (std::size_t i = s.size(); i < old_size; ++i)
+        assert(data[i] == '\0');
+}
+
+int main()
+{
+    test_trim<tidy::string>("", "", "", "");
+    test_trim<tidy::string>(" \t\n\v\f\r", "", "", "");
+    test_trim<tidy::string>("abc", "abc", "abc", "abc");
+    test_trim<tidy::string>("  abc", "abc", "  abc", "abc");
+    test_trim<tidy::string>("abc \n", "abc \n", "abc", "abc");
+    test_trim<tidy::string>(" a b c ", "a b c ", " a b c", "a b c");
+    test_trim<tidy::string>("\x85" "a\xa0", "\x85" "a\xa0", "\x85" "a\xa0", "\x85" "a\xa0");
+
+    {
+        tidy::string s("--12-34--");
+        tidy::trim(s, "-");
+        assert(s == "12-34");
+        tidy::trim_left(s, "0123456789");
+        assert(s == "-34");
+        tidy::trim_right(s, "");
+        assert(s == "-34");
+    }
+    {
+        // runs of trimmed characters longer than 16
+        for (std::size_t n = 0; n < 40; ++n) {
+            tidy::string s(n, ' ');
+            s += "x\t";
+            s.append(n, '\r');
+            tidy::trim(s);
+            assert(s == "x");
+        }
+    }
+    {
+        tidy::wstring s(L"\t value \n");
+        tidy::trim(s);
+        assert(s == L"value");
+    }
+    {
+        tidy::u32string s(U"  value  ");
+        tidy::trim(s);
+        assert(s == U"value");
+    }
+
+    test_no_reallocation();
+}
@@ -0,0 +1,150 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+// <tidysplit.h>
+
+// template<class CharT, class Traits, class Alloc>
+// basic_split_range<CharT, Traits>
+//     split(const basic_string<CharT, Traits, Alloc>& str, const CharT* delims);
+
+#include "tidysplit.h"
+#include "tidystaticstring.h"
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+template<class Range>
+std::vector<std::string> collect(const Range& range)
+{
+    std::vector<std::string> result;
+    for (const auto& piece : range)
+        result.push_back(std::string(piece.data(), piece.size()));
+    return result;
+}
+
+template<class T>
+struct is_rvalue_splittable {
+    template<class U>
+    static auto test(int) -> decltype(tidy::split(std::declval<U>(), ":"), std::true_type());
+    template<class U>
+    static std::false_type test(...);
+    static const bool value = decltype(test<T>(0))::value;
+};
+
+// splits with std::string::find_first_of
+std::vector<std::string> naive_split(const std::string& s, const std::string& delims)
+{
+    std::vector<std::string> result;
+    std::size_t start = 0;
+    for (;;) {
+        std::size_t end = s.find_first_of(delims, start);
+        if (end == std::string::npos)
+            break;
+        result.push_back(s.substr(start, end - start));
+        start = end + 1;
+    }
+    result.push_back(s.substr(start));
+    return result;
+}
+
+int main()
+{
+    {
+        tidy::string s = "user:pass@host";
+        auto r = collect(tidy::split(s, ":@"));
+        assert((r == std::vector<std::string>{ "user", "pass", "host" }));
+
+        // the pieces point into the original string
+        auto it = tidy::split(s, ":@").begin();
+        assert(it->data() == s.data());
+        ++it;
+        assert(it->data() == s.data() + 5);
+        assert(*it == "pass");
+    }
+    {
+        tidy::string s = "k=v;k2=v2;";
+        std::vector<std::string> keys;
+        for (auto kv : tidy::split(s, ";")) {
+            if (kv.empty())
+                continue;
+            auto it = tidy::split(kv, "=").begin();
+            keys.push_back(it->to_owned().c_str());
+            ++it;
+            tidy::string value = it->to_owned();
+            assert(value == (keys.size() == 1 ? "v" : "v2"));
+        }
+        assert((keys == std::vector<std::string>{ "k", "k2" }));
+    }
+    {
+        // empty pieces
+        tidy::string empty;
+        auto r = collect(tidy::split(empty, ","));
+        assert((r == std::vector<std::string>{ "" }));
+        tidy::string s = ",a,,b,";
+        r = collect(tidy::split(s, ","));
+        assert((r == std::vector<std::string>{ "", "a", "", "b", "" }));
+        s = "abc";
+        r = collect(tidy::split(s, ""));
+        assert((r == std::vector<std::string>{ "abc" }));
+        tidy::string delims = "b";
+        r = collect(tidy::split(s, delims));
+        assert((r == std::vector<std::string>{ "a", "c" }));
+    }
+    {
+        // bytes above 0x7f in both the string and the delimiters
+        tidy::string s = "a\xff" "b\x80" "c";
+        auto r = collect(tidy::split(s, "\x80\xff"));
+        assert((r == std::vector<std::string>{ "a", "b", "c" }));
+    }
+    {
+        // long strings and sets of various sizes, so that delimiters are
+        // found at every position within and across blocks of 16 characters
+        const char* sets[] = { "\x80\xff", "abcdefghijklmnop", "abcdefghijklmnopa",
+                               "abcdefghijklmnopq", "0123456789abcdefghijklmnopqrstuv" };
+        std::srand(1);
+        for (const char* delims : sets) {
+            for (int iter = 0; iter < 200; ++iter) {
+                tidy::string s;
+                for (int i = std::rand() % 100; i > 0; --i)
+                    s.push_back(std::rand() % 8 == 0 ? delims[std::rand() % std::strlen(delims)] : 'z' + 1);
+                assert(collect(tidy::split(s, delims)) ==
+                       naive_split(std::string(s.c_str(), s.size()), delims));
+            }
+        }
+    }
+    {
+        tidy::wstring s = L"a b\tc";
+        auto range = tidy::split(s, L" \t");
+        std::vector<tidy::wstring> r;
+        for (auto piece : range)
+            r.push_back(piece.to_owned());
+        assert(r.size() == 3);
+        assert(r[0] == L"a" && r[1] == L"b" && r[2] == L"c");
+        assert(std::distance(range.begin(), range.end()) == 3);
+    }
+    {
+        tidy::static_string<32> s = "x,y";
+        tidy::string_slice first = *tidy::split(s, ",").begin();
+        assert(first == "x");
+        assert(first != "y");
+        assert(first.compare("y") < 0);
+        assert(first.to_owned<std::allocator<char>>() == tidy::string("x"));
+    }
+    {
+        tidy::string s = "a,b";
+        auto it = tidy::split(s, ",").begin();
+        auto copy = it++;
+        assert(*copy == "a");
+        assert(*it == "b");
+        assert(copy != it);
+    }
+    static_assert(!is_rvalue_splittable<tidy::string>::value, "");
+    static_assert(is_rvalue_splittable<const tidy::string&>::value, "");
+}
@@ -0,0 +1,66 @@
+//  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+//
+//  Distributed under the Boost Software License, Version 1.0.
+//      (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef WIPE_CHECKING_ALLOCATOR_H
+#define WIPE_CHECKING_ALLOCATOR_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+// An allocator that asserts that the memory is wiped before it is released
+// and counts the allocations and deallocations.
+template <class T>
+struct wipe_checking_allocator
+{
+    typedef T value_type;
+
+    static int allocations;
+    static int deallocations;
+
+    wipe_checking_allocator() {}
+    template <class U> wipe_checking_allocator(const wipe_checking_allocator<U>&) {}
+
+    T* allocate(std::size_t n)
+    {
+        ++allocations;
+        // fresh memory is zeroed so that any data found on deallocation
+        // has been written by the container
+        void* p = ::operator new(n * sizeof(T));
+        std::memset(p, 0, n * sizeof(T));
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        ++deallocations;
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(p);
+        for (std::size_t i = 0; i < n * sizeof(T); ++i)
+            assert(bytes[i] == 0);
+        ::operator delete(p);
+    }
+};
+
+template <class T>
+int wipe_checking_allocator<T>::allocations = 0;
+
+template <class T>
+int wipe_checking_allocator<T>::deallocations = 0;
+
+template <class T, class U>
+bool operator==(const wipe_checking_allocator<T>&, const wipe_checking_allocator<U>&)
+{
+    return true;
+}
+
+template <class T, class U>
+bool operator!=(const wipe_checking_allocator<T>&, const wipe_checking_allocator<U>&)
+{
+    return false;
+}
+
+#endif
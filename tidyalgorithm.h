@@ -0,0 +1,366 @@
+/*  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+
+    Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+            http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef TIDY_TIDYALGORITHM_H
+#define TIDY_TIDYALGORITHM_H
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "tidyvector.h"
+
+/*  Algorithms that need scratch memory. The standard equivalents copy the
+    elements into temporary buffers that are released without being wiped.
+    The algorithms below use tidy::vector as the scratch buffer instead.
+
+    Unlike the standard algorithms, these don't fall back to slower
+    algorithms when the scratch can't be allocated; std::bad_alloc is thrown
+    instead.
+*/
+
+namespace tidy {
+namespace detail {
+
+/*  Storage for a single temporary object that is wiped after the object is
+    destroyed, so that no copies of the elements remain on the stack.
+*/
+template<class T>
+class wiped_temp {
+public:
+    template<class... Args>
+    explicit wiped_temp(Args&& ... args)
+    {
+        ::new(static_cast<void*>(&storage_)) T(std::forward<Args>(args)...);
+    }
+
+    wiped_temp(const wiped_temp&) = delete;
+    wiped_temp& operator=(const wiped_temp&) = delete;
+
+    ~wiped_temp()
+    {
+        get().~T();
+        secure_delete(&storage_, sizeof(storage_));
+    }
+
+    T& get() noexcept { return *reinterpret_cast<T*>(&storage_); }
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_;
+};
+
+template<class It>
+using scratch_buffer = vector<typename std::iterator_traits<It>::value_type>;
+
+static const std::ptrdiff_t insertion_sort_threshold = 32;
+static const std::ptrdiff_t min_parallel_chunk = 8192;
+
+template<class RandomIt, class Compare>
+void insertion_sort(RandomIt first, RandomIt last, Compare& comp)
+{
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    if (first == last)
+        return;
+    for (RandomIt i = first + 1; i != last; ++i) {
+        if (!comp(*i, *(i - 1)))
+            continue;
+        wiped_temp<value_type> temp(std::move(*i));
+        RandomIt j = i;
+        do {
+            *j = std::move(*(j - 1));
+            --j;
+        } while (j != first && comp(temp.get(), *(j - 1)));
+        *j = std::move(temp.get());
+    }
+}
+
+// Merges two sorted ranges by moving the left one to the scratch buffer
+template<class BidirIt, class Compare, class Buffer>
+void merge_forward(BidirIt first, BidirIt middle, BidirIt last,
+                   Buffer& buf, Compare& comp)
+{
+    buf.assign(std::make_move_iterator(first), std::make_move_iterator(middle));
+    auto b = buf.begin();
+    BidirIt out = first;
+    while (b != buf.end() && middle != last) {
+        if (comp(*middle, *b)) {
+            *out = std::move(*middle);
+            ++middle;
+        } else {
+            *out = std::move(*b);
+            ++b;
+        }
+        ++out;
+    }
+    std::move(b, buf.end(), out);
+    buf.clear();
+}
+
+// Merges two sorted ranges by moving the right one to the scratch buffer
+template<class BidirIt, class Compare, class Buffer>
+void merge_backward(BidirIt first, BidirIt middle, BidirIt last,
+                    Buffer& buf, Compare& comp)
+{
+    buf.assign(std::make_move_iterator(middle), std::make_move_iterator(last));
+    auto b = buf.end();
+    BidirIt out = last;
+    while (b != buf.begin() && middle != first) {
+        auto prev_b = std::prev(b);
+        BidirIt prev_middle = std::prev(middle);
+        if (comp(*prev_b, *prev_middle)) {
+            *--out = std::move(*prev_middle);
+            middle = prev_middle;
+        } else {
+            *--out = std::move(*prev_b);
+            b = prev_b;
+        }
+    }
+    std::move_backward(buf.begin(), b, out);
+    buf.clear();
+}
+
+template<class BidirIt, class Compare, class Buffer>
+void merge_buffered(BidirIt first, BidirIt middle, BidirIt last,
+                    Buffer& buf, Compare& comp)
+{
+    if (first == middle || middle == last)
+        return;
+    if (!comp(*middle, *std::prev(middle)))
+        return; // already in order
+
+    if (std::distance(first, middle) <= std::distance(middle, last))
+        merge_forward(first, middle, last, buf, comp);
+    else
+        merge_backward(first, middle, last, buf, comp);
+}
+
+template<class RandomIt, class Compare, class Buffer>
+void stable_sort_buffered(RandomIt first, RandomIt last, Buffer& buf, Compare& comp)
+{
+    if (last - first <= insertion_sort_threshold) {
+        insertion_sort(first, last, comp);
+        return;
+    }
+    RandomIt middle = first + (last - first) / 2;
+    stable_sort_buffered(first, middle, buf, comp);
+    stable_sort_buffered(middle, last, buf, comp);
+    merge_buffered(first, middle, last, buf, comp);
+}
+
+// Returns the number of chunks a range of the given size is split into
+inline unsigned parallel_chunk_count(std::ptrdiff_t size, unsigned max_threads)
+{
+    if (max_threads == 0)
+        max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::ptrdiff_t chunks = std::min<std::ptrdiff_t>(max_threads,
+                                                     size / min_parallel_chunk);
+    return chunks < 1 ? 1 : unsigned(chunks);
+}
+
+// Splits [first, last) into the given number of chunks of nearly equal size.
+// Returns the boundaries of the chunks.
+template<class RandomIt>
+std::vector<RandomIt> split_chunks(RandomIt first, RandomIt last, unsigned chunks)
+{
+    std::vector<RandomIt> bounds;
+    auto size = last - first;
+    for (unsigned i = 0; i <= chunks; ++i)
+        bounds.push_back(first + size * i / chunks);
+    return bounds;
+}
+
+/*  Calls f(i) for each i in [0, count) concurrently and waits for all calls to
+    complete. The first exception thrown by any of the calls is rethrown. If a
+    thread can't be started, the call is made on the calling thread.
+*/
+template<class F>
+void run_parallel(unsigned count, F f)
+{
+    std::vector<std::exception_ptr> errors(count);
+    auto run = [&](unsigned i) {
+        try {
+            f(i);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for (unsigned i = 1; i < count; ++i) {
+        try {
+            threads.emplace_back(run, i);
+        } catch (const std::system_error&) {
+            run(i);
+        }
+    }
+    run(0);
+    for (auto& t : threads)
+        t.join();
+
+    for (auto& e : errors) {
+        if (e)
+            std::rethrow_exception(e);
+    }
+}
+
+} // namespace detail
+
+template<class RandomIt, class Compare>
+void stable_sort(RandomIt first, RandomIt last, Compare comp)
+{
+    if (last - first <= detail::insertion_sort_threshold) {
+        detail::insertion_sort(first, last, comp);
+        return;
+    }
+    detail::scratch_buffer<RandomIt> buf;
+    buf.reserve((last - first + 1) / 2);
+    detail::stable_sort_buffered(first, last, buf, comp);
+}
+
+template<class RandomIt>
+void stable_sort(RandomIt first, RandomIt last)
+{
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    tidy::stable_sort(first, last, std::less<value_type>());
+}
+
+template<class BidirIt, class Compare>
+void inplace_merge(BidirIt first, BidirIt middle, BidirIt last, Compare comp)
+{
+    detail::scratch_buffer<BidirIt> buf;
+    buf.reserve(std::min(std::distance(first, middle), std::distance(middle, last)));
+    detail::merge_buffered(first, middle, last, buf, comp);
+}
+
+template<class BidirIt>
+void inplace_merge(BidirIt first, BidirIt middle, BidirIt last)
+{
+    using value_type = typename std::iterator_traits<BidirIt>::value_type;
+    tidy::inplace_merge(first, middle, last, std::less<value_type>());
+}
+
+template<class BidirIt, class UnaryPredicate>
+BidirIt stable_partition(BidirIt first, BidirIt last, UnaryPredicate pred)
+{
+    // the leading elements that satisfy pred are already in place
+    first = std::find_if_not(first, last, pred);
+    if (first == last)
+        return first;
+
+    detail::scratch_buffer<BidirIt> buf;
+    buf.reserve(std::distance(first, last));
+
+    BidirIt out = first;
+    for (BidirIt it = first; it != last; ++it) {
+        if (pred(*it)) {
+            *out = std::move(*it);
+            ++out;
+        } else {
+            buf.push_back(std::move(*it));
+        }
+    }
+    std::move(buf.begin(), buf.end(), out);
+    return out;
+}
+
+/*  Same as stable_sort, but sorts chunks of large ranges on separate threads
+    and then merges them, again in parallel. Each thread uses its own scratch
+    buffer. max_threads limits the number of threads; the default is
+    std::thread::hardware_concurrency(). Ranges shorter than
+    detail::min_parallel_chunk elements per thread are sorted on the calling
+    thread.
+
+    comp is copied to each thread.
+*/
+template<class RandomIt, class Compare>
+void parallel_stable_sort(RandomIt first, RandomIt last, Compare comp,
+                          unsigned max_threads = 0)
+{
+    unsigned chunks = detail::parallel_chunk_count(last - first, max_threads);
+    if (chunks < 2) {
+        tidy::stable_sort(first, last, comp);
+        return;
+    }
+
+    std::vector<RandomIt> bounds = detail::split_chunks(first, last, chunks);
+    detail::run_parallel(chunks, [&](unsigned i) {
+        tidy::stable_sort(bounds[i], bounds[i + 1], comp);
+    });
+
+    // merge adjacent runs until a single one remains
+    while (bounds.size() > 2) {
+        std::size_t runs = bounds.size() - 1;
+        detail::run_parallel(unsigned(runs / 2), [&](unsigned i) {
+            tidy::inplace_merge(bounds[2 * i], bounds[2 * i + 1], bounds[2 * i + 2], comp);
+        });
+
+        std::vector<RandomIt> merged;
+        for (std::size_t i = 0; i < bounds.size(); i += 2)
+            merged.push_back(bounds[i]);
+        if (runs % 2 == 1)
+            merged.push_back(bounds.back());
+        bounds.swap(merged);
+    }
+}
+
+template<class RandomIt>
+void parallel_stable_sort(RandomIt first, RandomIt last)
+{
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    tidy::parallel_stable_sort(first, last, std::less<value_type>());
+}
+
+/*  Same as stable_partition, but partitions chunks of large ranges on separate
+    threads. The chunks are then joined on the calling thread in a single
+    pass. This pays off when pred is expensive. max_threads has the same
+    meaning as in parallel_stable_sort. pred is copied to each thread.
+*/
+template<class RandomIt, class UnaryPredicate>
+RandomIt parallel_stable_partition(RandomIt first, RandomIt last, UnaryPredicate pred,
+                                   unsigned max_threads = 0)
+{
+    unsigned chunks = detail::parallel_chunk_count(last - first, max_threads);
+    if (chunks < 2)
+        return tidy::stable_partition(first, last, pred);
+
+    std::vector<RandomIt> bounds = detail::split_chunks(first, last, chunks);
+    std::vector<RandomIt> mids(chunks);
+    detail::run_parallel(chunks, [&](unsigned i) {
+        mids[i] = tidy::stable_partition(bounds[i], bounds[i + 1], pred);
+    });
+
+    std::ptrdiff_t false_count = 0;
+    for (unsigned i = 0; i < chunks; ++i)
+        false_count += bounds[i + 1] - mids[i];
+
+    detail::scratch_buffer<RandomIt> buf;
+    buf.reserve(false_count);
+
+    // The elements of the first chunk that satisfy pred are already in place.
+    // The other such elements are moved towards the front and the rest are
+    // collected in the scratch buffer.
+    RandomIt out = mids[0];
+    for (unsigned i = 0; i < chunks; ++i) {
+        if (i > 0)
+            out = std::move(bounds[i], mids[i], out);
+        buf.insert(buf.end(), std::make_move_iterator(mids[i]),
+                   std::make_move_iterator(bounds[i + 1]));
+    }
+    std::move(buf.begin(), buf.end(), out);
+    return out;
+}
+
+} // namespace tidy
+
+#endif
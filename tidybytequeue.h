@@ -0,0 +1,243 @@
+/*  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+
+    Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+            http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef TIDY_TIDYBYTEQUEUE_H
+#define TIDY_TIDYBYTEQUEUE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include "tidyvector.h"
+
+namespace tidy {
+
+/*  A FIFO queue of bytes stored in a ring buffer. Bytes are appended at the
+    back with push() and removed from the front with consume(), which takes
+    constant time regardless of the number of remaining bytes. This makes it
+    suitable for incremental parsing of byte streams.
+
+    Consumed bytes are not wiped immediately. They are overwritten when their
+    memory is reused, wiped in a single pass once the queue becomes empty,
+    and wiped together with the rest of the storage when the queue grows or
+    is destroyed.
+
+    The bytes at the front are available contiguously through data() and
+    contiguous_size(). linearize() makes all bytes contiguous.
+*/
+class byte_queue {
+public:
+    typedef std::uint8_t value_type;
+    typedef std::size_t size_type;
+
+    byte_queue() noexcept : head_(0), size_(0), dirty_(0) {}
+
+    explicit byte_queue(size_type capacity) :
+        byte_queue()
+    {
+        reserve(capacity);
+    }
+
+    byte_queue(const byte_queue& other) :
+        byte_queue()
+    {
+        reserve(other.size_);
+        other.copy_to(buf_.data(), 0, other.size_);
+        size_ = other.size_;
+    }
+
+    byte_queue& operator=(const byte_queue& other)
+    {
+        if (this != &other) {
+            byte_queue copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    byte_queue(byte_queue&& other) noexcept :
+        buf_(std::move(other.buf_)), head_(other.head_), size_(other.size_),
+        dirty_(other.dirty_)
+    {
+        other.head_ = other.size_ = other.dirty_ = 0;
+    }
+
+    byte_queue& operator=(byte_queue&& other) noexcept
+    {
+        if (this != &other) {
+            byte_queue temp(std::move(other));
+            swap(temp);
+        }
+        return *this;
+    }
+
+    void swap(byte_queue& other) noexcept
+    {
+        buf_.swap(other.buf_);
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+        std::swap(dirty_, other.dirty_);
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type capacity() const noexcept { return buf_.size(); }
+
+    void reserve(size_type new_cap)
+    {
+        if (new_cap > capacity())
+            reallocate(new_cap);
+    }
+
+    // Removes and wipes all bytes
+    void clear() noexcept
+    {
+        wipe_ring(head_ + capacity() - dirty_, dirty_ + size_);
+        head_ = size_ = dirty_ = 0;
+    }
+
+    // Appends count bytes to the back of the queue
+    void push(const void* data, size_type count)
+    {
+        if (count > capacity() - size_)
+            reallocate(std::max(capacity() * 2, size_ + count));
+
+        if (count == 0)
+            return;
+        // the consumed bytes that were not wiped are overwritten last
+        std::size_t clean = capacity() - size_ - dirty_;
+        if (count > clean)
+            dirty_ -= count - clean;
+
+        const std::uint8_t* src = static_cast<const std::uint8_t*>(data);
+        std::size_t tail = wrap(head_ + size_);
+        std::size_t first = std::min(count, capacity() - tail);
+        std::memcpy(buf_.data() + tail, src, first);
+        std::memcpy(buf_.data(), src + first, count - first);
+        size_ += count;
+    }
+
+    void push(value_type byte)
+    {
+        push(&byte, 1);
+    }
+
+    /*  Removes count bytes from the front of the queue. std::out_of_range is
+        thrown if count > size().
+    */
+    void consume(size_type count)
+    {
+        if (count > size_)
+            throw std::out_of_range("count > size()");
+        head_ = wrap(head_ + count);
+        size_ -= count;
+        dirty_ += count;
+        if (size_ == 0) {
+            // wipe all consumed bytes at once and start again from the
+            // beginning of the storage, which keeps the data contiguous
+            wipe_ring(head_ + capacity() - dirty_, dirty_);
+            head_ = dirty_ = 0;
+        }
+    }
+
+    // Copies count bytes starting at the front and removes them
+    void pop(void* dest, size_type count)
+    {
+        if (count > size_)
+            throw std::out_of_range("count > size()");
+        copy_to(dest, 0, count);
+        consume(count);
+    }
+
+    value_type operator[](size_type pos) const { return buf_[wrap(head_ + pos)]; }
+
+    value_type front() const { return buf_[head_]; }
+    value_type back() const { return buf_[wrap(head_ + size_ - 1)]; }
+
+    // Returns the pointer to the first byte. The first contiguous_size() bytes
+    // are stored contiguously.
+    const value_type* data() const noexcept { return buf_.data() + head_; }
+
+    size_type contiguous_size() const noexcept
+    {
+        return std::min(size_, capacity() - head_);
+    }
+
+    // Makes all bytes contiguous and returns the pointer to the first one
+    const value_type* linearize()
+    {
+        if (contiguous_size() < size_) {
+            // The consumed bytes are located before the head, thus they end up
+            // at the end of the storage and continue to precede the head.
+            std::rotate(buf_.begin(), buf_.begin() + head_, buf_.end());
+            head_ = 0;
+        }
+        return data();
+    }
+
+    // Copies count bytes starting at pos to dest
+    void copy_to(void* dest, size_type pos, size_type count) const
+    {
+        if (pos > size_ || count > size_ - pos)
+            throw std::out_of_range("pos + count > size()");
+        if (count == 0)
+            return;
+        std::uint8_t* out = static_cast<std::uint8_t*>(dest);
+        std::size_t start = wrap(head_ + pos);
+        std::size_t first = std::min(count, capacity() - start);
+        std::memcpy(out, buf_.data() + start, first);
+        std::memcpy(out + first, buf_.data(), count - first);
+    }
+
+private:
+    std::size_t wrap(std::size_t pos) const noexcept
+    {
+        return pos >= capacity() ? pos - capacity() : pos;
+    }
+
+    // Wipes count bytes of the ring starting at the given position, which
+    // may exceed the capacity once
+    void wipe_ring(std::size_t pos, std::size_t count) noexcept
+    {
+        if (count == 0)
+            return;
+        pos = wrap(pos);
+        std::size_t first = std::min(count, capacity() - pos);
+        detail::secure_delete_range(buf_.data() + pos, buf_.data() + pos + first);
+        detail::secure_delete_range(buf_.data(), buf_.data() + (count - first));
+    }
+
+    // Moves the bytes to new storage of the given capacity. The old storage is
+    // wiped, including the consumed bytes.
+    void reallocate(std::size_t new_cap)
+    {
+        vector<value_type> new_buf(new_cap);
+        copy_to(new_buf.data(), 0, size_);
+        buf_.swap(new_buf);
+        head_ = 0;
+        dirty_ = 0;
+    }
+
+    // the storage; bytes that are not in the queue are zero unless they have
+    // been consumed and not wiped yet. Those dirty_ bytes directly precede
+    // head_.
+    vector<value_type> buf_;
+    std::size_t head_;
+    std::size_t size_;
+    std::size_t dirty_;
+};
+
+inline void swap(byte_queue& lhs, byte_queue& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace tidy
+
+#endif
@@ -0,0 +1,450 @@
+/*  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+
+    Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+            http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef TIDY_TIDYCHAINEDBUFFER_H
+#define TIDY_TIDYCHAINEDBUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "tidyvector.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <limits.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#define TIDY_HAS_IOVEC 1
+#endif
+
+namespace tidy {
+namespace detail {
+
+static const std::size_t chained_buffer_segment_size = 4096;
+
+#if TIDY_HAS_IOVEC
+#ifdef IOV_MAX
+static const int chained_buffer_iov_batch = IOV_MAX < 64 ? IOV_MAX : 64;
+#else
+static const int chained_buffer_iov_batch = 16;
+#endif
+#endif
+
+/*  Storage of a chained_buffer segment. bytes has the full capacity of the
+    block and is wiped when the last segment referring to the block is
+    destroyed. Bytes past used have not been written yet.
+*/
+struct chain_block {
+    explicit chain_block(std::size_t capacity) : bytes(capacity), used(0) {}
+
+    vector<std::uint8_t> bytes;
+    std::size_t used;
+};
+
+} // namespace detail
+
+/*  A sequence of bytes stored as a chain of reference-counted segments.
+    Appending, prepending and splitting other buffers never copies the bytes:
+    the segments are shared instead. The memory of a segment is wiped when no
+    buffer refers to it anymore, and bytes removed from the ends of segments
+    that are not shared are wiped immediately.
+
+    Copies of a buffer share the segments with the original. The contents of
+    the segments are never modified once written, thus the copies are
+    independent. Buffers that share segments must not be used from different
+    threads at the same time: whether a segment is shared is decided by
+    shared_ptr::use_count(), which does not synchronize with other threads.
+
+    coalesce() makes the contents contiguous by copying them into a single
+    segment. fill_iovec(), write_to() and read_from() pass the segments to
+    writev and readv directly.
+*/
+class chained_buffer {
+public:
+    typedef std::uint8_t value_type;
+    typedef std::size_t size_type;
+
+    // Creates an empty buffer that allocates segments of at least the given
+    // size. The default is 4 KiB.
+    explicit chained_buffer(std::size_t segment_size =
+                                detail::chained_buffer_segment_size) :
+        size_(0), segment_size_(std::max<std::size_t>(segment_size, 1))
+    {}
+
+    chained_buffer(const void* data, std::size_t count) :
+        chained_buffer()
+    {
+        append(data, count);
+    }
+
+    chained_buffer(const chained_buffer&) = default;
+    chained_buffer& operator=(const chained_buffer&) = default;
+
+    chained_buffer(chained_buffer&& other) noexcept :
+        size_(0), segment_size_(other.segment_size_)
+    {
+        swap(other);
+    }
+
+    chained_buffer& operator=(chained_buffer&& other) noexcept
+    {
+        if (this != &other) {
+            clear();
+            chain_.swap(other.chain_);
+            size_ = other.size_;
+            segment_size_ = other.segment_size_;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    void swap(chained_buffer& other) noexcept
+    {
+        chain_.swap(other.chain_);
+        std::swap(size_, other.size_);
+        std::swap(segment_size_, other.segment_size_);
+    }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type segment_count() const noexcept { return chain_.size(); }
+
+    // Segments that aren't shared are wiped when their block is destroyed
+    void clear() noexcept
+    {
+        chain_.clear();
+        size_ = 0;
+    }
+
+    // Copies the given bytes to the end of the buffer. The unused capacity of
+    // the last segment is filled first if the segment is not shared.
+    void append(const void* data, std::size_t count)
+    {
+        const std::uint8_t* src = static_cast<const std::uint8_t*>(data);
+        if (!chain_.empty()) {
+            std::size_t copied = std::min(count, writable_tail());
+            if (copied > 0) {
+                segment& tail = chain_.back();
+                std::memcpy(tail.data() + tail.length, src, copied);
+                commit_tail(copied);
+                src += copied;
+                count -= copied;
+            }
+        }
+        if (count > 0) {
+            segment seg = new_segment(count);
+            std::memcpy(seg.data(), src, count);
+            seg.length = count;
+            seg.block->used = count;
+            chain_.push_back(std::move(seg));
+            size_ += count;
+        }
+    }
+
+    // Appends the segments of other without copying the bytes
+    void append(const chained_buffer& other)
+    {
+        chained_buffer copy(other);
+        append(std::move(copy));
+    }
+
+    void append(chained_buffer&& other)
+    {
+        if (&other == this) {
+            chained_buffer copy(other);
+            append(std::move(copy));
+            return;
+        }
+        for (auto& seg : other.chain_)
+            chain_.push_back(std::move(seg));
+        size_ += other.size_;
+        other.chain_.clear();
+        other.size_ = 0;
+    }
+
+    // Copies the given bytes to a new segment at the front of the buffer
+    void prepend(const void* data, std::size_t count)
+    {
+        if (count == 0)
+            return;
+        segment seg = new_segment(count);
+        std::memcpy(seg.data(), data, count);
+        seg.length = count;
+        seg.block->used = count;
+        chain_.push_front(std::move(seg));
+        size_ += count;
+    }
+
+    // Prepends the segments of other without copying the bytes
+    void prepend(const chained_buffer& other)
+    {
+        chained_buffer copy(other);
+        prepend(std::move(copy));
+    }
+
+    void prepend(chained_buffer&& other)
+    {
+        if (&other == this) {
+            chained_buffer copy(other);
+            prepend(std::move(copy));
+            return;
+        }
+        for (auto it = other.chain_.rbegin(); it != other.chain_.rend(); ++it)
+            chain_.push_front(std::move(*it));
+        size_ += other.size_;
+        other.chain_.clear();
+        other.size_ = 0;
+    }
+
+    /*  Removes the first count bytes and returns them as a separate buffer.
+        The segment that contains the split point is shared by both buffers.
+        std::out_of_range is thrown if count > size().
+    */
+    chained_buffer split(std::size_t count)
+    {
+        if (count > size_)
+            throw std::out_of_range("count > size()");
+        chained_buffer head(segment_size_);
+        while (count > 0) {
+            segment& front = chain_.front();
+            if (front.length <= count) {
+                count -= front.length;
+                head.size_ += front.length;
+                size_ -= front.length;
+                head.chain_.push_back(std::move(front));
+                chain_.pop_front();
+            } else {
+                segment part = front;
+                part.length = count;
+                front.offset += count;
+                front.length -= count;
+                head.chain_.push_back(std::move(part));
+                head.size_ += count;
+                size_ -= count;
+                count = 0;
+            }
+        }
+        return head;
+    }
+
+    // Removes the first count bytes. std::out_of_range is thrown if
+    // count > size().
+    void trim_front(std::size_t count)
+    {
+        if (count > size_)
+            throw std::out_of_range("count > size()");
+        size_ -= count;
+        while (count > 0) {
+            segment& front = chain_.front();
+            if (front.length <= count) {
+                count -= front.length;
+                chain_.pop_front();
+            } else {
+                if (front.block.use_count() == 1)
+                    detail::secure_delete_range(front.data(), front.data() + count);
+                front.offset += count;
+                front.length -= count;
+                count = 0;
+            }
+        }
+    }
+
+    // Removes the last count bytes. std::out_of_range is thrown if
+    // count > size().
+    void trim_back(std::size_t count)
+    {
+        if (count > size_)
+            throw std::out_of_range("count > size()");
+        size_ -= count;
+        while (count > 0) {
+            segment& back = chain_.back();
+            if (back.length <= count) {
+                count -= back.length;
+                chain_.pop_back();
+            } else {
+                back.length -= count;
+                if (back.block.use_count() == 1) {
+                    std::uint8_t* end = back.data() + back.length;
+                    detail::secure_delete_range(end, end + count);
+                    if (back.offset + back.length + count == back.block->used)
+                        back.block->used -= count;
+                }
+                count = 0;
+            }
+        }
+    }
+
+    /*  Copies the contents into a single segment if they span more than one
+        and returns a pointer to them. The old segments are released and
+        wiped unless they are shared with other buffers.
+    */
+    const value_type* coalesce()
+    {
+        if (chain_.size() > 1) {
+            segment seg = new_segment(size_);
+            copy_to(seg.data());
+            seg.length = size_;
+            seg.block->used = size_;
+            std::size_t size = size_;
+            clear();
+            chain_.push_back(std::move(seg));
+            size_ = size;
+        }
+        return chain_.empty() ? nullptr : chain_.front().data();
+    }
+
+    // Copies the contents to dest, which must have room for size() bytes
+    void copy_to(void* dest) const
+    {
+        std::uint8_t* out = static_cast<std::uint8_t*>(dest);
+        for (const auto& seg : chain_) {
+            std::memcpy(out, seg.data(), seg.length);
+            out += seg.length;
+        }
+    }
+
+    vector<value_type> to_vector() const
+    {
+        vector<value_type> result(size_);
+        copy_to(result.data());
+        return result;
+    }
+
+    // Calls f(const value_type* data, size_type size) for each segment
+    template<class F>
+    void for_each_segment(F f) const
+    {
+        for (const auto& seg : chain_)
+            f(static_cast<const value_type*>(seg.data()), seg.length);
+    }
+
+#if TIDY_HAS_IOVEC
+    /*  Fills up to count iovec structures with the segments of the buffer.
+        Returns the number of structures filled.
+    */
+    std::size_t fill_iovec(iovec* iov, std::size_t count) const
+    {
+        std::size_t filled = std::min(count, chain_.size());
+        for (std::size_t i = 0; i < filled; ++i) {
+            iov[i].iov_base = chain_[i].data();
+            iov[i].iov_len = chain_[i].length;
+        }
+        return filled;
+    }
+
+    /*  Writes the contents to the given file descriptor with a single writev
+        call and removes the bytes that have been written. The return value
+        and errno are the same as those of writev.
+    */
+    ssize_t write_to(int fd)
+    {
+        iovec iov[detail::chained_buffer_iov_batch];
+        int count = int(fill_iovec(iov, detail::chained_buffer_iov_batch));
+        ssize_t written = ::writev(fd, iov, count);
+        if (written > 0)
+            trim_front(std::size_t(written));
+        return written;
+    }
+
+    /*  Reads up to max_count bytes from the given file descriptor with a
+        single readv call and appends them. The unused capacity of the last
+        segment is filled first and a new segment is allocated for the rest.
+        The return value and errno are the same as those of readv.
+    */
+    ssize_t read_from(int fd, std::size_t max_count)
+    {
+        iovec iov[2];
+        int count = 0;
+        std::size_t tail_room = chain_.empty() ? 0 : std::min(writable_tail(), max_count);
+        if (tail_room > 0) {
+            segment& tail = chain_.back();
+            iov[count].iov_base = tail.data() + tail.length;
+            iov[count].iov_len = tail_room;
+            ++count;
+        }
+        segment extra;
+        if (max_count > tail_room) {
+            extra = new_segment(max_count - tail_room);
+            iov[count].iov_base = extra.data();
+            iov[count].iov_len = max_count - tail_room;
+            ++count;
+        }
+
+        ssize_t result = ::readv(fd, iov, count);
+        if (result <= 0)
+            return result;
+
+        std::size_t received = std::size_t(result);
+        std::size_t in_tail = std::min(received, tail_room);
+        if (in_tail > 0)
+            commit_tail(in_tail);
+        if (received > in_tail) {
+            extra.length = received - in_tail;
+            extra.block->used = extra.length;
+            chain_.push_back(std::move(extra));
+            size_ += received - in_tail;
+        }
+        return result;
+    }
+#endif
+
+private:
+    struct segment {
+        std::shared_ptr<detail::chain_block> block;
+        std::size_t offset = 0;
+        std::size_t length = 0;
+
+        std::uint8_t* data() const { return block->bytes.data() + offset; }
+    };
+
+    segment new_segment(std::size_t min_capacity)
+    {
+        segment seg;
+        seg.block = std::make_shared<detail::chain_block>(
+                    std::max(min_capacity, segment_size_));
+        return seg;
+    }
+
+    // Returns the number of bytes that can be written in place after the
+    // last segment. Shared blocks are never written to.
+    std::size_t writable_tail() const
+    {
+        const segment& tail = chain_.back();
+        if (tail.block.use_count() != 1 ||
+            tail.offset + tail.length != tail.block->used)
+        {
+            return 0;
+        }
+        return tail.block->bytes.size() - tail.block->used;
+    }
+
+    void commit_tail(std::size_t count)
+    {
+        segment& tail = chain_.back();
+        tail.length += count;
+        tail.block->used += count;
+        size_ += count;
+    }
+
+    std::deque<segment> chain_;
+    std::size_t size_;
+    std::size_t segment_size_;
+};
+
+inline void swap(chained_buffer& lhs, chained_buffer& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace tidy
+
+#endif
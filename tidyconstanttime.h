@@ -0,0 +1,253 @@
+/*  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+
+    Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+            http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef TIDY_TIDYCONSTANTTIME_H
+#define TIDY_TIDYCONSTANTTIME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include "tidystring.h"
+#include "tidyvector.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TIDY_CONSTANT_TIME_SSE2 1
+#endif
+
+/*  Comparisons whose running time depends only on the sizes of the compared
+    data and not on its contents, for verifying MACs, tokens and passwords.
+    The standard comparisons return as soon as they find a difference and
+    thus reveal where the first difference is.
+
+    The sizes themselves are not secret: containers of different sizes are
+    reported as different right away.
+*/
+
+namespace tidy {
+namespace detail {
+
+inline std::uint64_t ct_load64(const unsigned char* p)
+{
+    std::uint64_t r;
+    std::memcpy(&r, p, 8);
+    return r;
+}
+
+// Loads 8 bytes so that comparing the results as integers compares the bytes
+// lexicographically
+inline std::uint64_t ct_load64_be(const unsigned char* p)
+{
+    std::uint64_t r = ct_load64(p);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return r;
+#elif defined(__GNUC__)
+    return __builtin_bswap64(r);
+#else
+    r = ((r & 0x00ff00ff00ff00ffull) << 8) | ((r >> 8) & 0x00ff00ff00ff00ffull);
+    r = ((r & 0x0000ffff0000ffffull) << 16) | ((r >> 16) & 0x0000ffff0000ffffull);
+    return (r << 32) | (r >> 32);
+#endif
+}
+
+// Returns the OR of the XOR of all byte pairs, i.e. zero if the bytes are equal
+inline std::uint64_t ct_diff_bytes(const unsigned char* a, const unsigned char* b,
+                                   std::size_t size) noexcept
+{
+    std::size_t i = 0;
+    std::uint64_t diff = 0;
+#if TIDY_CONSTANT_TIME_SSE2
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    for (; i + 32 <= size; i += 32) {
+        __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 16));
+        __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 16));
+        acc0 = _mm_or_si128(acc0, _mm_xor_si128(a0, b0));
+        acc1 = _mm_or_si128(acc1, _mm_xor_si128(a1, b1));
+    }
+    std::uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), _mm_or_si128(acc0, acc1));
+    diff = lanes[0] | lanes[1];
+#endif
+    for (; i + 8 <= size; i += 8)
+        diff |= ct_load64(a + i) ^ ct_load64(b + i);
+    for (; i < size; ++i)
+        diff |= std::uint64_t(a[i] ^ b[i]);
+    return diff;
+}
+
+/*  Lexicographic comparison state. result holds the sign of the first pair
+    of elements that differ and decided becomes all ones once such a pair is
+    seen. Both are updated with bitwise operations only.
+*/
+struct ct_compare_state {
+    int result;
+    int decided;
+
+    ct_compare_state() : result(0), decided(0) {}
+
+    template<class T>
+    void step(T a, T b)
+    {
+        int sign = int(b < a) - int(a < b);
+        result |= sign & ~decided;
+        decided |= -int(a != b);
+    }
+};
+
+/*  Compares the bytes lexicographically as unsigned values. flip is XORed
+    into each byte first, thus 0x80 compares them as signed values instead.
+*/
+inline int ct_compare_bytes(const unsigned char* a, const unsigned char* b,
+                            std::size_t size, unsigned char flip = 0) noexcept
+{
+    ct_compare_state state;
+    std::size_t i = 0;
+#if TIDY_CONSTANT_TIME_SSE2
+    // The byte masks are compared as integers. The lowest set bit of the
+    // mask of differing bytes selects the first difference, and it is set
+    // in exactly one of the greater and less masks.
+    const __m128i bias = _mm_set1_epi8(char(0x80 ^ flip));
+    for (; i + 16 <= size; i += 16) {
+        __m128i va = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                   bias);
+        __m128i vb = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)),
+                                   bias);
+        unsigned gt = unsigned(_mm_movemask_epi8(_mm_cmpgt_epi8(va, vb)));
+        unsigned lt = unsigned(_mm_movemask_epi8(_mm_cmpgt_epi8(vb, va)));
+        unsigned first = (gt | lt) & (0u - (gt | lt));
+        state.step(gt & first, lt & first);
+    }
+#endif
+    const std::uint64_t flip64 = flip * 0x0101010101010101ull;
+    for (; i + 8 <= size; i += 8)
+        state.step(ct_load64_be(a + i) ^ flip64, ct_load64_be(b + i) ^ flip64);
+    for (; i < size; ++i)
+        state.step(a[i] ^ flip, b[i] ^ flip);
+    return state.result;
+}
+
+// Compares elements by value. Single-byte elements are compared as bytes,
+// several at a time, with the sign bit flipped by flip.
+template<class T>
+int ct_compare_elements(const T* a, const T* b, std::size_t count, unsigned char flip,
+                        std::true_type /*as_bytes*/) noexcept
+{
+    return ct_compare_bytes(reinterpret_cast<const unsigned char*>(a),
+                            reinterpret_cast<const unsigned char*>(b), count, flip);
+}
+
+template<class T>
+int ct_compare_elements(const T* a, const T* b, std::size_t count, unsigned char /*flip*/,
+                        std::false_type /*as_bytes*/) noexcept
+{
+    ct_compare_state state;
+    for (std::size_t i = 0; i < count; ++i)
+        state.step(a[i], b[i]);
+    return state.result;
+}
+
+template<class T>
+struct ct_compare_as_bytes : std::integral_constant<
+        bool, sizeof(T) == 1 && std::is_integral<T>::value
+    >
+{};
+
+// The flip that makes the bytes of T compare like its values
+template<class T>
+struct ct_sign_flip : std::integral_constant<
+        unsigned char, std::is_signed<T>::value ? 0x80 : 0
+    >
+{};
+
+/*  Compares the common prefix and then the sizes. Single-byte elements are
+    compared as bytes XORed with flip, i.e. ct_sign_flip<T>::value compares
+    them by value and 0 compares them as unsigned char.
+*/
+template<class T>
+int ct_compare_ranges(const T* a, std::size_t size_a, const T* b, std::size_t size_b,
+                      unsigned char flip) noexcept
+{
+    std::size_t common = size_a < size_b ? size_a : size_b;
+    ct_compare_state state;
+    if (common > 0)
+        state.result = ct_compare_elements(a, b, common, flip, ct_compare_as_bytes<T>());
+    state.decided = -int(state.result != 0);
+    state.step(size_a, size_b);
+    return state.result;
+}
+
+} // namespace detail
+
+/*  Returns whether the size bytes at a and b are equal. All bytes are always
+    read.
+*/
+inline bool constant_time_equal(const void* a, const void* b, std::size_t size) noexcept
+{
+    return detail::ct_diff_bytes(static_cast<const unsigned char*>(a),
+                                 static_cast<const unsigned char*>(b), size) == 0;
+}
+
+/*  Compares the size bytes at a and b lexicographically as unsigned bytes,
+    like std::memcmp. Returns -1, 0 or 1. All bytes are always read.
+*/
+inline int constant_time_compare(const void* a, const void* b, std::size_t size) noexcept
+{
+    return detail::ct_compare_bytes(static_cast<const unsigned char*>(a),
+                                    static_cast<const unsigned char*>(b), size);
+}
+
+template<class T, class Alloc>
+bool constant_time_equal(const vector<T, Alloc>& a, const vector<T, Alloc>& b) noexcept
+{
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                  "constant_time_equal requires integral or enum elements");
+    if (a.size() != b.size())
+        return false;
+    return constant_time_equal(a.data(), b.data(), a.size() * sizeof(T));
+}
+
+/*  Compares the elements lexicographically by value and then the sizes, like
+    operator<. Returns -1, 0 or 1.
+*/
+template<class T, class Alloc>
+int constant_time_compare(const vector<T, Alloc>& a, const vector<T, Alloc>& b) noexcept
+{
+    static_assert(std::is_integral<T>::value,
+                  "constant_time_compare requires integral elements");
+    return detail::ct_compare_ranges(a.data(), a.size(), b.data(), b.size(),
+                                     detail::ct_sign_flip<T>::value);
+}
+
+template<class CharT, class Alloc>
+bool constant_time_equal(const basic_string<CharT, std::char_traits<CharT>, Alloc>& a,
+                         const basic_string<CharT, std::char_traits<CharT>, Alloc>& b) noexcept
+{
+    if (a.size() != b.size())
+        return false;
+    return constant_time_equal(a.data(), b.data(), a.size() * sizeof(CharT));
+}
+
+/*  Compares the strings like basic_string::compare, but returns -1, 0 or 1.
+    Only std::char_traits is supported, as custom traits may compare in ways
+    that can't be done without branching. std::char_traits<char> compares the
+    characters as unsigned char, even where char is signed.
+*/
+template<class CharT, class Alloc>
+int constant_time_compare(const basic_string<CharT, std::char_traits<CharT>, Alloc>& a,
+                          const basic_string<CharT, std::char_traits<CharT>, Alloc>& b) noexcept
+{
+    return detail::ct_compare_ranges(a.data(), a.size(), b.data(), b.size(), 0);
+}
+
+} // namespace tidy
+
+#endif
@@ -0,0 +1,486 @@
+/*  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+
+    Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+            http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef TIDY_TIDYFILELOADER_H
+#define TIDY_TIDYFILELOADER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "tidyfstream.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+// IO_URING_OP_SUPPORTED comes with the probe interface and the close operation
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && \
+    defined(__NR_io_uring_register) && defined(IO_URING_OP_SUPPORTED)
+#define TIDY_HAS_IO_URING 1
+#endif
+#endif
+#endif
+
+/*  Loading of many files at once. On Linux the reads and closes are
+    submitted in batches through io_uring, which avoids paying the latency of
+    a system call for each of them. When io_uring is not available, e.g. on
+    kernels older than 5.6 or when it is disabled by a seccomp policy, the
+    files are opened and read by a pool of threads instead.
+*/
+
+namespace tidy {
+
+template<class Container>
+struct loaded_file {
+    Container data;
+    // set if the file could not be read, in which case data is empty
+    std::error_code error;
+};
+
+enum class read_files_backend {
+    automatic, // io_uring if available, threads otherwise
+    threads
+};
+
+namespace detail {
+
+/*  Reads files[i] into results[i] for each i on up to max_threads threads.
+    Errors are reported per file; exceptions other than std::system_error,
+    e.g. std::bad_alloc, are rethrown after all threads finish.
+*/
+template<class Container>
+void read_files_threaded(const std::vector<std::string>& paths,
+                         std::vector<loaded_file<Container>>& results,
+                         unsigned max_threads)
+{
+    std::atomic<std::size_t> next(0);
+    std::exception_ptr failure;
+    std::mutex failure_mutex;
+
+    auto work = [&]() {
+        for (;;) {
+            std::size_t i = next.fetch_add(1);
+            if (i >= paths.size())
+                return;
+            try {
+                read_file_into(paths[i].c_str(), results[i].data);
+            } catch (const std::system_error& e) {
+                results[i].data.clear();
+                results[i].error = e.code();
+            } catch (...) {
+                results[i].data.clear();
+                std::lock_guard<std::mutex> lock(failure_mutex);
+                if (!failure)
+                    failure = std::current_exception();
+            }
+        }
+    };
+
+    if (max_threads == 0)
+        max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t count = std::min<std::size_t>(max_threads, paths.size());
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < count; ++i) {
+        try {
+            threads.emplace_back(work);
+        } catch (const std::system_error&) {
+            break; // the remaining threads pick up the work
+        }
+    }
+    work();
+    for (auto& t : threads)
+        t.join();
+
+    if (failure)
+        std::rethrow_exception(failure);
+}
+
+#if TIDY_HAS_IO_URING
+
+/*  A minimal io_uring instance: the submission and completion rings and the
+    submission queue entries mapped into memory. ok() is false if io_uring is
+    not available.
+*/
+class io_uring_instance {
+public:
+    explicit io_uring_instance(unsigned entries) :
+        fd_(-1), sq_ptr_(MAP_FAILED), cq_ptr_(MAP_FAILED), sqes_(MAP_FAILED),
+        sq_size_(0), cq_size_(0), sqes_size_(0)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd_ = int(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0)
+            return;
+
+        sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = false;
+#ifdef IORING_FEAT_SINGLE_MMAP
+        single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+#endif
+        if (single_mmap)
+            sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+
+        sq_ptr_ = ::mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        if (sq_ptr_ == MAP_FAILED)
+            return;
+        if (single_mmap) {
+            cq_ptr_ = sq_ptr_;
+        } else {
+            cq_ptr_ = ::mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+            if (cq_ptr_ == MAP_FAILED)
+                return;
+        }
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+        if (sqes_ == MAP_FAILED)
+            return;
+
+        char* sq = static_cast<char*>(sq_ptr_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        char* cq = static_cast<char*>(cq_ptr_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        entries_ = params.sq_entries;
+        pending_ = 0;
+    }
+
+    io_uring_instance(const io_uring_instance&) = delete;
+    io_uring_instance& operator=(const io_uring_instance&) = delete;
+
+    ~io_uring_instance()
+    {
+        if (sqes_ != MAP_FAILED)
+            ::munmap(sqes_, sqes_size_);
+        if (cq_ptr_ != MAP_FAILED && cq_ptr_ != sq_ptr_)
+            ::munmap(cq_ptr_, cq_size_);
+        if (sq_ptr_ != MAP_FAILED)
+            ::munmap(sq_ptr_, sq_size_);
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+
+    bool ok() const { return sqes_ != MAP_FAILED; }
+
+    // Returns whether the kernel supports all the given operations
+    bool supports(std::initializer_list<unsigned> ops) const
+    {
+        const unsigned max_ops = 256;
+        std::vector<unsigned char> buffer(sizeof(io_uring_probe) +
+                                          max_ops * sizeof(io_uring_probe_op));
+        io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+        if (::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, max_ops) < 0)
+            return false;
+        for (unsigned op : ops) {
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+                return false;
+        }
+        return true;
+    }
+
+    // The number of operations that can be queued before submitting
+    unsigned entries() const { return entries_; }
+
+    // Queues a readv operation. The iovec must stay valid until the
+    // operation completes.
+    void queue_readv(int fd, const iovec* iov, std::uint64_t offset, std::uint64_t user_data)
+    {
+        io_uring_sqe* sqe = next_sqe(IORING_OP_READV, fd, user_data);
+        sqe->addr = reinterpret_cast<std::uintptr_t>(iov);
+        sqe->len = 1;
+        sqe->off = offset;
+        push_sqe();
+    }
+
+    void queue_close(int fd, std::uint64_t user_data)
+    {
+        next_sqe(IORING_OP_CLOSE, fd, user_data);
+        push_sqe();
+    }
+
+    // Submits the queued operations and waits until at least wait_count
+    // operations complete. Returns a negative errno value on failure.
+    int submit(unsigned wait_count)
+    {
+        for (;;) {
+            int r = int(::syscall(__NR_io_uring_enter, fd_, pending_, wait_count,
+                                  wait_count > 0 ? IORING_ENTER_GETEVENTS : 0,
+                                  nullptr, 0));
+            if (r >= 0) {
+                pending_ -= unsigned(r);
+                return 0;
+            }
+            if (errno != EINTR)
+                return -errno;
+        }
+    }
+
+    // Calls f(user_data, result) for each completed operation
+    template<class F>
+    void reap(F f)
+    {
+        unsigned head = *cq_head_;
+        unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+            std::uint64_t user_data = cqe.user_data;
+            int res = cqe.res;
+            ++head;
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+            f(user_data, res);
+        }
+    }
+
+private:
+    io_uring_sqe* next_sqe(unsigned opcode, int fd, std::uint64_t user_data)
+    {
+        unsigned index = *sq_tail_ & sq_mask_;
+        io_uring_sqe* sqe = static_cast<io_uring_sqe*>(sqes_) + index;
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = std::uint8_t(opcode);
+        sqe->fd = fd;
+        sqe->user_data = user_data;
+        return sqe;
+    }
+
+    void push_sqe()
+    {
+        unsigned tail = *sq_tail_;
+        sq_array_[tail & sq_mask_] = tail & sq_mask_;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        ++pending_;
+    }
+
+    int fd_;
+    void* sq_ptr_;
+    void* cq_ptr_;
+    void* sqes_;
+    std::size_t sq_size_, cq_size_, sqes_size_;
+    unsigned* sq_head_;
+    unsigned* sq_tail_;
+    unsigned sq_mask_;
+    unsigned* sq_array_;
+    unsigned* cq_head_;
+    unsigned* cq_tail_;
+    unsigned cq_mask_;
+    io_uring_cqe* cqes_;
+    unsigned entries_;
+    unsigned pending_;
+};
+
+static const unsigned io_uring_queue_depth = 256;
+
+/*  Reads the files through io_uring. Each file is opened and its size
+    queried on the calling thread, then the reads and finally a close are
+    queued. Opening through the ring is slower when the files are cached,
+    since the kernel always hands asynchronous statx to a worker thread. Up
+    to io_uring_queue_depth operations are in flight at a time. Like in
+    read_file_into, one spare byte is read to detect the end of the file and
+    files that turn out to be larger than reported are read in further
+    chunks. Returns false without reading anything if io_uring or any of the
+    operations is not available.
+*/
+template<class Container>
+bool read_files_io_uring(const std::vector<std::string>& paths,
+                         std::vector<loaded_file<Container>>& results)
+{
+    unsigned depth = unsigned(std::min<std::size_t>(paths.size(), io_uring_queue_depth));
+    io_uring_instance ring(depth);
+    if (!ring.ok() || !ring.supports({ IORING_OP_READV, IORING_OP_CLOSE }))
+        return false;
+
+    // The operation is stored in the low bit of the user data
+    enum operation : std::uint64_t { op_read, op_close, op_bits = 1 };
+
+    struct file_state {
+        int fd = -1;
+        bool regular = false;
+        std::size_t filled = 0;
+        iovec iov;
+    };
+    std::vector<file_state> files(paths.size());
+
+    // closes the files that are still open if an exception is thrown
+    struct fd_closer {
+        std::vector<file_state>& files;
+        ~fd_closer()
+        {
+            for (auto& f : files) {
+                if (f.fd >= 0)
+                    ::close(f.fd);
+            }
+        }
+    } closer = { files };
+
+    unsigned in_flight = 0;
+    auto queue = [&](std::size_t i, operation op) {
+        std::uint64_t user_data = (std::uint64_t(i) << op_bits) | op;
+        file_state& f = files[i];
+        if (op == op_read) {
+            Container& data = results[i].data;
+            if (f.filled == data.size())
+                data.resize(std::max(2 * data.size(), f.filled + read_file_chunk));
+            f.iov.iov_base = &data[f.filled];
+            f.iov.iov_len = std::min(data.size() - f.filled, read_file_chunk);
+            ring.queue_readv(f.fd, &f.iov, f.filled, user_data);
+        } else {
+            ring.queue_close(f.fd, user_data);
+            f.fd = -1;
+        }
+        ++in_flight;
+    };
+
+    auto finish = [&](std::size_t i, int error) {
+        if (files[i].fd >= 0)
+            queue(i, op_close);
+        if (error != 0) {
+            results[i].data.clear();
+            results[i].error = std::error_code(error, std::generic_category());
+        } else {
+            results[i].data.resize(files[i].filled);
+        }
+    };
+
+    // Opens the file and queues the first read
+    auto start = [&](std::size_t i) {
+        file_state& f = files[i];
+        f.fd = ::open(paths[i].c_str(), O_RDONLY | O_CLOEXEC);
+        if (f.fd < 0) {
+            finish(i, errno);
+            return;
+        }
+        struct stat st;
+        if (::fstat(f.fd, &st) != 0) {
+            finish(i, errno);
+            return;
+        }
+        f.regular = S_ISREG(st.st_mode);
+        std::size_t expected = f.regular ? std::size_t(st.st_size) : 0;
+        results[i].data.resize(expected + 1);
+        queue(i, op_read);
+    };
+
+    auto complete = [&](std::uint64_t user_data, int res) {
+        std::size_t i = std::size_t(user_data >> op_bits);
+        operation op = operation(user_data & ((1 << op_bits) - 1));
+        file_state& f = files[i];
+        --in_flight;
+        switch (op) {
+        case op_read:
+            if (res == -EINTR || res == -EAGAIN) {
+                queue(i, op_read);
+            } else if (res < 0) {
+                finish(i, -res);
+            } else if (res == 0 || (f.regular && std::size_t(res) < f.iov.iov_len)) {
+                // a short read of a regular file means the end of the file
+                f.filled += std::size_t(res);
+                finish(i, 0);
+            } else {
+                f.filled += std::size_t(res);
+                queue(i, op_read);
+            }
+            break;
+        default:
+            break; // the file has been read already
+        }
+    };
+
+    std::size_t next = 0;
+    try {
+        while (next < paths.size() || in_flight > 0) {
+            while (next < paths.size() && in_flight < ring.entries())
+                start(next++);
+
+            int r = ring.submit(1);
+            if (r < 0)
+                throw std::system_error(-r, std::generic_category(), "tidy::read_files");
+            ring.reap(complete);
+        }
+    } catch (...) {
+        // the kernel may still write to the buffers of the queued operations
+        while (in_flight > 0 && ring.submit(1) == 0) {
+            ring.reap([&](std::uint64_t, int) { --in_flight; });
+        }
+        throw;
+    }
+    return true;
+}
+
+#endif // TIDY_HAS_IO_URING
+
+} // namespace detail
+
+/*  Reads the whole contents of each of the given files. The result for
+    paths[i] is stored in element i of the returned vector. Failures to read
+    individual files are reported through loaded_file::error and leave the
+    data of that file empty and wiped. max_threads limits the number of
+    threads used when io_uring is not available; the default is
+    std::thread::hardware_concurrency().
+
+    Container can be tidy::string or tidy::vector<uint8_t>.
+*/
+template<class Container = string>
+std::vector<loaded_file<Container>>
+    read_files(const std::vector<std::string>& paths,
+               read_files_backend backend = read_files_backend::automatic,
+               unsigned max_threads = 0)
+{
+    std::vector<loaded_file<Container>> results(paths.size());
+    if (paths.empty())
+        return results;
+#if TIDY_HAS_IO_URING
+    if (backend == read_files_backend::automatic &&
+        detail::read_files_io_uring(paths, results))
+    {
+        return results;
+    }
+#else
+    (void) backend;
+#endif
+    detail::read_files_threaded(paths, results, max_threads);
+    return results;
+}
+
+// Same as read_files, but runs on a separate thread
+template<class Container = string>
+std::future<std::vector<loaded_file<Container>>>
+    read_files_async(std::vector<std::string> paths,
+                     read_files_backend backend = read_files_backend::automatic,
+                     unsigned max_threads = 0)
+{
+    return std::async(std::launch::async,
+                      [backend, max_threads](const std::vector<std::string>& p) {
+        return read_files<Container>(p, backend, max_threads);
+    }, std::move(paths));
+}
+
+} // namespace tidy
+
+#endif
@@ -0,0 +1,836 @@
+/*  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+
+    Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+            http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef TIDY_TIDYFSTREAM_H
+#define TIDY_TIDYFSTREAM_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ios>
+#include <istream>
+#include <new>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <system_error>
+#include <utility>
+#include "tidystring.h"
+#include "tidyvector.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TIDY_HAS_POSIX 1
+#endif
+
+namespace tidy {
+namespace detail {
+
+/*  A fixed-size buffer that is locked into physical memory where the platform
+    supports it, so that its contents are never written to swap. The memory
+    is wiped before it is unlocked and released. Failures to lock the memory,
+    e.g. due to RLIMIT_MEMLOCK, are ignored.
+*/
+template<class T>
+class locked_buffer {
+public:
+    locked_buffer() noexcept : data_(nullptr), size_(0) {}
+
+    explicit locked_buffer(std::size_t size) :
+        data_(static_cast<T*>(::operator new(size * sizeof(T)))), size_(size)
+    {
+#if TIDY_HAS_POSIX
+        ::mlock(data_, size_ * sizeof(T));
+#endif
+    }
+
+    locked_buffer(const locked_buffer&) = delete;
+    locked_buffer& operator=(const locked_buffer&) = delete;
+
+    locked_buffer(locked_buffer&& other) noexcept :
+        data_(other.data_), size_(other.size_)
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    locked_buffer& operator=(locked_buffer&& other) noexcept
+    {
+        if (this != &other) {
+            release();
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+        }
+        return *this;
+    }
+
+    ~locked_buffer() noexcept
+    {
+        release();
+    }
+
+    T* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+
+    void wipe() noexcept
+    {
+        if (data_ != nullptr)
+            secure_delete(data_, size_ * sizeof(T));
+    }
+
+    void release() noexcept
+    {
+        if (data_ == nullptr)
+            return;
+        wipe();
+#if TIDY_HAS_POSIX
+        ::munlock(data_, size_ * sizeof(T));
+#endif
+        ::operator delete(data_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+private:
+    T* data_;
+    std::size_t size_;
+};
+
+// Returns the fopen mode string for the given openmode or nullptr if the
+// combination is not valid. Files are always opened in binary mode.
+inline const char* fopen_mode(std::ios_base::openmode mode)
+{
+    using std::ios_base;
+    ios_base::openmode m = mode & ~(ios_base::ate | ios_base::binary);
+    if (m == ios_base::out || m == (ios_base::out | ios_base::trunc))
+        return "wb";
+    if (m == ios_base::app || m == (ios_base::out | ios_base::app))
+        return "ab";
+    if (m == ios_base::in)
+        return "rb";
+    if (m == (ios_base::in | ios_base::out))
+        return "r+b";
+    if (m == (ios_base::in | ios_base::out | ios_base::trunc))
+        return "w+b";
+    if (m == (ios_base::in | ios_base::app) ||
+        m == (ios_base::in | ios_base::out | ios_base::app))
+        return "a+b";
+    return nullptr;
+}
+
+static const std::size_t read_file_chunk = 1 << 20;
+
+[[noreturn]] inline void throw_file_error(int error, const char* path)
+{
+    throw std::system_error(error, std::generic_category(),
+                            std::string("tidy::read_file: ") + path);
+}
+
+/*  Reads the whole file into the given empty container of bytes. The
+    container is sized once from the size reported by the file system; one
+    extra byte is allocated so that the end of the file is detected without
+    reallocating. Files that grow during the read or report no size, such as
+    pipes, are handled by growing the container geometrically. The container
+    wipes its old storage on reallocation.
+*/
+template<class Container>
+void read_file_into(const char* path, Container& out)
+{
+#if TIDY_HAS_POSIX
+    int flags = O_RDONLY;
+#ifdef O_CLOEXEC
+    flags |= O_CLOEXEC;
+#endif
+    int fd;
+    do {
+        fd = ::open(path, flags);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0)
+        throw_file_error(errno, path);
+
+    struct closer {
+        int fd;
+        ~closer() { ::close(fd); }
+    } guard = { fd };
+
+    struct stat st;
+    std::size_t expected = 0;
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+        expected = std::size_t(st.st_size);
+#else
+    std::FILE* file = std::fopen(path, "rb");
+    if (file == nullptr)
+        throw_file_error(errno, path);
+    std::setvbuf(file, nullptr, _IONBF, 0);
+
+    struct closer {
+        std::FILE* file;
+        ~closer() { std::fclose(file); }
+    } guard = { file };
+
+    std::size_t expected = 0;
+#endif
+
+    out.resize(expected + 1);
+    std::size_t filled = 0;
+    for (;;) {
+        if (filled == out.size())
+            out.resize(std::max(2 * out.size(), filled + read_file_chunk));
+        std::size_t want = std::min(out.size() - filled, read_file_chunk);
+        void* dest = &out[filled];
+#if TIDY_HAS_POSIX
+        ssize_t count = ::read(fd, dest, want);
+        if (count < 0) {
+            if (errno == EINTR)
+                continue;
+            int error = errno;
+            out.clear();
+            throw_file_error(error, path);
+        }
+#else
+        std::size_t count = std::fread(dest, 1, want, file);
+        if (count == 0 && std::ferror(file)) {
+            out.clear();
+            throw_file_error(EIO, path);
+        }
+#endif
+        if (count == 0)
+            break;
+        filled += std::size_t(count);
+    }
+    out.resize(filled);
+}
+
+} // namespace detail
+
+/*  A file stream buffer that does not leave the contents of the file in
+    memory. It has the interface of std::basic_filebuf, but the internal
+    buffer is locked into physical memory where supported and is wiped when
+    the file is closed. The C library buffering is disabled, thus there are
+    no other copies of the data.
+
+    Reads and writes of at least the size of the buffer bypass the buffer and
+    transfer the data directly between the file and the memory of the caller.
+    The default buffer size is 64 KiB.
+
+    The characters are transferred as raw bytes without any codecvt
+    conversion and files are always opened in binary mode.
+*/
+template<class CharT, class Traits = std::char_traits<CharT>>
+class basic_filebuf : public std::basic_streambuf<CharT, Traits> {
+    using base_type = std::basic_streambuf<CharT, Traits>;
+public:
+    typedef CharT char_type;
+    typedef Traits traits_type;
+    typedef typename Traits::int_type int_type;
+    typedef typename Traits::pos_type pos_type;
+    typedef typename Traits::off_type off_type;
+
+    static const std::size_t default_buffer_bytes = 64 * 1024;
+
+    explicit basic_filebuf(std::size_t buffer_size =
+                               default_buffer_bytes / sizeof(CharT)) :
+        file_(nullptr), mode_(), buffer_size_(std::max<std::size_t>(buffer_size, 1)),
+        state_(state::idle)
+    {}
+
+    basic_filebuf(const basic_filebuf&) = delete;
+
+    basic_filebuf(basic_filebuf&& other) :
+        base_type(other),
+        file_(other.file_), mode_(other.mode_), buffer_size_(other.buffer_size_),
+        buffer_(std::move(other.buffer_)), state_(other.state_)
+    {
+        other.file_ = nullptr;
+        other.state_ = state::idle;
+        other.setg(nullptr, nullptr, nullptr);
+        other.setp(nullptr, nullptr);
+    }
+
+    basic_filebuf& operator=(const basic_filebuf&) = delete;
+
+    basic_filebuf& operator=(basic_filebuf&& other)
+    {
+        if (this != &other) {
+            close();
+            base_type::operator=(other);
+            file_ = other.file_;
+            mode_ = other.mode_;
+            buffer_size_ = other.buffer_size_;
+            buffer_ = std::move(other.buffer_);
+            state_ = other.state_;
+            other.file_ = nullptr;
+            other.state_ = state::idle;
+            other.setg(nullptr, nullptr, nullptr);
+            other.setp(nullptr, nullptr);
+        }
+        return *this;
+    }
+
+    ~basic_filebuf() override
+    {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    void swap(basic_filebuf& other)
+    {
+        basic_filebuf temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+
+    bool is_open() const { return file_ != nullptr; }
+
+    basic_filebuf* open(const char* filename, std::ios_base::openmode mode)
+    {
+        if (is_open())
+            return nullptr;
+        const char* fmode = detail::fopen_mode(mode);
+        if (fmode == nullptr)
+            return nullptr;
+        std::FILE* file = std::fopen(filename, fmode);
+        if (file == nullptr)
+            return nullptr;
+        std::setvbuf(file, nullptr, _IONBF, 0);
+        if ((mode & std::ios_base::ate) && std::fseek(file, 0, SEEK_END) != 0) {
+            std::fclose(file);
+            return nullptr;
+        }
+        file_ = file;
+        mode_ = mode;
+        state_ = state::idle;
+        return this;
+    }
+
+    basic_filebuf* open(const std::string& filename, std::ios_base::openmode mode)
+    {
+        return open(filename.c_str(), mode);
+    }
+
+    // Writes the pending output, closes the file and wipes the buffer
+    basic_filebuf* close()
+    {
+        if (!is_open())
+            return nullptr;
+        bool ok = state_ != state::writing || stop_writing();
+        discard_input();
+        buffer_.release();
+        if (std::fclose(file_) != 0)
+            ok = false;
+        file_ = nullptr;
+        state_ = state::idle;
+        return ok ? this : nullptr;
+    }
+
+    std::size_t buffer_size() const { return buffer_size_; }
+
+protected:
+    std::streamsize showmanyc() override
+    {
+        if (state_ == state::reading)
+            return this->egptr() - this->gptr();
+        return 0;
+    }
+
+    int_type underflow() override
+    {
+        if (!is_open() || !(mode_ & std::ios_base::in))
+            return traits_type::eof();
+        if (state_ == state::reading && this->gptr() < this->egptr())
+            return traits_type::to_int_type(*this->gptr());
+        if (!start_reading())
+            return traits_type::eof();
+
+        ensure_buffer();
+        buffer_.wipe();
+        std::size_t count = std::fread(buffer_.data(), sizeof(CharT), buffer_.size(), file_);
+        this->setg(buffer_.data(), buffer_.data(), buffer_.data() + count);
+        if (count == 0)
+            return traits_type::eof();
+        return traits_type::to_int_type(*this->gptr());
+    }
+
+    std::streamsize xsgetn(char_type* s, std::streamsize count) override
+    {
+        std::streamsize done = 0;
+        if (state_ == state::reading) {
+            done = std::min<std::streamsize>(count, this->egptr() - this->gptr());
+            traits_type::copy(s, this->gptr(), done);
+            this->gbump(int(done));
+        }
+        if (done == count)
+            return done;
+
+        // large reads go directly to the destination
+        if (std::size_t(count - done) >= buffer_size_) {
+            if (!is_open() || !(mode_ & std::ios_base::in) || !start_reading())
+                return done;
+            discard_input();
+            return done + std::fread(s + done, sizeof(CharT), count - done, file_);
+        }
+        return done + base_type::xsgetn(s + done, count - done);
+    }
+
+    int_type pbackfail(int_type c = traits_type::eof()) override
+    {
+        if (state_ != state::reading || this->eback() == this->gptr())
+            return traits_type::eof();
+        if (traits_type::eq_int_type(c, traits_type::eof()) ||
+            traits_type::eq(traits_type::to_char_type(c), this->gptr()[-1]))
+        {
+            this->gbump(-1);
+            return traits_type::not_eof(c);
+        }
+        return traits_type::eof();
+    }
+
+    int_type overflow(int_type c = traits_type::eof()) override
+    {
+        if (!is_open() || !(mode_ & (std::ios_base::out | std::ios_base::app)))
+            return traits_type::eof();
+        if (!start_writing() || !flush_output())
+            return traits_type::eof();
+        if (traits_type::eq_int_type(c, traits_type::eof()))
+            return traits_type::not_eof(c);
+        *this->pptr() = traits_type::to_char_type(c);
+        this->pbump(1);
+        return c;
+    }
+
+    std::streamsize xsputn(const char_type* s, std::streamsize count) override
+    {
+        // large writes go directly from the source
+        if (std::size_t(count) >= buffer_size_) {
+            if (!is_open() || !(mode_ & (std::ios_base::out | std::ios_base::app)))
+                return 0;
+            if (!start_writing() || !flush_output())
+                return 0;
+            return std::fwrite(s, sizeof(CharT), count, file_);
+        }
+        return base_type::xsputn(s, count);
+    }
+
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                     std::ios_base::openmode = std::ios_base::in | std::ios_base::out) override
+    {
+        if (!is_open())
+            return pos_type(off_type(-1));
+        if (state_ == state::writing && !stop_writing())
+            return pos_type(off_type(-1));
+
+        // tellg() must not throw away the buffered input
+        if (dir == std::ios_base::cur && off == 0 && state_ == state::reading) {
+            long pos = std::ftell(file_);
+            if (pos < 0)
+                return pos_type(off_type(-1));
+            return pos_type(off_type(pos / long(sizeof(CharT))) -
+                            (this->egptr() - this->gptr()));
+        }
+
+        int whence = dir == std::ios_base::beg ? SEEK_SET :
+                     dir == std::ios_base::cur ? SEEK_CUR : SEEK_END;
+        // the buffered input that has not been consumed yet has already been
+        // read from the file
+        if (dir == std::ios_base::cur && state_ == state::reading)
+            off -= this->egptr() - this->gptr();
+        discard_input();
+        state_ = state::idle;
+
+        if (std::fseek(file_, long(off * off_type(sizeof(CharT))), whence) != 0)
+            return pos_type(off_type(-1));
+        long pos = std::ftell(file_);
+        if (pos < 0)
+            return pos_type(off_type(-1));
+        return pos_type(off_type(pos / long(sizeof(CharT))));
+    }
+
+    pos_type seekpos(pos_type pos,
+                     std::ios_base::openmode which = std::ios_base::in | std::ios_base::out) override
+    {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+
+    int sync() override
+    {
+        if (!is_open())
+            return 0;
+        if (state_ == state::writing)
+            return flush_output() && std::fflush(file_) == 0 ? 0 : -1;
+        if (state_ == state::reading) {
+            // give back the unconsumed input so that the file position
+            // matches the stream position
+            off_type unread = this->egptr() - this->gptr();
+            discard_input();
+            state_ = state::idle;
+            if (unread > 0 &&
+                std::fseek(file_, -long(unread * off_type(sizeof(CharT))), SEEK_CUR) != 0)
+            {
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+private:
+    enum class state { idle, reading, writing };
+
+    void ensure_buffer()
+    {
+        if (buffer_.data() == nullptr)
+            buffer_ = detail::locked_buffer<CharT>(buffer_size_);
+    }
+
+    // Switches to reading. C streams require a flush or a seek between
+    // output and input on the same file.
+    bool start_reading()
+    {
+        if (state_ == state::writing && !stop_writing())
+            return false;
+        state_ = state::reading;
+        return true;
+    }
+
+    // Writes the pending output and releases the put area
+    bool stop_writing()
+    {
+        bool ok = flush_output() && std::fflush(file_) == 0;
+        this->setp(nullptr, nullptr);
+        state_ = state::idle;
+        return ok;
+    }
+
+    bool start_writing()
+    {
+        if (state_ == state::reading && sync() != 0)
+            return false;
+        if (state_ != state::writing) {
+            ensure_buffer();
+            this->setp(buffer_.data(), buffer_.data() + buffer_.size());
+            state_ = state::writing;
+        }
+        return true;
+    }
+
+    // Writes the contents of the put area to the file and wipes them
+    bool flush_output()
+    {
+        if (state_ != state::writing)
+            return true;
+        std::size_t count = this->pptr() - this->pbase();
+        bool ok = std::fwrite(this->pbase(), sizeof(CharT), count, file_) == count;
+        buffer_.wipe();
+        this->setp(buffer_.data(), buffer_.data() + buffer_.size());
+        return ok;
+    }
+
+    // Wipes the get area
+    void discard_input()
+    {
+        if (state_ == state::reading)
+            buffer_.wipe();
+        this->setg(nullptr, nullptr, nullptr);
+    }
+
+    std::FILE* file_;
+    std::ios_base::openmode mode_;
+    std::size_t buffer_size_;
+    detail::locked_buffer<CharT> buffer_;
+    state state_;
+};
+
+template<class CharT, class Traits>
+const std::size_t basic_filebuf<CharT, Traits>::default_buffer_bytes;
+
+template<class CharT, class Traits>
+void swap(basic_filebuf<CharT, Traits>& lhs, basic_filebuf<CharT, Traits>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+/*  Equivalents of std::basic_ifstream, std::basic_ofstream and
+    std::basic_fstream that use tidy::basic_filebuf.
+*/
+template<class CharT, class Traits = std::char_traits<CharT>>
+class basic_ifstream : public std::basic_istream<CharT, Traits> {
+    using base_type = std::basic_istream<CharT, Traits>;
+public:
+    typedef CharT char_type;
+    typedef Traits traits_type;
+    typedef typename Traits::int_type int_type;
+    typedef typename Traits::pos_type pos_type;
+    typedef typename Traits::off_type off_type;
+    using filebuf_type = basic_filebuf<CharT, Traits>;
+
+    basic_ifstream() : base_type(&sb_) {}
+
+    explicit basic_ifstream(const char* filename,
+                            std::ios_base::openmode mode = std::ios_base::in) :
+        base_type(&sb_)
+    {
+        open(filename, mode);
+    }
+
+    explicit basic_ifstream(const std::string& filename,
+                            std::ios_base::openmode mode = std::ios_base::in) :
+        basic_ifstream(filename.c_str(), mode)
+    {}
+
+    basic_ifstream(basic_ifstream&& other) :
+        base_type(std::move(other)), sb_(std::move(other.sb_))
+    {
+        base_type::set_rdbuf(&sb_);
+    }
+
+    basic_ifstream& operator=(basic_ifstream&& other)
+    {
+        base_type::operator=(std::move(other));
+        sb_ = std::move(other.sb_);
+        return *this;
+    }
+
+    void swap(basic_ifstream& other)
+    {
+        base_type::swap(other);
+        sb_.swap(other.sb_);
+    }
+
+    filebuf_type* rdbuf() const { return const_cast<filebuf_type*>(&sb_); }
+
+    bool is_open() const { return sb_.is_open(); }
+
+    void open(const char* filename, std::ios_base::openmode mode = std::ios_base::in)
+    {
+        if (sb_.open(filename, mode | std::ios_base::in))
+            this->clear();
+        else
+            this->setstate(std::ios_base::failbit);
+    }
+
+    void open(const std::string& filename, std::ios_base::openmode mode = std::ios_base::in)
+    {
+        open(filename.c_str(), mode);
+    }
+
+    void close()
+    {
+        if (!sb_.close())
+            this->setstate(std::ios_base::failbit);
+    }
+
+private:
+    filebuf_type sb_;
+};
+
+template<class CharT, class Traits = std::char_traits<CharT>>
+class basic_ofstream : public std::basic_ostream<CharT, Traits> {
+    using base_type = std::basic_ostream<CharT, Traits>;
+public:
+    typedef CharT char_type;
+    typedef Traits traits_type;
+    typedef typename Traits::int_type int_type;
+    typedef typename Traits::pos_type pos_type;
+    typedef typename Traits::off_type off_type;
+    using filebuf_type = basic_filebuf<CharT, Traits>;
+
+    basic_ofstream() : base_type(&sb_) {}
+
+    explicit basic_ofstream(const char* filename,
+                            std::ios_base::openmode mode = std::ios_base::out) :
+        base_type(&sb_)
+    {
+        open(filename, mode);
+    }
+
+    explicit basic_ofstream(const std::string& filename,
+                            std::ios_base::openmode mode = std::ios_base::out) :
+        basic_ofstream(filename.c_str(), mode)
+    {}
+
+    basic_ofstream(basic_ofstream&& other) :
+        base_type(std::move(other)), sb_(std::move(other.sb_))
+    {
+        base_type::set_rdbuf(&sb_);
+    }
+
+    basic_ofstream& operator=(basic_ofstream&& other)
+    {
+        base_type::operator=(std::move(other));
+        sb_ = std::move(other.sb_);
+        return *this;
+    }
+
+    void swap(basic_ofstream& other)
+    {
+        base_type::swap(other);
+        sb_.swap(other.sb_);
+    }
+
+    filebuf_type* rdbuf() const { return const_cast<filebuf_type*>(&sb_); }
+
+    bool is_open() const { return sb_.is_open(); }
+
+    void open(const char* filename, std::ios_base::openmode mode = std::ios_base::out)
+    {
+        if (sb_.open(filename, mode | std::ios_base::out))
+            this->clear();
+        else
+            this->setstate(std::ios_base::failbit);
+    }
+
+    void open(const std::string& filename, std::ios_base::openmode mode = std::ios_base::out)
+    {
+        open(filename.c_str(), mode);
+    }
+
+    void close()
+    {
+        if (!sb_.close())
+            this->setstate(std::ios_base::failbit);
+    }
+
+private:
+    filebuf_type sb_;
+};
+
+template<class CharT, class Traits = std::char_traits<CharT>>
+class basic_fstream : public std::basic_iostream<CharT, Traits> {
+    using base_type = std::basic_iostream<CharT, Traits>;
+public:
+    typedef CharT char_type;
+    typedef Traits traits_type;
+    typedef typename Traits::int_type int_type;
+    typedef typename Traits::pos_type pos_type;
+    typedef typename Traits::off_type off_type;
+    using filebuf_type = basic_filebuf<CharT, Traits>;
+
+    basic_fstream() : base_type(&sb_) {}
+
+    explicit basic_fstream(const char* filename,
+                           std::ios_base::openmode mode =
+                               std::ios_base::in | std::ios_base::out) :
+        base_type(&sb_)
+    {
+        open(filename, mode);
+    }
+
+    explicit basic_fstream(const std::string& filename,
+                           std::ios_base::openmode mode =
+                               std::ios_base::in | std::ios_base::out) :
+        basic_fstream(filename.c_str(), mode)
+    {}
+
+    basic_fstream(basic_fstream&& other) :
+        base_type(std::move(other)), sb_(std::move(other.sb_))
+    {
+        base_type::set_rdbuf(&sb_);
+    }
+
+    basic_fstream& operator=(basic_fstream&& other)
+    {
+        base_type::operator=(std::move(other));
+        sb_ = std::move(other.sb_);
+        return *this;
+    }
+
+    void swap(basic_fstream& other)
+    {
+        base_type::swap(other);
+        sb_.swap(other.sb_);
+    }
+
+    filebuf_type* rdbuf() const { return const_cast<filebuf_type*>(&sb_); }
+
+    bool is_open() const { return sb_.is_open(); }
+
+    void open(const char* filename,
+              std::ios_base::openmode mode = std::ios_base::in | std::ios_base::out)
+    {
+        if (sb_.open(filename, mode))
+            this->clear();
+        else
+            this->setstate(std::ios_base::failbit);
+    }
+
+    void open(const std::string& filename,
+              std::ios_base::openmode mode = std::ios_base::in | std::ios_base::out)
+    {
+        open(filename.c_str(), mode);
+    }
+
+    void close()
+    {
+        if (!sb_.close())
+            this->setstate(std::ios_base::failbit);
+    }
+
+private:
+    filebuf_type sb_;
+};
+
+template<class CharT, class Traits>
+void swap(basic_ifstream<CharT, Traits>& lhs, basic_ifstream<CharT, Traits>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+template<class CharT, class Traits>
+void swap(basic_ofstream<CharT, Traits>& lhs, basic_ofstream<CharT, Traits>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+template<class CharT, class Traits>
+void swap(basic_fstream<CharT, Traits>& lhs, basic_fstream<CharT, Traits>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+using filebuf = basic_filebuf<char>;
+using ifstream = basic_ifstream<char>;
+using ofstream = basic_ofstream<char>;
+using fstream = basic_fstream<char>;
+
+/*  Reads the whole contents of the file at the given path. The storage is
+    allocated once, using the size of the file, and the data is read directly
+    into it without intermediate buffers. std::system_error is thrown if the
+    file can't be opened or read.
+*/
+inline string read_file(const char* path)
+{
+    string result;
+    detail::read_file_into(path, result);
+    return result;
+}
+
+inline string read_file(const std::string& path)
+{
+    return read_file(path.c_str());
+}
+
+inline vector<std::uint8_t> read_file_bytes(const char* path)
+{
+    vector<std::uint8_t> result;
+    detail::read_file_into(path, result);
+    return result;
+}
+
+inline vector<std::uint8_t> read_file_bytes(const std::string& path)
+{
+    return read_file_bytes(path.c_str());
+}
+
+} // namespace tidy
+
+#endif
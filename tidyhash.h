@@ -0,0 +1,343 @@
+/*  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+
+    Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+            http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef TIDY_TIDYHASH_H
+#define TIDY_TIDYHASH_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TIDY_HASH_SSE2 1
+#endif
+
+/*  The keyed hash used by the hashing containers and the std::hash
+    specializations for tidy::basic_string and tidy::vector. Include this
+    header to use the specializations with the standard containers.
+*/
+
+namespace tidy {
+
+// Declared here so that hashing doesn't require the string header
+template<class T, class Allocator> class vector;
+template<class CharT, class Traits, class Allocator> class basic_string;
+
+namespace detail {
+
+// The number of bytes of hash_key::secret
+static const std::size_t hash_secret_size = 192;
+
+struct hash_key {
+    std::uint64_t k0;
+    std::uint64_t k1;
+    // derived from k0 and k1, used by the long input kernel
+    unsigned char secret[hash_secret_size];
+};
+
+inline std::uint64_t hash_splitmix(std::uint64_t& state)
+{
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+inline hash_key make_hash_key()
+{
+    hash_key key;
+    try {
+        std::random_device rd;
+        key.k0 = (std::uint64_t(rd()) << 32) ^ rd();
+        key.k1 = (std::uint64_t(rd()) << 32) ^ rd();
+    } catch (...) {
+        // no entropy source; the key is still different for each run
+        std::uint64_t t = std::uint64_t(
+                    std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        key.k0 = t ^ std::uint64_t(reinterpret_cast<std::uintptr_t>(&key));
+        key.k1 = t * 0x9e3779b97f4a7c15ull;
+    }
+    std::uint64_t state = key.k0 ^ (key.k1 * 0xa0761d6478bd642full);
+    for (std::size_t i = 0; i < hash_secret_size; i += 8) {
+        std::uint64_t word = hash_splitmix(state);
+        std::memcpy(key.secret + i, &word, 8);
+    }
+    return key;
+}
+
+/*  The key of hash_bytes. It is generated once per process so that the hash
+    values, and thus which keys collide in hash tables, can't be predicted
+    from outside the process.
+*/
+inline const hash_key& process_hash_key()
+{
+    static const hash_key key = make_hash_key();
+    return key;
+}
+
+// Multiplies a and b into a 128-bit product and folds it into 64 bits
+inline std::uint64_t hash_mum(std::uint64_t a, std::uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+    return std::uint64_t(r) ^ std::uint64_t(r >> 64);
+#else
+    std::uint64_t ah = a >> 32, al = a & 0xffffffff;
+    std::uint64_t bh = b >> 32, bl = b & 0xffffffff;
+    std::uint64_t hh = ah * bh, hl = ah * bl, lh = al * bh, ll = al * bl;
+    std::uint64_t mid = (ll >> 32) + (hl & 0xffffffff) + (lh & 0xffffffff);
+    std::uint64_t lo = (mid << 32) | (ll & 0xffffffff);
+    std::uint64_t hi = hh + (hl >> 32) + (lh >> 32) + (mid >> 32);
+    return lo ^ hi;
+#endif
+}
+
+inline std::uint64_t hash_read8(const unsigned char* p)
+{
+    std::uint64_t r;
+    std::memcpy(&r, p, 8);
+    return r;
+}
+
+inline std::uint64_t hash_read4(const unsigned char* p)
+{
+    std::uint32_t r;
+    std::memcpy(&r, p, 4);
+    return r;
+}
+
+/*  The kernel for long inputs, modelled after XXH3. The input is split into
+    64-byte stripes which are accumulated into eight 64-bit lanes:
+    acc += swapped data + low half * high half of (data ^ secret), with the
+    secret offset by 8 bytes for each stripe so that the stripes can't be
+    reordered. The lanes are scrambled after each block of 16 stripes. There
+    are no dependencies between the stripes except the additions, thus SSE2
+    processes two lanes per instruction.
+*/
+static const std::size_t hash_stripe = 64;
+static const std::size_t hash_stripes_per_block = (hash_secret_size - hash_stripe) / 8;
+static const std::uint64_t hash_prime32 = 0x9e3779b1u;
+
+#if TIDY_HASH_SSE2
+
+struct hash_acc {
+    __m128i v[4];
+
+    explicit hash_acc(const hash_key& key)
+    {
+        for (int i = 0; i < 4; ++i)
+            v[i] = _mm_set_epi64x(std::int64_t(key.k1 + i), std::int64_t(key.k0 - i));
+    }
+
+    void accumulate(const unsigned char* p, const unsigned char* secret)
+    {
+        for (int i = 0; i < 4; ++i) {
+            __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+            __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret + 16 * i));
+            __m128i dk = _mm_xor_si128(data, k);
+            __m128i product = _mm_mul_epu32(dk, _mm_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1)));
+            __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            v[i] = _mm_add_epi64(v[i], _mm_add_epi64(product, swapped));
+        }
+    }
+
+    void scramble(const unsigned char* secret)
+    {
+        const __m128i prime = _mm_set1_epi32(int(hash_prime32));
+        for (int i = 0; i < 4; ++i) {
+            __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret + 16 * i));
+            __m128i a = _mm_xor_si128(_mm_xor_si128(v[i], _mm_srli_epi64(v[i], 47)), k);
+            __m128i lo = _mm_mul_epu32(a, prime);
+            __m128i hi = _mm_mul_epu32(_mm_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+            v[i] = _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+        }
+    }
+
+    std::uint64_t lane(int i) const
+    {
+        std::uint64_t lanes[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), v[i / 2]);
+        return lanes[i % 2];
+    }
+};
+
+#else
+
+struct hash_acc {
+    std::uint64_t v[8];
+
+    explicit hash_acc(const hash_key& key)
+    {
+        for (int i = 0; i < 4; ++i) {
+            v[2 * i] = key.k0 - i;
+            v[2 * i + 1] = key.k1 + i;
+        }
+    }
+
+    void accumulate(const unsigned char* p, const unsigned char* secret)
+    {
+        for (int i = 0; i < 8; ++i) {
+            std::uint64_t data = hash_read8(p + 8 * i);
+            std::uint64_t dk = data ^ hash_read8(secret + 8 * i);
+            v[i ^ 1] += data;
+            v[i] += (dk & 0xffffffff) * (dk >> 32);
+        }
+    }
+
+    void scramble(const unsigned char* secret)
+    {
+        for (int i = 0; i < 8; ++i) {
+            std::uint64_t a = v[i] ^ (v[i] >> 47) ^ hash_read8(secret + 8 * i);
+            v[i] = a * hash_prime32;
+        }
+    }
+
+    std::uint64_t lane(int i) const { return v[i]; }
+};
+
+#endif
+
+inline std::uint64_t hash_long(const unsigned char* p, std::size_t size, const hash_key& key)
+{
+    hash_acc acc(key);
+    const std::size_t block = hash_stripe * hash_stripes_per_block;
+    const unsigned char* scramble_secret = key.secret + hash_secret_size - hash_stripe;
+
+    std::size_t blocks = (size - 1) / block;
+    for (std::size_t b = 0; b < blocks; ++b) {
+        for (std::size_t s = 0; s < hash_stripes_per_block; ++s)
+            acc.accumulate(p + s * hash_stripe, key.secret + s * 8);
+        acc.scramble(scramble_secret);
+        p += block;
+    }
+
+    // the rest of the last block and then its last stripe, which possibly
+    // overlaps the previous one
+    std::size_t left = size - blocks * block;
+    std::size_t stripes = (left - 1) / hash_stripe;
+    for (std::size_t s = 0; s < stripes; ++s)
+        acc.accumulate(p + s * hash_stripe, key.secret + s * 8);
+    acc.accumulate(p + left - hash_stripe, key.secret + hash_secret_size - hash_stripe - 7);
+
+    std::uint64_t h = std::uint64_t(size) * 0x9e3779b97f4a7c15ull;
+    for (int i = 0; i < 8; i += 2) {
+        h += hash_mum(acc.lane(i) ^ hash_read8(key.secret + 11 + 8 * i),
+                      acc.lane(i + 1) ^ hash_read8(key.secret + 19 + 8 * i));
+    }
+    return h;
+}
+
+/*  Keyed hash of the given bytes. Short inputs are read 16 bytes at a time
+    and mixed using 64x64->128-bit multiplication, in two independent lanes
+    above 16 bytes and four above 64 bytes. Inputs longer than 256 bytes use
+    hash_long. The key is random for each process, thus the hash values must
+    not be stored or sent elsewhere.
+*/
+inline std::size_t hash_bytes(const void* data, std::size_t size)
+{
+    const hash_key& key = process_hash_key();
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    std::uint64_t h = key.k0 ^ (std::uint64_t(size) * 0xa0761d6478bd642full);
+
+    if (size <= 16) {
+        std::uint64_t a = 0;
+        std::uint64_t b = 0;
+        if (size > 8) {
+            a = hash_read8(p);
+            b = hash_read8(p + size - 8);
+        } else if (size >= 4) {
+            a = hash_read4(p);
+            b = hash_read4(p + size - 4);
+        } else if (size > 0) {
+            a = (std::uint64_t(p[0]) << 16) | (std::uint64_t(p[size / 2]) << 8) | p[size - 1];
+        }
+        h = hash_mum(a ^ key.k1, b ^ h);
+    } else if (size <= 256) {
+        std::size_t left = size;
+        if (left > 64) {
+            // Four independent lanes, so that the multiplications of a block
+            // don't wait for each other. The lanes are folded at the end.
+            std::uint64_t h1 = h ^ key.k1;
+            std::uint64_t h2 = h ^ (key.k0 >> 32 | key.k0 << 32);
+            std::uint64_t h3 = h ^ (key.k1 >> 32 | key.k1 << 32);
+            do {
+                h = hash_mum(hash_read8(p) ^ key.k1, hash_read8(p + 8) ^ h);
+                h1 = hash_mum(hash_read8(p + 16) ^ key.k0, hash_read8(p + 24) ^ h1);
+                h2 = hash_mum(hash_read8(p + 32) ^ key.k1, hash_read8(p + 40) ^ h2);
+                h3 = hash_mum(hash_read8(p + 48) ^ key.k0, hash_read8(p + 56) ^ h3);
+                p += 64;
+                left -= 64;
+            } while (left > 64);
+            h = hash_mum(h ^ h2, h1 ^ h3 ^ key.k1);
+        }
+        std::uint64_t h1 = h ^ key.k1;
+        while (left > 32) {
+            h = hash_mum(hash_read8(p) ^ key.k1, hash_read8(p + 8) ^ h);
+            h1 = hash_mum(hash_read8(p + 16) ^ key.k0, hash_read8(p + 24) ^ h1);
+            p += 32;
+            left -= 32;
+        }
+        if (left <= 16) {
+            // step back over the bytes hashed above
+            p -= 16;
+            left += 16;
+        }
+        // the last 17 to 32 bytes as two possibly overlapping halves
+        h = hash_mum(hash_read8(p) ^ key.k1, hash_read8(p + 8) ^ h) ^
+            hash_mum(hash_read8(p + left - 16) ^ key.k0, hash_read8(p + left - 8) ^ h1);
+    } else {
+        h = hash_long(p, size, key);
+    }
+    return std::size_t(hash_mum(h ^ key.k0, std::uint64_t(size) ^ 0xe7037ed1a0b428dbull));
+}
+
+} // namespace detail
+} // namespace tidy
+
+namespace std {
+
+/*  Hashes the characters in place, without converting to std::basic_string
+    first. Strings with equal contents have equal hashes regardless of the
+    allocator, e.g. tidy::string and tidy::static_string.
+*/
+template<class CharT, class Traits, class Alloc>
+struct hash<tidy::basic_string<CharT, Traits, Alloc>> {
+    typedef tidy::basic_string<CharT, Traits, Alloc> argument_type;
+    typedef std::size_t result_type;
+
+    std::size_t operator()(const tidy::basic_string<CharT, Traits, Alloc>& s) const noexcept
+    {
+        return tidy::detail::hash_bytes(s.data(), s.size() * sizeof(CharT));
+    }
+};
+
+/*  Hashes the bytes of the elements directly. Only vectors of types whose
+    value is fully determined by their bytes are supported.
+*/
+template<class T, class Alloc>
+struct hash<tidy::vector<T, Alloc>> {
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value ||
+                  std::is_pointer<T>::value,
+                  "hash of tidy::vector requires integral, enum or pointer elements");
+
+    typedef tidy::vector<T, Alloc> argument_type;
+    typedef std::size_t result_type;
+
+    std::size_t operator()(const tidy::vector<T, Alloc>& v) const noexcept
+    {
+        return tidy::detail::hash_bytes(v.data(), v.size() * sizeof(T));
+    }
+};
+
+} // namespace std
+
+#endif
@@ -0,0 +1,81 @@
+/*  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+
+    Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+            http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef TIDY_TIDYINPLACEVECTOR_H
+#define TIDY_TIDYINPLACEVECTOR_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include "tidysmallvector.h"
+
+namespace tidy {
+namespace detail {
+
+/*  An allocator that never provides any storage. Its max_size() is N, thus
+    containers report capacity errors before trying to allocate. Used to
+    select storage that lives entirely within the container object.
+*/
+template<class T, std::size_t N>
+struct inplace_allocator {
+    typedef T value_type;
+    typedef std::true_type is_always_equal;
+    typedef std::true_type propagate_on_container_move_assignment;
+
+    template<class U> struct rebind { typedef inplace_allocator<U, N> other; };
+
+    constexpr inplace_allocator() noexcept {}
+    template<class U>
+    constexpr inplace_allocator(const inplace_allocator<U, N>&) noexcept {}
+
+    T* allocate(std::size_t)
+    {
+        throw std::bad_alloc();
+    }
+
+    void deallocate(T*, std::size_t) noexcept {}
+
+    constexpr std::size_t max_size() const noexcept { return N; }
+};
+
+template<class T, class U, std::size_t N>
+constexpr bool operator==(const inplace_allocator<T, N>&,
+                          const inplace_allocator<U, N>&) noexcept
+{
+    return true;
+}
+
+template<class T, class U, std::size_t N>
+constexpr bool operator!=(const inplace_allocator<T, N>&,
+                          const inplace_allocator<U, N>&) noexcept
+{
+    return false;
+}
+
+template<class Alloc>
+struct is_inplace_allocator : public std::false_type {};
+
+template<class T, std::size_t N>
+struct is_inplace_allocator<inplace_allocator<T, N>> : public std::true_type {};
+
+} // namespace detail
+
+/*  A vector class with fixed capacity N that never allocates and does not
+    leak information to memory. The elements are stored within the object
+    itself and are wiped when they are removed or the vector is destroyed.
+
+    Operations that would increase the size past N throw std::length_error,
+    the same way operations of other containers do when exceeding max_size().
+
+    Only trivial types are supported.
+*/
+template<class T, std::size_t N>
+using inplace_vector = small_vector<T, N, detail::inplace_allocator<T, N>>;
+
+} // namespace tidy
+
+#endif
@@ -0,0 +1,463 @@
+/*  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+
+    Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+            http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef TIDY_TIDYLRUCACHE_H
+#define TIDY_TIDYLRUCACHE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include "tidyhash.h"
+#include "tidystring.h"
+#include "tidyvector.h"
+
+namespace tidy {
+
+/*  A thread-safe cache that evicts the least recently used entries once it
+    is full and expires entries after their time to live. The entries are
+    split into independently locked shards by the hash of the key, so that
+    concurrent accesses to different shards don't contend.
+
+    Key must be a tidy::basic_string. Value should be a type that wipes its
+    memory on destruction, such as tidy::vector or tidy::basic_string. The
+    key and the value of an entry are destroyed as soon as the entry is
+    evicted, expires, is erased or the cache is cleared. The storage of all
+    entries is allocated when the cache is created.
+
+    Lookups take the key as a pointer and a length, so no temporary key
+    needs to be constructed. visit() gives access to a value without copying
+    it out of the cache.
+
+    Expired entries are removed by a timer wheel per shard, which is advanced
+    on each access to the shard and by expire(). A time to live of zero means
+    that the entry never expires.
+
+    Clock is a type satisfying the standard Clock requirements, by default
+    std::chrono::steady_clock.
+*/
+template<class Value, class Key = string, class Clock = std::chrono::steady_clock>
+class lru_cache {
+public:
+    typedef Key key_type;
+    typedef Value mapped_type;
+    typedef typename Key::value_type char_type;
+    typedef typename Key::traits_type traits_type;
+    typedef typename Clock::duration duration;
+    typedef typename Clock::time_point time_point;
+    typedef std::size_t size_type;
+
+    /*  Creates a cache holding at least capacity entries, split into
+        shard_count shards, rounded up to a power of two. Each shard holds
+        an equal share of the capacity. default_ttl is the time to live of
+        entries inserted without an explicit one.
+    */
+    explicit lru_cache(size_type capacity, duration default_ttl = duration::zero(),
+                       size_type shard_count = 16) :
+        default_ttl_(default_ttl)
+    {
+        shard_bits_ = 0;
+        while ((size_type(1) << shard_bits_) < std::max<size_type>(shard_count, 1))
+            ++shard_bits_;
+        shard_count = size_type(1) << shard_bits_;
+
+        size_type per_shard = std::max<size_type>((capacity + shard_count - 1) / shard_count, 1);
+        if (per_shard >= npos)
+            throw std::length_error("capacity is too large");
+
+        duration tick = default_ttl > duration::zero()
+                ? std::max(default_ttl / 16, duration(1))
+                : std::chrono::duration_cast<duration>(std::chrono::seconds(1));
+
+        shards_.reset(new shard[shard_count]);
+        for (size_type i = 0; i < shard_count; ++i)
+            shards_[i].init(per_shard, tick, shard_bits_);
+    }
+
+    lru_cache(const lru_cache&) = delete;
+    lru_cache& operator=(const lru_cache&) = delete;
+
+    size_type shard_count() const { return size_type(1) << shard_bits_; }
+
+    size_type capacity() const { return shard_count() * shards_[0].entries.size(); }
+
+    // The number of entries, including the expired ones that have not been
+    // removed yet
+    size_type size() const
+    {
+        size_type result = 0;
+        for (size_type i = 0; i < shard_count(); ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            result += shards_[i].size;
+        }
+        return result;
+    }
+
+    /*  Inserts the given entry or replaces the value of an existing entry
+        with the same key. If the shard is full, its least recently used
+        entry is evicted.
+    */
+    void put(Key key, Value value)
+    {
+        put(std::move(key), std::move(value), default_ttl_);
+    }
+
+    void put(Key key, Value value, duration ttl)
+    {
+        std::size_t hash = hash_key(key.data(), key.size());
+        time_point now = Clock::now();
+        shard& s = shard_for(hash);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.advance(now);
+        s.insert(hash, std::move(key), std::move(value), ttl, now);
+    }
+
+    /*  Copies the value of the entry with the given key to out. Returns false
+        if there's no such entry or it has expired. The entry becomes the
+        most recently used one.
+    */
+    bool get(const char_type* key, size_type size, Value& out)
+    {
+        return visit(key, size, [&](const Value& value) { out = value; });
+    }
+
+    bool get(const Key& key, Value& out)
+    {
+        return get(key.data(), key.size(), out);
+    }
+
+    /*  Calls f(const Value&) on the value of the entry with the given key
+        while the shard is locked. Returns false without calling f if there's
+        no such entry or it has expired.
+    */
+    template<class F>
+    bool visit(const char_type* key, size_type size, F f)
+    {
+        std::size_t hash = hash_key(key, size);
+        time_point now = Clock::now();
+        shard& s = shard_for(hash);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.advance(now);
+        std::uint32_t i = s.find(hash, key, size);
+        if (i == npos)
+            return false;
+        entry& e = s.entries[i];
+        if (e.timed && e.expires <= now) {
+            s.remove(i);
+            return false;
+        }
+        s.touch(i);
+        f(static_cast<const Value&>(e.value));
+        return true;
+    }
+
+    template<class F>
+    bool visit(const Key& key, F f)
+    {
+        return visit(key.data(), key.size(), f);
+    }
+
+    bool contains(const char_type* key, size_type size)
+    {
+        return visit(key, size, [](const Value&) {});
+    }
+
+    bool contains(const Key& key)
+    {
+        return contains(key.data(), key.size());
+    }
+
+    // Removes the entry with the given key. Returns false if there's none.
+    bool erase(const char_type* key, size_type size)
+    {
+        std::size_t hash = hash_key(key, size);
+        shard& s = shard_for(hash);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        std::uint32_t i = s.find(hash, key, size);
+        if (i == npos)
+            return false;
+        s.remove(i);
+        return true;
+    }
+
+    bool erase(const Key& key)
+    {
+        return erase(key.data(), key.size());
+    }
+
+    void clear()
+    {
+        for (size_type i = 0; i < shard_count(); ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            while (shards_[i].lru_tail != npos)
+                shards_[i].remove(shards_[i].lru_tail);
+        }
+    }
+
+    // Removes all expired entries
+    void expire()
+    {
+        time_point now = Clock::now();
+        for (size_type i = 0; i < shard_count(); ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            shards_[i].advance(now);
+        }
+    }
+
+private:
+    static const std::uint32_t npos = std::uint32_t(-1);
+    static const unsigned wheel_size = 64;
+
+    struct entry {
+        Key key;
+        Value value;
+        time_point expires;
+        std::size_t hash = 0;
+        std::uint32_t hash_next = npos;
+        std::uint32_t lru_prev = npos;
+        std::uint32_t lru_next = npos;
+        std::uint32_t wheel_prev = npos;
+        std::uint32_t wheel_next = npos;
+        std::uint32_t wheel_slot = 0;
+        bool timed = false;
+    };
+
+    /*  The entries of a shard are stored in a single preallocated vector and
+        refer to each other by index. Each entry is a member of three lists:
+        the chain of its hash bucket, the LRU list (most recent first) and,
+        if it expires, the list of its timer wheel slot. Unused entries are
+        chained through hash_next starting from free_head.
+    */
+    struct shard {
+        mutable std::mutex mutex;
+        vector<entry> entries;
+        vector<std::uint32_t> buckets;
+        std::uint32_t wheel[wheel_size];
+        std::uint32_t free_head = npos;
+        std::uint32_t lru_head = npos;
+        std::uint32_t lru_tail = npos;
+        size_type size = 0;
+        duration tick;
+        std::int64_t last_tick = -1;
+        // the shard index is taken from the low bits of the hash and the
+        // bucket index from the bits above them
+        unsigned shard_bits = 0;
+
+        void init(size_type capacity, duration tick_length, unsigned hash_shift)
+        {
+            entries.resize(capacity);
+            for (size_type i = 0; i < capacity; ++i)
+                entries[i].hash_next = i + 1 < capacity ? std::uint32_t(i + 1) : npos;
+            free_head = 0;
+            size_type bucket_count = 1;
+            while (bucket_count < capacity)
+                bucket_count *= 2;
+            buckets.assign(bucket_count, npos);
+            std::fill(wheel, wheel + wheel_size, npos);
+            tick = tick_length;
+            shard_bits = hash_shift;
+        }
+
+        std::uint32_t& bucket(std::size_t hash)
+        {
+            return buckets[(hash >> shard_bits) & (buckets.size() - 1)];
+        }
+
+        std::uint32_t find(std::size_t hash, const char_type* key, size_type size)
+        {
+            std::uint32_t i = bucket(hash);
+            while (i != npos) {
+                const entry& e = entries[i];
+                if (e.hash == hash && e.key.size() == size &&
+                    traits_type::compare(e.key.data(), key, size) == 0)
+                {
+                    return i;
+                }
+                i = e.hash_next;
+            }
+            return npos;
+        }
+
+        void touch(std::uint32_t i)
+        {
+            if (lru_head == i)
+                return;
+            unlink_lru(i);
+            link_lru_front(i);
+        }
+
+        void link_lru_front(std::uint32_t i)
+        {
+            entries[i].lru_prev = npos;
+            entries[i].lru_next = lru_head;
+            if (lru_head != npos)
+                entries[lru_head].lru_prev = i;
+            lru_head = i;
+            if (lru_tail == npos)
+                lru_tail = i;
+        }
+
+        void unlink_lru(std::uint32_t i)
+        {
+            entry& e = entries[i];
+            if (e.lru_prev != npos)
+                entries[e.lru_prev].lru_next = e.lru_next;
+            else
+                lru_head = e.lru_next;
+            if (e.lru_next != npos)
+                entries[e.lru_next].lru_prev = e.lru_prev;
+            else
+                lru_tail = e.lru_prev;
+        }
+
+        std::int64_t tick_of(time_point t, bool round_up) const
+        {
+            auto count = t.time_since_epoch().count();
+            auto length = tick.count();
+            if (round_up)
+                count += length - 1;
+            return std::int64_t(count / length);
+        }
+
+        void link_wheel(std::uint32_t i)
+        {
+            entry& e = entries[i];
+            // entries that expire before the next tick is processed are put
+            // to the slot of that tick
+            std::int64_t t = std::max(tick_of(e.expires, true), last_tick + 1);
+            e.wheel_slot = std::uint32_t(t % wheel_size);
+            e.wheel_prev = npos;
+            e.wheel_next = wheel[e.wheel_slot];
+            if (e.wheel_next != npos)
+                entries[e.wheel_next].wheel_prev = i;
+            wheel[e.wheel_slot] = i;
+        }
+
+        void unlink_wheel(std::uint32_t i)
+        {
+            entry& e = entries[i];
+            if (e.wheel_prev != npos)
+                entries[e.wheel_prev].wheel_next = e.wheel_next;
+            else
+                wheel[e.wheel_slot] = e.wheel_next;
+            if (e.wheel_next != npos)
+                entries[e.wheel_next].wheel_prev = e.wheel_prev;
+        }
+
+        // Removes the entries that expired in the ticks since the last call
+        void advance(time_point now)
+        {
+            std::int64_t current = tick_of(now, false);
+            if (last_tick < 0 || current <= last_tick) {
+                last_tick = std::max(last_tick, current);
+                return;
+            }
+            std::int64_t steps = std::min<std::int64_t>(current - last_tick, wheel_size);
+            for (std::int64_t t = last_tick + 1; t <= last_tick + steps; ++t) {
+                std::uint32_t i = wheel[t % wheel_size];
+                while (i != npos) {
+                    std::uint32_t next = entries[i].wheel_next;
+                    // entries expiring in later rotations stay in the slot
+                    if (entries[i].expires <= now)
+                        remove(i);
+                    i = next;
+                }
+            }
+            last_tick = current;
+        }
+
+        void insert(std::size_t hash, Key&& key, Value&& value, duration ttl, time_point now)
+        {
+            std::uint32_t i = find(hash, key.data(), key.size());
+            if (i != npos) {
+                entry& e = entries[i];
+                e.value = std::move(value);
+                if (e.timed)
+                    unlink_wheel(i);
+                set_expiry(i, ttl, now);
+                touch(i);
+                return;
+            }
+
+            if (free_head == npos)
+                remove(lru_tail);
+            i = free_head;
+            entry& e = entries[i];
+            free_head = e.hash_next;
+            e.key = std::move(key);
+            e.value = std::move(value);
+            e.hash = hash;
+            std::uint32_t& b = bucket(hash);
+            e.hash_next = b;
+            b = i;
+            link_lru_front(i);
+            set_expiry(i, ttl, now);
+            ++size;
+        }
+
+        void set_expiry(std::uint32_t i, duration ttl, time_point now)
+        {
+            entry& e = entries[i];
+            e.timed = ttl > duration::zero();
+            if (e.timed) {
+                e.expires = now + ttl;
+                link_wheel(i);
+            }
+        }
+
+        // Unlinks the entry from all lists and destroys the key and the value
+        void remove(std::uint32_t i)
+        {
+            entry& e = entries[i];
+            std::uint32_t* link = &bucket(e.hash);
+            while (*link != i)
+                link = &entries[*link].hash_next;
+            *link = e.hash_next;
+            unlink_lru(i);
+            if (e.timed)
+                unlink_wheel(i);
+
+            {
+                Key dead_key(std::move(e.key));
+                Value dead_value(std::move(e.value));
+            }
+            e.timed = false;
+            e.hash = 0;
+            e.hash_next = free_head;
+            free_head = i;
+            --size;
+        }
+    };
+
+    static std::size_t hash_key(const char_type* key, size_type size)
+    {
+        return detail::hash_bytes(key, size * sizeof(char_type));
+    }
+
+    shard& shard_for(std::size_t hash)
+    {
+        return shards_[hash & (shard_count() - 1)];
+    }
+
+    duration default_ttl_;
+    unsigned shard_bits_;
+    std::unique_ptr<shard[]> shards_;
+};
+
+template<class Value, class Key, class Clock>
+const std::uint32_t lru_cache<Value, Key, Clock>::npos;
+
+template<class Value, class Key, class Clock>
+const unsigned lru_cache<Value, Key, Clock>::wheel_size;
+
+} // namespace tidy
+
+#endif
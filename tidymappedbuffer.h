@@ -0,0 +1,385 @@
+/*  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+
+    Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+            http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef TIDY_TIDYMAPPEDBUFFER_H
+#define TIDY_TIDYMAPPEDBUFFER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include "tidyvector.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#error "tidy::mapped_buffer requires mmap"
+#endif
+
+namespace tidy {
+
+/*  A private memory mapping of a file with a read-only interface similar to
+    tidy::vector<uint8_t>. Pages are loaded lazily when they are accessed, so
+    opening a file takes constant time regardless of its size.
+
+    The file is mapped read-only. mutable_data() makes the pages of the
+    requested range writable; they are copy-on-write and may be modified
+    without affecting the file. Modified pages are private copies of the file
+    contents, thus they are wiped before the file is unmapped. The writable
+    pages are tracked individually, and on Linux only those that have
+    actually been copied are wiped. Read-only use never copies the pages.
+
+    With lock_pages the mapping is locked into physical memory so that the
+    private copies are never written to swap. This loads the whole file
+    upfront, and the pages made writable are copied right away. Failures to
+    lock the memory, e.g. due to RLIMIT_MEMLOCK, are ignored; is_locked()
+    reports whether locking succeeded. With prefetch the kernel is asked to
+    start reading the whole file in the background.
+*/
+class mapped_buffer {
+public:
+    typedef std::uint8_t value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const value_type& reference;
+    typedef const value_type& const_reference;
+    typedef const value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef const value_type* iterator;
+    typedef const value_type* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    enum options {
+        lock_pages = 1,
+        prefetch = 2
+    };
+
+    mapped_buffer() noexcept :
+        data_(nullptr), size_(0), locked_(false)
+    {}
+
+    explicit mapped_buffer(const char* path, unsigned opts = 0) :
+        mapped_buffer()
+    {
+        open(path, opts);
+    }
+
+    explicit mapped_buffer(const std::string& path, unsigned opts = 0) :
+        mapped_buffer(path.c_str(), opts)
+    {}
+
+    mapped_buffer(const mapped_buffer&) = delete;
+    mapped_buffer& operator=(const mapped_buffer&) = delete;
+
+    mapped_buffer(mapped_buffer&& other) noexcept :
+        mapped_buffer()
+    {
+        swap(other);
+    }
+
+    mapped_buffer& operator=(mapped_buffer&& other) noexcept
+    {
+        if (this != &other) {
+            close();
+            swap(other);
+        }
+        return *this;
+    }
+
+    ~mapped_buffer() noexcept
+    {
+        close();
+    }
+
+    void swap(mapped_buffer& other) noexcept
+    {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        writable_.swap(other.writable_);
+        std::swap(locked_, other.locked_);
+    }
+
+    /*  Maps the file at the given path, replacing the current mapping.
+        std::system_error is thrown if the file can't be opened or mapped.
+    */
+    void open(const char* path, unsigned opts = 0)
+    {
+        close();
+
+        int flags = O_RDONLY;
+#ifdef O_CLOEXEC
+        flags |= O_CLOEXEC;
+#endif
+        int fd;
+        do {
+            fd = ::open(path, flags);
+        } while (fd < 0 && errno == EINTR);
+        if (fd < 0)
+            throw_error(errno, path);
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            int error = errno;
+            ::close(fd);
+            throw_error(error, path);
+        }
+        if (st.st_size == 0) {
+            ::close(fd);
+            return;
+        }
+
+        // Pages are made writable on request. Locking a writable private
+        // mapping would copy all of it.
+        void* addr = ::mmap(nullptr, std::size_t(st.st_size), PROT_READ,
+                            MAP_PRIVATE, fd, 0);
+        int error = errno;
+        // the mapping keeps a reference to the file
+        ::close(fd);
+        if (addr == MAP_FAILED)
+            throw_error(error, path);
+
+        data_ = static_cast<value_type*>(addr);
+        size_ = std::size_t(st.st_size);
+        if (opts & prefetch)
+            ::madvise(addr, size_, MADV_WILLNEED);
+        if (opts & lock_pages)
+            locked_ = ::mlock(addr, size_) == 0;
+    }
+
+    void open(const std::string& path, unsigned opts = 0)
+    {
+        open(path.c_str(), opts);
+    }
+
+    // Unmaps the file. The pages that may have been modified are wiped first.
+    void close() noexcept
+    {
+        if (data_ == nullptr)
+            return;
+        wipe_writable_pages();
+        if (locked_)
+            ::munlock(data_, size_);
+        ::munmap(data_, size_);
+        data_ = nullptr;
+        size_ = 0;
+        vector<std::uint64_t>().swap(writable_);
+        locked_ = false;
+    }
+
+    bool is_open() const noexcept { return data_ != nullptr; }
+    bool is_locked() const noexcept { return locked_; }
+
+    const_reference at(size_type pos) const
+    {
+        if (pos >= size())
+            throw std::out_of_range("pos >= size()");
+        return data_[pos];
+    }
+
+    const_reference operator[](size_type pos) const { return data_[pos]; }
+    const_reference front() const { return data_[0]; }
+    const_reference back() const { return data_[size_ - 1]; }
+
+    const_pointer data() const noexcept { return data_; }
+
+    /*  Returns a writable pointer to the private copy of the file contents.
+        The second overload makes only the pages of [pos, pos + count)
+        writable; writing outside them is an access violation. Only the pages
+        that have been made writable are wiped when the file is unmapped.
+        std::system_error is thrown if the pages can't be made writable.
+    */
+    value_type* mutable_data()
+    {
+        return mutable_data(0, size_);
+    }
+
+    value_type* mutable_data(size_type pos, size_type count)
+    {
+        if (pos > size())
+            throw std::out_of_range("pos > size()");
+        count = std::min(count, size_ - pos);
+        if (count > 0)
+            make_writable(pos / page_size(), (pos + count - 1) / page_size() + 1);
+        return data_ + pos;
+    }
+
+    const_iterator begin() const noexcept { return data_; }
+    const_iterator cbegin() const noexcept { return data_; }
+    const_iterator end() const noexcept { return data_ + size_; }
+    const_iterator cend() const noexcept { return data_ + size_; }
+
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+private:
+    [[noreturn]] static void throw_error(int error, const char* path)
+    {
+        throw std::system_error(error, std::generic_category(),
+                                std::string("tidy::mapped_buffer: ") + path);
+    }
+
+    static std::size_t page_size() noexcept
+    {
+        static const std::size_t size = std::size_t(::sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    std::size_t page_count() const noexcept
+    {
+        return (size_ + page_size() - 1) / page_size();
+    }
+
+    bool is_writable(std::size_t page) const noexcept
+    {
+        return !writable_.empty() && (writable_[page / 64] >> (page % 64)) & 1;
+    }
+
+    // Makes the pages [first, last) writable
+    void make_writable(std::size_t first, std::size_t last)
+    {
+        if (writable_.empty())
+            writable_.resize((page_count() + 63) / 64);
+
+        std::size_t page = first;
+        while (page < last) {
+            if (is_writable(page)) {
+                ++page;
+                continue;
+            }
+            std::size_t run_end = page + 1;
+            while (run_end < last && !is_writable(run_end))
+                ++run_end;
+            if (::mprotect(data_ + page * page_size(), (run_end - page) * page_size(),
+                           PROT_READ | PROT_WRITE) != 0) {
+                throw std::system_error(errno, std::generic_category(),
+                                        "tidy::mapped_buffer: mprotect");
+            }
+            for (; page < run_end; ++page)
+                writable_[page / 64] |= std::uint64_t(1) << (page % 64);
+        }
+    }
+
+    void wipe_writable_pages() noexcept
+    {
+        if (writable_.empty())
+            return;
+        int pagemap = open_pagemap();
+        std::size_t pages = page_count();
+        std::size_t page = 0;
+        while (page < pages) {
+            if (!is_writable(page)) {
+                ++page;
+                continue;
+            }
+            std::size_t run_end = page + 1;
+            while (run_end < pages && is_writable(run_end))
+                ++run_end;
+            wipe_pages(page, run_end, pagemap);
+            page = run_end;
+        }
+        if (pagemap >= 0)
+            ::close(pagemap);
+    }
+
+    // Wipes the pages [first, last) that hold private copies. Without
+    // pagemap all of them are wiped.
+    void wipe_pages(std::size_t first, std::size_t last, int pagemap) noexcept
+    {
+        const std::size_t batch = 512;
+        std::uint64_t entries[batch];
+        for (std::size_t page = first; page < last; page += batch) {
+            std::size_t count = std::min(batch, last - page);
+            bool known = read_pagemap(pagemap, page, count, entries);
+            for (std::size_t i = 0; i < count; ++i) {
+                if (known && !is_private_copy(entries[i]))
+                    continue;
+                std::size_t pos = (page + i) * page_size();
+                detail::secure_delete(data_ + pos, std::min(page_size(), size_ - pos));
+            }
+        }
+    }
+
+#ifdef __linux__
+    static int open_pagemap() noexcept
+    {
+        int fd;
+        do {
+            fd = ::open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+        } while (fd < 0 && errno == EINTR);
+        return fd;
+    }
+
+    // Reads the pagemap entries of count pages starting at the given page
+    bool read_pagemap(int pagemap, std::size_t page, std::size_t count,
+                      std::uint64_t* entries) const noexcept
+    {
+        if (pagemap < 0)
+            return false;
+        std::uintptr_t index = reinterpret_cast<std::uintptr_t>(data_) / page_size() + page;
+        char* out = reinterpret_cast<char*>(entries);
+        std::size_t left = count * sizeof(std::uint64_t);
+        off_t offset = off_t(index * sizeof(std::uint64_t));
+        while (left > 0) {
+            ssize_t r = ::pread(pagemap, out, left, offset);
+            if (r < 0 && errno == EINTR)
+                continue;
+            if (r <= 0)
+                return false;
+            out += r;
+            left -= std::size_t(r);
+            offset += r;
+        }
+        return true;
+    }
+
+    // A page that is present or swapped and is not backed by the file
+    static bool is_private_copy(std::uint64_t entry) noexcept
+    {
+        const std::uint64_t present = std::uint64_t(1) << 63;
+        const std::uint64_t swapped = std::uint64_t(1) << 62;
+        const std::uint64_t file_page = std::uint64_t(1) << 61;
+        return (entry & (present | swapped)) != 0 && (entry & file_page) == 0;
+    }
+#else
+    static int open_pagemap() noexcept { return -1; }
+
+    bool read_pagemap(int, std::size_t, std::size_t, std::uint64_t*) const noexcept
+    {
+        return false;
+    }
+
+    static bool is_private_copy(std::uint64_t) noexcept { return true; }
+#endif
+
+    value_type* data_;
+    std::size_t size_;
+    // one bit per page that has been made writable
+    vector<std::uint64_t> writable_;
+    bool locked_;
+};
+
+inline void swap(mapped_buffer& lhs, mapped_buffer& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace tidy
+
+#endif
@@ -0,0 +1,714 @@
+/*  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+
+    Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+            http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef TIDY_TIDYSMALLVECTOR_H
+#define TIDY_TIDYSMALLVECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include "tidyvector.h"
+
+namespace tidy {
+
+/*  A vector class that stores up to N elements within the object itself and
+    does not leak information to memory. That is, upon destruction, no traces
+    of the contents of the vector can be found in memory regardless of
+    operations that are applied to the vector.
+
+    The elements are moved to storage obtained from the allocator only when
+    the size exceeds N. The storage that is no longer used is wiped before
+    it's released. The storage past the last element is kept wiped at all
+    times, thus only the elements need to be wiped on destruction.
+
+    Only trivial types are supported.
+*/
+template<class T, std::size_t N, class Allocator = std::allocator<T>>
+class small_vector {
+    using alloc_traits = std::allocator_traits<Allocator>;
+public:
+    static_assert(std::is_trivial<T>::value,
+                  "Only trivial types are supported");
+    static_assert(N > 0, "The inline capacity must be nonzero");
+
+    typedef T value_type;
+    typedef Allocator allocator_type;
+    typedef typename alloc_traits::size_type size_type;
+    typedef typename alloc_traits::difference_type difference_type;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef typename alloc_traits::pointer pointer;
+    typedef typename alloc_traits::const_pointer const_pointer;
+    typedef value_type* iterator;
+    typedef const value_type* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    static const size_type inline_capacity = N;
+
+    small_vector() noexcept(std::is_nothrow_default_constructible<Allocator>::value) :
+        begin_(inline_data()), size_(0), capacity_(N)
+    {}
+
+    explicit small_vector(const Allocator& alloc) noexcept :
+        alloc_(alloc), begin_(inline_data()), size_(0), capacity_(N)
+    {}
+
+    small_vector(size_type count, const T& value) : small_vector()
+    {
+        resize(count, value);
+    }
+
+    small_vector(size_type count, const T& value,
+                 const Allocator& alloc) :
+        small_vector(alloc)
+    {
+        resize(count, value);
+    }
+
+    explicit small_vector(size_type n) : small_vector()
+    {
+        resize(n);
+    }
+
+    explicit small_vector(size_type n, const Allocator& alloc) :
+        small_vector(alloc)
+    {
+        resize(n);
+    }
+
+    template<class InputIt, class = typename std::enable_if<
+                 detail::is_input_iterator<InputIt>::value>::type>
+    small_vector(InputIt first, InputIt last) : small_vector()
+    {
+        assign(first, last);
+    }
+
+    template<class InputIt, class = typename std::enable_if<
+                 detail::is_input_iterator<InputIt>::value>::type>
+    small_vector(InputIt first, InputIt last,
+                 const Allocator& alloc) :
+        small_vector(alloc)
+    {
+        assign(first, last);
+    }
+
+    small_vector(const small_vector& other) :
+        small_vector(alloc_traits::select_on_container_copy_construction(other.alloc_))
+    {
+        assign(other.begin(), other.end());
+    }
+
+    small_vector(const small_vector& other, const Allocator& alloc) :
+        small_vector(alloc)
+    {
+        assign(other.begin(), other.end());
+    }
+
+    small_vector(small_vector&& other) noexcept :
+        small_vector(std::move(other.alloc_))
+    {
+        steal(other);
+    }
+
+    small_vector(small_vector&& other, const Allocator& alloc) :
+        small_vector(alloc)
+    {
+        if (alloc_ == other.alloc_) {
+            steal(other);
+        } else {
+            assign(other.begin(), other.end());
+            other.release_storage();
+        }
+    }
+
+    small_vector(std::initializer_list<T> init) : small_vector()
+    {
+        assign(init);
+    }
+
+    small_vector(std::initializer_list<T> init,
+                 const Allocator& alloc) :
+        small_vector(alloc)
+    {
+        assign(init);
+    }
+
+    ~small_vector() noexcept
+    {
+        release_storage();
+    }
+
+    small_vector& operator=(const small_vector& other)
+    {
+        if (this != &other) {
+            if (alloc_traits::propagate_on_container_copy_assignment::value) {
+                // the storage must be released by the allocator it came from
+                if (alloc_ != other.alloc_)
+                    release_storage();
+                alloc_ = other.alloc_;
+            }
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other)
+        noexcept(detail::is_nothrow_move_assignable_alloc<Allocator>::value)
+    {
+        if (this != &other) {
+            release_storage();
+            move_assign(other, typename alloc_traits::propagate_on_container_move_assignment());
+        }
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<T> ilist)
+    {
+        assign(ilist);
+        return *this;
+    }
+
+    void assign(size_type count, const value_type& value)
+    {
+        value_type copy = value;
+        clear();
+        resize(count, copy);
+    }
+
+    template<class InputIt>
+    typename std::enable_if<
+        detail::is_input_iterator<InputIt>::value && !detail::is_forward_iterator<InputIt>::value,
+        void
+    >::type
+        assign(InputIt first, InputIt last)
+    {
+        clear();
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+
+    template<class ForwardIt>
+    typename std::enable_if<
+        detail::is_forward_iterator<ForwardIt>::value,
+        void
+    >::type
+        assign(ForwardIt first, ForwardIt last)
+    {
+        clear();
+        size_type count = std::distance(first, last);
+        reserve(count);
+        std::copy(first, last, begin_);
+        size_ = count;
+    }
+
+    void assign(std::initializer_list<T> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    allocator_type get_allocator() const noexcept { return alloc_; }
+
+    // element access
+    reference at(size_type n)
+    {
+        if (n >= size())
+            throw std::out_of_range("n >= size()");
+        return begin_[n];
+    }
+
+    const_reference at(size_type n) const
+    {
+        if (n >= size())
+            throw std::out_of_range("n >= size()");
+        return begin_[n];
+    }
+
+    reference       operator[](size_type n) noexcept { return begin_[n]; }
+    const_reference operator[](size_type n) const noexcept { return begin_[n]; }
+
+    reference       front() noexcept { return begin_[0]; }
+    const_reference front() const noexcept { return begin_[0]; }
+    reference       back() noexcept { return begin_[size_ - 1]; }
+    const_reference back() const noexcept { return begin_[size_ - 1]; }
+    value_type*       data() noexcept { return begin_; }
+    const value_type* data() const noexcept { return begin_; }
+
+    // iterators
+    iterator begin() noexcept { return begin_; }
+    const_iterator begin() const noexcept { return begin_; }
+    iterator end() noexcept { return begin_ + size_; }
+    const_iterator end() const noexcept { return begin_ + size_; }
+
+    reverse_iterator       rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator         cbegin() const noexcept { return begin(); }
+    const_iterator         cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // capacity
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type max_size() const noexcept { return alloc_traits::max_size(alloc_); }
+    void reserve(size_type n)
+    {
+        if (n > max_size())
+            throw std::length_error("n > max_size()");
+        if (n <= capacity())
+            return;
+        reallocate(n);
+    }
+
+    size_type capacity() const noexcept { return capacity_; }
+
+    // Returns whether the elements are stored within the object itself
+    bool is_inline() const noexcept { return begin_ == inline_data(); }
+
+    void shrink_to_fit()
+    {
+        if (is_inline())
+            return;
+        // the request is non-binding, thus allocation failures are ignored
+        try {
+            reallocate(size());
+        } catch (...) {
+        }
+    }
+
+    void clear() noexcept
+    {
+        detail::secure_delete_range(begin_, begin_ + size_);
+        size_ = 0;
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+        return insert(pos, 1, value);
+    }
+
+    iterator insert(const_iterator pos, T&& value)
+    {
+        return insert(pos, 1, value);
+    }
+
+    iterator insert(const_iterator pos, size_type count, const T& value)
+    {
+        // value may refer to an element of this vector
+        value_type copy = value;
+        iterator p = make_gap(pos, count);
+        std::fill_n(p, count, copy);
+        return p;
+    }
+
+    template<class InputIt>
+    typename std::enable_if<
+        detail::is_input_iterator<InputIt>::value && !detail::is_forward_iterator<InputIt>::value,
+        iterator
+    >::type
+        insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        difference_type index = pos - cbegin();
+        if (index == difference_type(size_)) {
+            for (; first != last; ++first)
+                push_back(*first);
+            return begin_ + index;
+        }
+        // Collect the elements first so that the tail is moved only once
+        // The buffer uses the same allocator, thus it never allocates when
+        // the vector itself can't
+        small_vector<value_type, N, Allocator> buffer(alloc_);
+        for (; first != last; ++first)
+            buffer.push_back(*first);
+        return insert(begin_ + index, buffer.begin(), buffer.end());
+    }
+
+    template<class ForwardIt>
+    typename std::enable_if<
+        detail::is_forward_iterator<ForwardIt>::value,
+        iterator
+    >::type
+        insert(const_iterator pos, ForwardIt first, ForwardIt last)
+    {
+        iterator p = make_gap(pos, std::distance(first, last));
+        std::copy(first, last, p);
+        return p;
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> ilist)
+    {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    template<class... Args>
+    iterator emplace(const_iterator pos, Args&& ... args)
+    {
+        value_type temp(std::forward<Args>(args)...);
+        return insert(pos, 1, temp);
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        iterator p = begin_ + (first - cbegin());
+        size_type count = last - first;
+        if (count > 0) {
+            std::memmove(p, p + count, (end() - (p + count)) * sizeof(value_type));
+            size_ -= count;
+            detail::secure_delete_range(end(), end() + count);
+        }
+        return p;
+    }
+
+    void push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value)
+    {
+        emplace_back(value);
+    }
+
+    template<class... Args>
+    void emplace_back(Args&& ... args)
+    {
+        if (size_ == capacity_) {
+            // args may refer to an element of this vector
+            value_type temp(std::forward<Args>(args)...);
+            reserve_grow(size_ + 1);
+            begin_[size_] = temp;
+        } else {
+            ::new(static_cast<void*>(begin_ + size_)) value_type(std::forward<Args>(args)...);
+        }
+        ++size_;
+    }
+
+    void pop_back()
+    {
+        --size_;
+        detail::secure_delete_range(end(), end() + 1);
+    }
+
+    void resize(size_type count)
+    {
+        resize(count, value_type());
+    }
+
+    void resize(size_type count, const value_type& value)
+    {
+        if (count > max_size())
+            throw std::length_error("count > max_size()");
+        if (count < size()) {
+            detail::secure_delete_range(begin_ + count, end());
+            size_ = count;
+        } else {
+            value_type copy = value;
+            reserve_grow(count);
+            std::fill(end(), begin_ + count, copy);
+            size_ = count;
+        }
+    }
+
+    void swap(small_vector& other) noexcept
+    {
+        if (this == &other)
+            return;
+        if (alloc_traits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        }
+
+        if (!is_inline() && !other.is_inline()) {
+            std::swap(begin_, other.begin_);
+            std::swap(size_, other.size_);
+            std::swap(capacity_, other.capacity_);
+            return;
+        }
+        if (is_inline() && other.is_inline()) {
+            swap_inline(other);
+            return;
+        }
+        if (is_inline())
+            other.swap_heap_with_inline(*this);
+        else
+            swap_heap_with_inline(other);
+    }
+
+    // dummy function that aids compatibility with libcxx tests
+    bool __invariants() const
+    {
+        if (size_ > capacity_)
+            return false;
+        return is_inline() == (capacity_ == N);
+    }
+
+private:
+
+    value_type* inline_data() noexcept
+    {
+        return reinterpret_cast<value_type*>(&inline_);
+    }
+
+    const value_type* inline_data() const noexcept
+    {
+        return reinterpret_cast<const value_type*>(&inline_);
+    }
+
+    // Takes over the elements of other. This vector must not have elements
+    // and must use the inline storage.
+    void steal(small_vector& other) noexcept
+    {
+        if (other.is_inline()) {
+            std::memcpy(begin_, other.begin_, other.size_ * sizeof(value_type));
+            size_ = other.size_;
+            other.clear();
+            return;
+        }
+        begin_ = other.begin_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        other.begin_ = other.inline_data();
+        other.size_ = 0;
+        other.capacity_ = N;
+    }
+
+    void move_assign(small_vector& other, std::true_type /*propagate*/) noexcept
+    {
+        alloc_ = std::move(other.alloc_);
+        steal(other);
+    }
+
+    void move_assign(small_vector& other, std::false_type /*propagate*/)
+    {
+        if (alloc_ == other.alloc_) {
+            steal(other);
+        } else {
+            assign(other.begin(), other.end());
+            other.release_storage();
+        }
+    }
+
+    // Swaps elements when both vectors use the inline storage
+    void swap_inline(small_vector& other) noexcept
+    {
+        small_vector* shorter = this;
+        small_vector* longer = &other;
+        if (shorter->size_ > longer->size_)
+            std::swap(shorter, longer);
+
+        size_type common = shorter->size_;
+        size_type extra = longer->size_ - common;
+        std::swap_ranges(shorter->begin_, shorter->begin_ + common, longer->begin_);
+        std::memcpy(shorter->begin_ + common, longer->begin_ + common,
+                    extra * sizeof(value_type));
+        detail::secure_delete_range(longer->begin_ + common, longer->end());
+        std::swap(shorter->size_, longer->size_);
+    }
+
+    // Swaps elements when this vector uses the allocated storage and the
+    // other one uses the inline storage
+    void swap_heap_with_inline(small_vector& other) noexcept
+    {
+        value_type* heap = begin_;
+        size_type heap_size = size_;
+        size_type heap_capacity = capacity_;
+
+        begin_ = inline_data();
+        capacity_ = N;
+        std::memcpy(begin_, other.begin_, other.size_ * sizeof(value_type));
+        size_ = other.size_;
+        other.clear();
+
+        other.begin_ = heap;
+        other.size_ = heap_size;
+        other.capacity_ = heap_capacity;
+    }
+
+    // Wipes the elements and releases the allocated storage, if any
+    void release_storage() noexcept
+    {
+        clear();
+        if (!is_inline())
+            deallocate(begin_, capacity_);
+        begin_ = inline_data();
+        capacity_ = N;
+    }
+
+    value_type* allocate(size_type n)
+    {
+        pointer p = alloc_traits::allocate(alloc_, n);
+        return std::addressof(*p);
+    }
+
+    void deallocate(value_type* p, size_type n) noexcept
+    {
+        alloc_traits::deallocate(alloc_, std::pointer_traits<pointer>::pointer_to(*p), n);
+    }
+
+    // Moves the elements starting at pos by count positions towards the end.
+    // Returns iterator to the first element of the gap.
+    iterator make_gap(const_iterator pos, size_type count)
+    {
+        difference_type index = pos - cbegin();
+        size_type tail = size_ - index;
+        if (size_ + count > capacity()) {
+            // copy both parts directly to their final locations in the new
+            // storage
+            size_type new_capacity = grow_capacity(size_ + count);
+            value_type* p = allocate(new_capacity);
+            std::memcpy(p, begin_, index * sizeof(value_type));
+            std::memcpy(p + index + count, begin_ + index, tail * sizeof(value_type));
+            detail::secure_delete_range(begin_, begin_ + size_);
+            if (!is_inline())
+                deallocate(begin_, capacity_);
+            begin_ = p;
+            capacity_ = new_capacity;
+        } else {
+            std::memmove(begin_ + index + count, begin_ + index, tail * sizeof(value_type));
+        }
+        size_ += count;
+        return begin_ + index;
+    }
+
+    // We can't use reserve() when growing container, because it will allocate
+    // absolute minimum space.
+    void reserve_grow(size_type size)
+    {
+        if (size <= capacity())
+            return;
+        reallocate(grow_capacity(size));
+    }
+
+    // Returns the capacity to allocate when the size grows to the given value
+    size_type grow_capacity(size_type size) const
+    {
+        if (size > max_size())
+            throw std::length_error("size > max_size()");
+        return std::max(2 * capacity(), size);
+    }
+
+    void reallocate(size_type new_capacity)
+    {
+        if (new_capacity <= N) {
+            if (is_inline())
+                return;
+            // move back to the inline storage
+            value_type* old = begin_;
+            size_type old_capacity = capacity_;
+            std::memcpy(inline_data(), old, size_ * sizeof(value_type));
+            detail::secure_delete_range(old, old + size_);
+            deallocate(old, old_capacity);
+            begin_ = inline_data();
+            capacity_ = N;
+            return;
+        }
+
+        value_type* p = allocate(new_capacity);
+        std::memcpy(p, begin_, size_ * sizeof(value_type));
+        detail::secure_delete_range(begin_, begin_ + size_);
+        if (!is_inline())
+            deallocate(begin_, capacity_);
+        begin_ = p;
+        capacity_ = new_capacity;
+    }
+
+    Allocator alloc_;
+    value_type* begin_;
+    size_type size_;
+    size_type capacity_;
+    typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type inline_;
+};
+
+template<class T, std::size_t N, class Alloc>
+const typename small_vector<T, N, Alloc>::size_type small_vector<T, N, Alloc>::inline_capacity;
+
+template<class T, std::size_t N, class Alloc>
+bool operator==(const small_vector<T, N, Alloc>& lhs,
+                const small_vector<T, N, Alloc>& rhs)
+{
+    return lhs.size() == rhs.size() &&
+            std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template<class T, std::size_t N, class Alloc>
+bool operator!=(const small_vector<T, N, Alloc>& lhs,
+                const small_vector<T, N, Alloc>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template<class T, std::size_t N, class Alloc>
+bool operator<(const small_vector<T, N, Alloc>& lhs,
+               const small_vector<T, N, Alloc>& rhs)
+{
+    return std::lexicographical_compare(lhs.begin(), lhs.end(),
+                                        rhs.begin(), rhs.end());
+}
+
+template<class T, std::size_t N, class Alloc>
+bool operator<=(const small_vector<T, N, Alloc>& lhs,
+                const small_vector<T, N, Alloc>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template<class T, std::size_t N, class Alloc>
+bool operator>(const small_vector<T, N, Alloc>& lhs,
+               const small_vector<T, N, Alloc>& rhs)
+{
+    return rhs < lhs;
+}
+
+template<class T, std::size_t N, class Alloc>
+bool operator>=(const small_vector<T, N, Alloc>& lhs,
+                const small_vector<T, N, Alloc>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+template<class T, std::size_t N, class Alloc>
+void swap(small_vector<T, N, Alloc>& lhs, small_vector<T, N, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+template<class T, std::size_t N, class Alloc, class U>
+typename small_vector<T, N, Alloc>::size_type
+    erase(small_vector<T, N, Alloc>& c, const U& value)
+{
+    auto it = std::remove(c.begin(), c.end(), value);
+    auto count = c.end() - it;
+    c.erase(it, c.end());
+    return count;
+}
+
+template<class T, std::size_t N, class Alloc, class Pred>
+typename small_vector<T, N, Alloc>::size_type
+    erase_if(small_vector<T, N, Alloc>& c, Pred pred)
+{
+    auto it = std::remove_if(c.begin(), c.end(), pred);
+    auto count = c.end() - it;
+    c.erase(it, c.end());
+    return count;
+}
+
+} // namespace tidy
+
+#endif
@@ -0,0 +1,306 @@
+/*  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+
+    Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+            http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef TIDY_TIDYSPLIT_H
+#define TIDY_TIDYSPLIT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "tidystring.h"
+
+namespace tidy {
+
+/*  A read-only view of a range of characters in a string that is owned
+    elsewhere, as returned by tidy::split. The view must not outlive the
+    string. to_owned() copies the characters into a new tidy::basic_string.
+
+    In C++17 and later the slice converts implicitly to std::basic_string_view.
+*/
+template<class CharT, class Traits = std::char_traits<CharT>>
+class basic_string_slice {
+public:
+    typedef Traits traits_type;
+    typedef CharT value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const CharT* const_pointer;
+    typedef const CharT& const_reference;
+    typedef const CharT* const_iterator;
+    typedef const_iterator iterator;
+
+    basic_string_slice() noexcept : data_(nullptr), size_(0) {}
+    basic_string_slice(const CharT* s, size_type count) noexcept : data_(s), size_(count) {}
+
+    const_iterator begin() const noexcept { return data_; }
+    const_iterator end() const noexcept { return data_ + size_; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    const CharT* data() const noexcept { return data_; }
+    size_type size() const noexcept { return size_; }
+    size_type length() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    const_reference operator[](size_type pos) const noexcept { return data_[pos]; }
+    const_reference front() const noexcept { return data_[0]; }
+    const_reference back() const noexcept { return data_[size_ - 1]; }
+
+    const_reference at(size_type pos) const
+    {
+        if (pos >= size_)
+            throw std::out_of_range("pos >= size()");
+        return data_[pos];
+    }
+
+    int compare(basic_string_slice other) const noexcept
+    {
+        int ret = traits_type::compare(data_, other.data_, std::min(size_, other.size_));
+        if (ret == 0) {
+            if (size_ < other.size_)
+                return -1;
+            if (size_ > other.size_)
+                return 1;
+        }
+        return ret;
+    }
+
+    int compare(const CharT* s) const noexcept
+    {
+        return compare(basic_string_slice(s, traits_type::length(s)));
+    }
+
+    template<class Alloc>
+    int compare(const basic_string<CharT, Traits, Alloc>& str) const noexcept
+    {
+        return compare(basic_string_slice(str.data(), str.size()));
+    }
+
+    // Copies the characters into a new string
+    template<class Alloc = std::allocator<CharT>>
+    basic_string<CharT, Traits, Alloc> to_owned(const Alloc& alloc = Alloc()) const
+    {
+        return basic_string<CharT, Traits, Alloc>(data_, size_, alloc);
+    }
+
+#if TIDY_HAS_STRING_VIEW
+    operator std::basic_string_view<CharT, Traits>() const noexcept
+    {
+        return std::basic_string_view<CharT, Traits>(data_, size_);
+    }
+#endif
+
+private:
+    const CharT* data_;
+    size_type size_;
+};
+
+using string_slice = basic_string_slice<char>;
+using wstring_slice = basic_string_slice<wchar_t>;
+using u16string_slice = basic_string_slice<char16_t>;
+using u32string_slice = basic_string_slice<char32_t>;
+
+template<class CharT, class Traits>
+bool operator==(basic_string_slice<CharT, Traits> lhs, basic_string_slice<CharT, Traits> rhs)
+{
+    return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+}
+
+template<class CharT, class Traits>
+bool operator!=(basic_string_slice<CharT, Traits> lhs, basic_string_slice<CharT, Traits> rhs)
+{
+    return !(lhs == rhs);
+}
+
+template<class CharT, class Traits>
+bool operator==(basic_string_slice<CharT, Traits> lhs, const CharT* rhs)
+{
+    return lhs.compare(rhs) == 0;
+}
+
+template<class CharT, class Traits>
+bool operator!=(basic_string_slice<CharT, Traits> lhs, const CharT* rhs)
+{
+    return lhs.compare(rhs) != 0;
+}
+
+template<class CharT, class Traits>
+bool operator==(const CharT* lhs, basic_string_slice<CharT, Traits> rhs)
+{
+    return rhs.compare(lhs) == 0;
+}
+
+template<class CharT, class Traits>
+bool operator!=(const CharT* lhs, basic_string_slice<CharT, Traits> rhs)
+{
+    return rhs.compare(lhs) != 0;
+}
+
+template<class CharT, class Traits, class Alloc>
+bool operator==(basic_string_slice<CharT, Traits> lhs,
+                const basic_string<CharT, Traits, Alloc>& rhs)
+{
+    return lhs.compare(rhs) == 0;
+}
+
+template<class CharT, class Traits, class Alloc>
+bool operator!=(basic_string_slice<CharT, Traits> lhs,
+                const basic_string<CharT, Traits, Alloc>& rhs)
+{
+    return lhs.compare(rhs) != 0;
+}
+
+template<class CharT, class Traits, class Alloc>
+bool operator==(const basic_string<CharT, Traits, Alloc>& lhs,
+                basic_string_slice<CharT, Traits> rhs)
+{
+    return rhs.compare(lhs) == 0;
+}
+
+template<class CharT, class Traits, class Alloc>
+bool operator!=(const basic_string<CharT, Traits, Alloc>& lhs,
+                basic_string_slice<CharT, Traits> rhs)
+{
+    return rhs.compare(lhs) != 0;
+}
+
+/*  A lazy range of the pieces of a string separated by any of a set of
+    delimiter characters, as returned by tidy::split. The pieces are slices
+    of the original string; nothing is allocated or copied. The range refers
+    to the string and to the delimiters, which must outlive it.
+
+    Adjacent delimiters produce empty pieces, and so do delimiters at the
+    start and at the end of the string. An empty string produces a single
+    empty piece.
+*/
+template<class CharT, class Traits = std::char_traits<CharT>>
+class basic_split_range {
+public:
+    typedef basic_string_slice<CharT, Traits> value_type;
+
+    class iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef basic_string_slice<CharT, Traits> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type* pointer;
+        typedef const value_type& reference;
+
+        iterator() noexcept : last_(nullptr), done_(true) {}
+
+        reference operator*() const noexcept { return piece_; }
+        pointer operator->() const noexcept { return &piece_; }
+
+        iterator& operator++()
+        {
+            const CharT* next = piece_.data() + piece_.size();
+            if (next == last_)
+                done_ = true;
+            else
+                find_piece(next + 1);
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) noexcept
+        {
+            if (a.done_ || b.done_)
+                return a.done_ == b.done_;
+            return a.piece_.data() == b.piece_.data();
+        }
+
+        friend bool operator!=(const iterator& a, const iterator& b) noexcept
+        {
+            return !(a == b);
+        }
+
+    private:
+        friend class basic_split_range;
+
+        iterator(const CharT* first, const CharT* last,
+                 const detail::char_set<CharT, Traits>& delims) :
+            last_(last), delims_(delims), done_(false)
+        {
+            find_piece(first);
+        }
+
+        void find_piece(const CharT* start)
+        {
+            const CharT* end = delims_.find_in(start, last_);
+            piece_ = value_type(start, end - start);
+        }
+
+        // The iterator doesn't refer to the range, so it stays valid after a
+        // temporary range is destroyed
+        value_type piece_;
+        const CharT* last_;
+        detail::char_set<CharT, Traits> delims_;
+        bool done_;
+    };
+
+    typedef iterator const_iterator;
+
+    basic_split_range(const CharT* first, const CharT* last,
+                      const CharT* delims, std::size_t delims_count) :
+        first_(first), last_(last), delims_(delims, delims_count)
+    {}
+
+    iterator begin() const { return iterator(first_, last_, delims_); }
+    iterator end() const noexcept { return iterator(); }
+
+private:
+    const CharT* first_;
+    const CharT* last_;
+    detail::char_set<CharT, Traits> delims_;
+};
+
+/*  Splits the string at each occurrence of any of the characters in delims.
+    Returns a range of slices of the string that is evaluated lazily and
+    does not allocate. Both the string and delims must outlive the range and
+    the slices. Use to_owned() on a slice to keep a copy.
+*/
+template<class CharT, class Traits, class Alloc>
+basic_split_range<CharT, Traits>
+    split(const basic_string<CharT, Traits, Alloc>& str, const CharT* delims)
+{
+    return basic_split_range<CharT, Traits>(str.data(), str.data() + str.size(),
+                                            delims, Traits::length(delims));
+}
+
+template<class CharT, class Traits, class Alloc>
+basic_split_range<CharT, Traits>
+    split(const basic_string<CharT, Traits, Alloc>& str,
+          const basic_string<CharT, Traits, Alloc>& delims)
+{
+    return basic_split_range<CharT, Traits>(str.data(), str.data() + str.size(),
+                                            delims.data(), delims.size());
+}
+
+template<class CharT, class Traits>
+basic_split_range<CharT, Traits>
+    split(basic_string_slice<CharT, Traits> str, const CharT* delims)
+{
+    return basic_split_range<CharT, Traits>(str.data(), str.data() + str.size(),
+                                            delims, Traits::length(delims));
+}
+
+// The pieces would refer to a destroyed string
+template<class CharT, class Traits, class Alloc, class Delims>
+void split(basic_string<CharT, Traits, Alloc>&& str, const Delims& delims) = delete;
+
+} // namespace tidy
+
+#endif
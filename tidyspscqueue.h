@@ -0,0 +1,161 @@
+/*  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+
+    Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+            http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef TIDY_TIDYSPSCQUEUE_H
+#define TIDY_TIDYSPSCQUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "tidyvector.h"
+
+namespace tidy {
+namespace detail {
+
+static const std::size_t cache_line_size = 64;
+
+inline std::size_t round_up_to_power_of_2(std::size_t n)
+{
+    std::size_t result = 1;
+    while (result < n)
+        result *= 2;
+    return result;
+}
+
+} // namespace detail
+
+/*  A bounded wait-free queue for passing objects from a single producer
+    thread to a single consumer thread. The slots are allocated once when the
+    queue is created; pushing and popping never allocate and transfer the
+    elements by move. Once an element is popped, the slot is destroyed and
+    its memory is wiped, so that no copies of e.g. the buffer pointers of
+    tidy::vector elements remain. The remaining elements are destroyed and
+    wiped when the queue is destroyed.
+
+    The capacity is rounded up to a power of two. The indices used by the
+    producer and the consumer are kept on separate cache lines.
+*/
+template<class T>
+class spsc_queue {
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+
+    explicit spsc_queue(size_type capacity) :
+        mask_(detail::round_up_to_power_of_2(std::max<size_type>(capacity, 1)) - 1),
+        slots_(new slot[mask_ + 1]),
+        head_(0), tail_cache_(0), tail_(0), head_cache_(0)
+    {}
+
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    ~spsc_queue()
+    {
+        std::size_t tail = tail_.load(std::memory_order_acquire);
+        for (std::size_t i = head_.load(std::memory_order_relaxed); i != tail; ++i)
+            release_slot(i);
+    }
+
+    size_type capacity() const noexcept { return mask_ + 1; }
+
+    // The number of elements in the queue. The value is approximate if the
+    // queue is being modified concurrently.
+    size_type size() const noexcept
+    {
+        std::size_t head = head_.load(std::memory_order_acquire);
+        std::size_t tail = tail_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    /*  Constructs an element at the back of the queue. Returns false without
+        constructing anything if the queue is full. May only be called from
+        the producer thread.
+    */
+    template<class... Args>
+    bool try_emplace(Args&& ... args)
+    {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_)
+                return false;
+        }
+        ::new(static_cast<void*>(&slots_[tail & mask_])) T(std::forward<Args>(args)...);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(T&& value)
+    {
+        return try_emplace(std::move(value));
+    }
+
+    bool try_push(const T& value)
+    {
+        return try_emplace(value);
+    }
+
+    /*  Moves the element at the front of the queue to out and wipes its slot.
+        Returns false if the queue is empty. May only be called from the
+        consumer thread.
+    */
+    bool try_pop(T& out)
+    {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_)
+                return false;
+        }
+        out = std::move(element(head));
+        release_slot(head);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type slot;
+
+    T& element(std::size_t index)
+    {
+        return *reinterpret_cast<T*>(&slots_[index & mask_]);
+    }
+
+    void release_slot(std::size_t index)
+    {
+        element(index).~T();
+        detail::secure_delete(&slots_[index & mask_], sizeof(slot));
+    }
+
+    // The members are grouped by the thread that writes them. The padding
+    // keeps each group on separate cache lines.
+    const std::size_t mask_;
+    const std::unique_ptr<slot[]> slots_;
+    char pad0_[detail::cache_line_size];
+
+    // written by the consumer
+    std::atomic<std::size_t> head_;
+    std::size_t tail_cache_;
+    char pad1_[detail::cache_line_size];
+
+    // written by the producer
+    std::atomic<std::size_t> tail_;
+    std::size_t head_cache_;
+    char pad2_[detail::cache_line_size];
+};
+
+} // namespace tidy
+
+#endif
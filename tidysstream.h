@@ -0,0 +1,536 @@
+/*  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+
+    Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+            http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef TIDY_TIDYSSTREAM_H
+#define TIDY_TIDYSSTREAM_H
+
+#include <algorithm>
+#include <climits>
+#include <ios>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include "tidystring.h"
+
+namespace tidy {
+
+/*  A stream buffer that does not leak information to memory. It has the same
+    interface as std::basic_stringbuf, except that the contents are stored in
+    and returned as tidy::basic_string.
+
+    The buffer grows geometrically. The memory of the old buffer is wiped when
+    the contents are moved to a larger one. str() && hands out the buffer
+    without copying it.
+*/
+template<
+    class CharT,
+    class Traits = std::char_traits<CharT>,
+    class Allocator = std::allocator<CharT>
+> class basic_stringbuf : public std::basic_streambuf<CharT, Traits> {
+    using base_type = std::basic_streambuf<CharT, Traits>;
+public:
+    typedef CharT char_type;
+    typedef Traits traits_type;
+    typedef typename Traits::int_type int_type;
+    typedef typename Traits::pos_type pos_type;
+    typedef typename Traits::off_type off_type;
+    typedef Allocator allocator_type;
+    using string_type = basic_string<CharT, Traits, Allocator>;
+
+    explicit basic_stringbuf(std::ios_base::openmode which =
+                                 std::ios_base::in | std::ios_base::out) :
+        mode_(which), hm_(0)
+    {
+        init_pointers();
+    }
+
+    explicit basic_stringbuf(const string_type& s,
+                             std::ios_base::openmode which =
+                                 std::ios_base::in | std::ios_base::out) :
+        buf_(s), mode_(which), hm_(0)
+    {
+        init_pointers();
+    }
+
+    explicit basic_stringbuf(string_type&& s,
+                             std::ios_base::openmode which =
+                                 std::ios_base::in | std::ios_base::out) :
+        buf_(std::move(s)), mode_(which), hm_(0)
+    {
+        init_pointers();
+    }
+
+    basic_stringbuf(const basic_stringbuf&) = delete;
+
+    basic_stringbuf(basic_stringbuf&& other) : base_type(other)
+    {
+        take(other);
+    }
+
+    basic_stringbuf& operator=(const basic_stringbuf&) = delete;
+
+    basic_stringbuf& operator=(basic_stringbuf&& other)
+    {
+        if (this != &other) {
+            base_type::operator=(other);
+            take(other);
+        }
+        return *this;
+    }
+
+    void swap(basic_stringbuf& other)
+    {
+        basic_stringbuf temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+
+    allocator_type get_allocator() const { return buf_.get_allocator(); }
+
+    // Returns a copy of the contents
+    string_type str() const &
+    {
+        const char_type* b = buffer();
+        return string_type(b, b + high_mark(), buf_.get_allocator());
+    }
+
+    // Returns the contents without copying them. The buffer becomes empty.
+    string_type str() &&
+    {
+        size_type size = high_mark();
+        string_type result(std::move(buf_));
+        result.resize(size);
+        buf_.clear();
+        init_pointers();
+        return result;
+    }
+
+    void str(const string_type& s)
+    {
+        buf_ = s;
+        init_pointers();
+    }
+
+    void str(string_type&& s)
+    {
+        buf_ = std::move(s);
+        init_pointers();
+    }
+
+protected:
+    int_type underflow() override
+    {
+        update_high_mark();
+        if (!(mode_ & std::ios_base::in))
+            return traits_type::eof();
+        if (this->egptr() < buffer() + hm_)
+            this->setg(this->eback(), this->gptr(), buffer() + hm_);
+        if (this->gptr() < this->egptr())
+            return traits_type::to_int_type(*this->gptr());
+        return traits_type::eof();
+    }
+
+    int_type pbackfail(int_type c = traits_type::eof()) override
+    {
+        if (this->eback() == this->gptr())
+            return traits_type::eof();
+        if (traits_type::eq_int_type(c, traits_type::eof())) {
+            this->gbump(-1);
+            return traits_type::not_eof(c);
+        }
+        if ((mode_ & std::ios_base::out) ||
+            traits_type::eq(traits_type::to_char_type(c), this->gptr()[-1]))
+        {
+            this->gbump(-1);
+            *this->gptr() = traits_type::to_char_type(c);
+            return c;
+        }
+        return traits_type::eof();
+    }
+
+    int_type overflow(int_type c = traits_type::eof()) override
+    {
+        if (traits_type::eq_int_type(c, traits_type::eof()))
+            return traits_type::not_eof(c);
+        if (!(mode_ & std::ios_base::out))
+            return traits_type::eof();
+
+        if (this->pptr() == this->epptr()) {
+            update_high_mark();
+            size_type put_offset = this->pptr() - this->pbase();
+            size_type get_offset = this->gptr() - this->eback();
+            try {
+                // the storage is reallocated by tidy::basic_string, which
+                // wipes the old storage
+                buf_.resize(std::max<size_type>(2 * buf_.size(), min_buffer_size));
+                buf_.resize(buf_.capacity());
+            } catch (...) {
+                return traits_type::eof();
+            }
+            char_type* b = buffer();
+            this->setp(b, b + buf_.size());
+            pbump_by(put_offset);
+            if (mode_ & std::ios_base::in)
+                this->setg(b, b + get_offset, b + hm_);
+        }
+        *this->pptr() = traits_type::to_char_type(c);
+        this->pbump(1);
+        return c;
+    }
+
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                     std::ios_base::openmode which =
+                         std::ios_base::in | std::ios_base::out) override
+    {
+        update_high_mark();
+        bool seek_in = (which & std::ios_base::in) != 0;
+        bool seek_out = (which & std::ios_base::out) != 0;
+        if (!seek_in && !seek_out)
+            return pos_type(off_type(-1));
+        if (seek_in && seek_out && dir == std::ios_base::cur)
+            return pos_type(off_type(-1));
+        if ((seek_in && !(mode_ & std::ios_base::in)) ||
+            (seek_out && !(mode_ & std::ios_base::out)))
+        {
+            return pos_type(off_type(-1));
+        }
+
+        off_type base_offset = 0;
+        if (dir == std::ios_base::cur) {
+            base_offset = seek_in ? this->gptr() - this->eback()
+                                  : this->pptr() - this->pbase();
+        } else if (dir == std::ios_base::end) {
+            base_offset = hm_;
+        }
+        off_type new_offset = base_offset + off;
+        if (new_offset < 0 || new_offset > off_type(hm_))
+            return pos_type(off_type(-1));
+
+        char_type* b = buffer();
+        if (seek_in)
+            this->setg(b, b + new_offset, b + hm_);
+        if (seek_out) {
+            this->setp(b, b + buf_.size());
+            pbump_by(new_offset);
+        }
+        return pos_type(new_offset);
+    }
+
+    pos_type seekpos(pos_type pos,
+                     std::ios_base::openmode which =
+                         std::ios_base::in | std::ios_base::out) override
+    {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+
+private:
+    using size_type = typename string_type::size_type;
+
+    static const size_type min_buffer_size = 64;
+
+    char_type* buffer() { return buf_.empty() ? nullptr : &buf_[0]; }
+    const char_type* buffer() const { return buf_.empty() ? nullptr : &buf_[0]; }
+
+    // Returns the length of the contents. The characters written through the
+    // put area are not accounted in hm_ until update_high_mark() is called.
+    size_type high_mark() const
+    {
+        if (mode_ & std::ios_base::out)
+            return std::max<size_type>(hm_, this->pptr() - this->pbase());
+        return hm_;
+    }
+
+    void update_high_mark() { hm_ = high_mark(); }
+
+    void pbump_by(size_type n)
+    {
+        for (; n > INT_MAX; n -= INT_MAX)
+            this->pbump(INT_MAX);
+        this->pbump(int(n));
+    }
+
+    // Sets up the stream pointers after buf_ has been replaced with new
+    // contents. The unused capacity of the string becomes a part of the put
+    // area.
+    void init_pointers()
+    {
+        hm_ = buf_.size();
+        if ((mode_ & std::ios_base::out) && buf_.capacity() > buf_.size())
+            buf_.resize(buf_.capacity());
+        char_type* b = buffer();
+        this->setg(nullptr, nullptr, nullptr);
+        this->setp(nullptr, nullptr);
+        if (mode_ & std::ios_base::in)
+            this->setg(b, b, b + hm_);
+        if (mode_ & std::ios_base::out) {
+            this->setp(b, b + buf_.size());
+            if (mode_ & (std::ios_base::app | std::ios_base::ate))
+                pbump_by(hm_);
+        }
+    }
+
+    void take(basic_stringbuf& other)
+    {
+        size_type get_offset = other.gptr() - other.eback();
+        size_type get_end = other.egptr() - other.eback();
+        size_type put_offset = other.pptr() - other.pbase();
+        mode_ = other.mode_;
+        hm_ = other.high_mark();
+        buf_ = std::move(other.buf_);
+
+        char_type* b = buffer();
+        this->setg(nullptr, nullptr, nullptr);
+        this->setp(nullptr, nullptr);
+        if (mode_ & std::ios_base::in)
+            this->setg(b, b + get_offset, b + get_end);
+        if (mode_ & std::ios_base::out) {
+            this->setp(b, b + buf_.size());
+            pbump_by(put_offset);
+        }
+
+        other.buf_.clear();
+        other.init_pointers();
+    }
+
+    string_type buf_;
+    std::ios_base::openmode mode_;
+    size_type hm_;
+};
+
+template<class CharT, class Traits, class Allocator>
+const typename basic_stringbuf<CharT, Traits, Allocator>::size_type
+    basic_stringbuf<CharT, Traits, Allocator>::min_buffer_size;
+
+template<class CharT, class Traits, class Allocator>
+void swap(basic_stringbuf<CharT, Traits, Allocator>& lhs,
+          basic_stringbuf<CharT, Traits, Allocator>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+/*  Equivalents of std::basic_istringstream, std::basic_ostringstream and
+    std::basic_stringstream that use tidy::basic_stringbuf.
+*/
+template<
+    class CharT,
+    class Traits = std::char_traits<CharT>,
+    class Allocator = std::allocator<CharT>
+> class basic_istringstream : public std::basic_istream<CharT, Traits> {
+    using base_type = std::basic_istream<CharT, Traits>;
+public:
+    typedef CharT char_type;
+    typedef Traits traits_type;
+    typedef typename Traits::int_type int_type;
+    typedef typename Traits::pos_type pos_type;
+    typedef typename Traits::off_type off_type;
+    typedef Allocator allocator_type;
+    using string_type = basic_string<CharT, Traits, Allocator>;
+    using stringbuf_type = basic_stringbuf<CharT, Traits, Allocator>;
+
+    explicit basic_istringstream(std::ios_base::openmode which = std::ios_base::in) :
+        base_type(&sb_), sb_(which | std::ios_base::in)
+    {}
+
+    explicit basic_istringstream(const string_type& s,
+                                 std::ios_base::openmode which = std::ios_base::in) :
+        base_type(&sb_), sb_(s, which | std::ios_base::in)
+    {}
+
+    explicit basic_istringstream(string_type&& s,
+                                 std::ios_base::openmode which = std::ios_base::in) :
+        base_type(&sb_), sb_(std::move(s), which | std::ios_base::in)
+    {}
+
+    basic_istringstream(basic_istringstream&& other) :
+        base_type(std::move(other)), sb_(std::move(other.sb_))
+    {
+        base_type::set_rdbuf(&sb_);
+    }
+
+    basic_istringstream& operator=(basic_istringstream&& other)
+    {
+        base_type::operator=(std::move(other));
+        sb_ = std::move(other.sb_);
+        return *this;
+    }
+
+    void swap(basic_istringstream& other)
+    {
+        base_type::swap(other);
+        sb_.swap(other.sb_);
+    }
+
+    stringbuf_type* rdbuf() const { return const_cast<stringbuf_type*>(&sb_); }
+
+    string_type str() const & { return sb_.str(); }
+    string_type str() && { return std::move(sb_).str(); }
+    void str(const string_type& s) { sb_.str(s); }
+    void str(string_type&& s) { sb_.str(std::move(s)); }
+
+private:
+    stringbuf_type sb_;
+};
+
+template<
+    class CharT,
+    class Traits = std::char_traits<CharT>,
+    class Allocator = std::allocator<CharT>
+> class basic_ostringstream : public std::basic_ostream<CharT, Traits> {
+    using base_type = std::basic_ostream<CharT, Traits>;
+public:
+    typedef CharT char_type;
+    typedef Traits traits_type;
+    typedef typename Traits::int_type int_type;
+    typedef typename Traits::pos_type pos_type;
+    typedef typename Traits::off_type off_type;
+    typedef Allocator allocator_type;
+    using string_type = basic_string<CharT, Traits, Allocator>;
+    using stringbuf_type = basic_stringbuf<CharT, Traits, Allocator>;
+
+    explicit basic_ostringstream(std::ios_base::openmode which = std::ios_base::out) :
+        base_type(&sb_), sb_(which | std::ios_base::out)
+    {}
+
+    explicit basic_ostringstream(const string_type& s,
+                                 std::ios_base::openmode which = std::ios_base::out) :
+        base_type(&sb_), sb_(s, which | std::ios_base::out)
+    {}
+
+    explicit basic_ostringstream(string_type&& s,
+                                 std::ios_base::openmode which = std::ios_base::out) :
+        base_type(&sb_), sb_(std::move(s), which | std::ios_base::out)
+    {}
+
+    basic_ostringstream(basic_ostringstream&& other) :
+        base_type(std::move(other)), sb_(std::move(other.sb_))
+    {
+        base_type::set_rdbuf(&sb_);
+    }
+
+    basic_ostringstream& operator=(basic_ostringstream&& other)
+    {
+        base_type::operator=(std::move(other));
+        sb_ = std::move(other.sb_);
+        return *this;
+    }
+
+    void swap(basic_ostringstream& other)
+    {
+        base_type::swap(other);
+        sb_.swap(other.sb_);
+    }
+
+    stringbuf_type* rdbuf() const { return const_cast<stringbuf_type*>(&sb_); }
+
+    string_type str() const & { return sb_.str(); }
+    string_type str() && { return std::move(sb_).str(); }
+    void str(const string_type& s) { sb_.str(s); }
+    void str(string_type&& s) { sb_.str(std::move(s)); }
+
+private:
+    stringbuf_type sb_;
+};
+
+template<
+    class CharT,
+    class Traits = std::char_traits<CharT>,
+    class Allocator = std::allocator<CharT>
+> class basic_stringstream : public std::basic_iostream<CharT, Traits> {
+    using base_type = std::basic_iostream<CharT, Traits>;
+public:
+    typedef CharT char_type;
+    typedef Traits traits_type;
+    typedef typename Traits::int_type int_type;
+    typedef typename Traits::pos_type pos_type;
+    typedef typename Traits::off_type off_type;
+    typedef Allocator allocator_type;
+    using string_type = basic_string<CharT, Traits, Allocator>;
+    using stringbuf_type = basic_stringbuf<CharT, Traits, Allocator>;
+
+    explicit basic_stringstream(std::ios_base::openmode which =
+                                    std::ios_base::in | std::ios_base::out) :
+        base_type(&sb_), sb_(which)
+    {}
+
+    explicit basic_stringstream(const string_type& s,
+                                std::ios_base::openmode which =
+                                    std::ios_base::in | std::ios_base::out) :
+        base_type(&sb_), sb_(s, which)
+    {}
+
+    explicit basic_stringstream(string_type&& s,
+                                std::ios_base::openmode which =
+                                    std::ios_base::in | std::ios_base::out) :
+        base_type(&sb_), sb_(std::move(s), which)
+    {}
+
+    basic_stringstream(basic_stringstream&& other) :
+        base_type(std::move(other)), sb_(std::move(other.sb_))
+    {
+        base_type::set_rdbuf(&sb_);
+    }
+
+    basic_stringstream& operator=(basic_stringstream&& other)
+    {
+        base_type::operator=(std::move(other));
+        sb_ = std::move(other.sb_);
+        return *this;
+    }
+
+    void swap(basic_stringstream& other)
+    {
+        base_type::swap(other);
+        sb_.swap(other.sb_);
+    }
+
+    stringbuf_type* rdbuf() const { return const_cast<stringbuf_type*>(&sb_); }
+
+    string_type str() const & { return sb_.str(); }
+    string_type str() && { return std::move(sb_).str(); }
+    void str(const string_type& s) { sb_.str(s); }
+    void str(string_type&& s) { sb_.str(std::move(s)); }
+
+private:
+    stringbuf_type sb_;
+};
+
+template<class CharT, class Traits, class Allocator>
+void swap(basic_istringstream<CharT, Traits, Allocator>& lhs,
+          basic_istringstream<CharT, Traits, Allocator>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+template<class CharT, class Traits, class Allocator>
+void swap(basic_ostringstream<CharT, Traits, Allocator>& lhs,
+          basic_ostringstream<CharT, Traits, Allocator>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+template<class CharT, class Traits, class Allocator>
+void swap(basic_stringstream<CharT, Traits, Allocator>& lhs,
+          basic_stringstream<CharT, Traits, Allocator>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+using stringbuf = basic_stringbuf<char>;
+using wstringbuf = basic_stringbuf<wchar_t>;
+using istringstream = basic_istringstream<char>;
+using wistringstream = basic_istringstream<wchar_t>;
+using ostringstream = basic_ostringstream<char>;
+using wostringstream = basic_ostringstream<wchar_t>;
+using stringstream = basic_stringstream<char>;
+using wstringstream = basic_stringstream<wchar_t>;
+
+} // namespace tidy
+
+#endif
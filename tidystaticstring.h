@@ -0,0 +1,53 @@
+/*  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+
+    Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+            http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef TIDY_TIDYSTATICSTRING_H
+#define TIDY_TIDYSTATICSTRING_H
+
+#include <cstddef>
+#include <string>
+#include "tidyinplacevector.h"
+#include "tidystring.h"
+
+namespace tidy {
+namespace detail {
+
+template<class CharT, std::size_t N>
+struct string_container<CharT, inplace_allocator<CharT, N>> {
+    using type = inplace_vector<CharT, N>;
+};
+
+} // namespace detail
+
+/*  A string class with fixed capacity N that never allocates and does not
+    leak information to memory. The characters and the nul terminator are
+    stored within the object itself.
+
+    This is tidy::basic_string with storage that lives within the object, thus
+    the whole interface of tidy::basic_string is available. max_size() is N and
+    operations that would make the string longer throw std::length_error.
+
+    Since the allocator type differs from that of std::basic_string, the
+    overloads accepting std::basic_string can only be used with
+    basic_static_string::stdstring_type.
+*/
+template<class CharT, std::size_t N, class Traits = std::char_traits<CharT>>
+using basic_static_string =
+    basic_string<CharT, Traits, detail::inplace_allocator<CharT, N + 1>>;
+
+template<std::size_t N>
+using static_string = basic_static_string<char, N>;
+template<std::size_t N>
+using wstatic_string = basic_static_string<wchar_t, N>;
+template<std::size_t N>
+using u16static_string = basic_static_string<char16_t, N>;
+template<std::size_t N>
+using u32static_string = basic_static_string<char32_t, N>;
+
+} // namespace tidy
+
+#endif
@@ -8,24 +8,202 @@
 #ifndef TIDY_TIDYSTRING_H
 #define TIDY_TIDYSTRING_H
 
+#include <climits>
 #include <cstring>
 #include <algorithm>
 #include <initializer_list>
-#include <iosfwd>
+#include <istream>
 #include <iterator>
+#include <locale>
 #include <memory>
+#include <ostream>
 #include <stdexcept>
 #include <string>
 #include <vector>
 #include "tidyvector.h"
 
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <string_view>
+#define TIDY_HAS_STRING_VIEW 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TIDY_STRING_SSE2 1
+#endif
+
 namespace tidy {
+namespace detail {
+
+/*  Selects the container that holds the characters of basic_string for the
+    given allocator. Specialized by tidystaticstring.h.
+*/
+template<class CharT, class Allocator, class Enable = void>
+struct string_container {
+    using type = vector<CharT, Allocator>;
+};
+
+/*  A set of characters for the find_first_of family. Single-byte characters
+    compared by std::char_traits are looked up in a bitmap, so each scanned
+    character takes constant time regardless of the size of the set. With
+    SSE2, sets of up to 16 such characters are instead matched against 16
+    characters at a time. A set of one character is searched for with
+    Traits::find, which is memchr for char. Otherwise each character is
+    searched in the set with Traits::find.
+
+    The set refers to the given characters, which must outlive it.
+*/
+template<class CharT, class Traits,
+         bool UseTable = sizeof(CharT) == 1 && std::is_same<Traits, std::char_traits<CharT>>::value>
+class char_set {
+public:
+    char_set() : s_(nullptr), count_(0) {}
+    char_set(const CharT* s, std::size_t count) : s_(s), count_(count) {}
+
+    bool contains(CharT ch) const
+    {
+        return Traits::find(s_, count_, ch) != nullptr;
+    }
+
+    // Returns the first character in [first, last) that is in the set or last
+    const CharT* find_in(const CharT* first, const CharT* last) const
+    {
+        if (count_ == 1) {
+            const CharT* found = Traits::find(first, last - first, s_[0]);
+            return found == nullptr ? last : found;
+        }
+        for (; first != last; ++first) {
+            if (contains(*first))
+                return first;
+        }
+        return last;
+    }
+
+    const CharT* find_not_in(const CharT* first, const CharT* last) const
+    {
+        for (; first != last; ++first) {
+            if (!contains(*first))
+                return first;
+        }
+        return last;
+    }
+
+private:
+    const CharT* s_;
+    std::size_t count_;
+};
+
+template<class CharT, class Traits>
+class char_set<CharT, Traits, true> {
+public:
+    char_set() : char_set(nullptr, 0) {}
+
+    char_set(const CharT* s, std::size_t count) : single_(count == 1), first_(CharT())
+    {
+        std::memset(bits_, 0, sizeof(bits_));
+#if TIDY_STRING_SSE2
+        std::size_t distinct = 0;
+#endif
+        for (std::size_t i = 0; i < count; ++i) {
+            unsigned ch = static_cast<unsigned char>(s[i]);
+#if TIDY_STRING_SSE2
+            if (!contains(s[i])) {
+                if (distinct < max_needles)
+                    needles_[distinct] = _mm_set1_epi8(char(s[i]));
+                ++distinct;
+            }
+#endif
+            bits_[ch / 64] |= std::uint64_t(1) << (ch % 64);
+        }
+        if (single_)
+            first_ = s[0];
+#if TIDY_STRING_SSE2
+        // larger sets use the bitmap
+        needle_count_ = distinct <= max_needles ? unsigned(distinct) : 0;
+#endif
+    }
+
+    bool contains(CharT ch) const
+    {
+        unsigned c = static_cast<unsigned char>(ch);
+        return (bits_[c / 64] >> (c % 64)) & 1;
+    }
+
+    const CharT* find_in(const CharT* first, const CharT* last) const
+    {
+        if (single_) {
+            const CharT* found = Traits::find(first, last - first, first_);
+            return found == nullptr ? last : found;
+        }
+#if TIDY_STRING_SSE2
+        if (needle_count_ != 0) {
+            for (; last - first >= 16; first += 16) {
+                unsigned mask = match16(first);
+                if (mask != 0)
+                    return first + count_trailing_zeros(mask);
+            }
+        }
+#endif
+        for (; first != last; ++first) {
+            if (contains(*first))
+                return first;
+        }
+        return last;
+    }
+
+    const CharT* find_not_in(const CharT* first, const CharT* last) const
+    {
+#if TIDY_STRING_SSE2
+        if (needle_count_ != 0) {
+            for (; last - first >= 16; first += 16) {
+                unsigned mask = match16(first) ^ 0xffff;
+                if (mask != 0)
+                    return first + count_trailing_zeros(mask);
+            }
+        }
+#endif
+        for (; first != last; ++first) {
+            if (!contains(*first))
+                return first;
+        }
+        return last;
+    }
+
+private:
+#if TIDY_STRING_SSE2
+    static const std::size_t max_needles = 16;
+
+    // Returns the mask of the 16 characters at p that are in the set
+    unsigned match16(const CharT* p) const
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i found = _mm_cmpeq_epi8(v, needles_[0]);
+        for (unsigned i = 1; i < needle_count_; ++i)
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(v, needles_[i]));
+        return unsigned(_mm_movemask_epi8(found));
+    }
+
+    // each distinct character of a small set broadcast to all bytes
+    __m128i needles_[max_needles];
+    unsigned needle_count_;
+#endif
+    // one bit for each byte value
+    std::uint64_t bits_[4];
+    bool single_;
+    CharT first_;
+};
+
+} // namespace detail
 
 /*  A string class that does not leak information to memory. That is, upon
     descruction, no traces of the contents of the string can be found in memory
     regardless of operations that are applied to the string.
 
     The class has not been fully optimized.
+
+    The underlying vector holds the characters followed by a nul terminator.
+    An empty vector is also valid and denotes an empty string. This allows
+    default construction, move construction and clear() to not allocate.
 */
 template<
     class CharT,
@@ -43,8 +221,11 @@ public:
     typedef typename std::allocator_traits<Allocator>::pointer pointer;
     typedef typename std::allocator_traits<Allocator>::const_pointer const_pointer;
 
-    using container_type = vector<CharT, Allocator>;
+    using container_type = typename detail::string_container<CharT, Allocator>::type;
     using stdstring_type = std::basic_string<CharT, Traits, Allocator>;
+#if TIDY_HAS_STRING_VIEW
+    using string_view_type = std::basic_string_view<CharT, Traits>;
+#endif
 
     using iterator = typename container_type::iterator;
     using const_iterator = typename container_type::const_iterator;
@@ -52,15 +233,9 @@ public:
     typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
     // constructor
-    basic_string()
-    {
-        data_.push_back(value_type());
-    }
+    basic_string() noexcept(std::is_nothrow_default_constructible<Allocator>::value) {}
 
-    explicit basic_string(const Allocator& alloc) : data_(alloc)
-    {
-        data_.push_back(value_type());
-    }
+    explicit basic_string(const Allocator& alloc) noexcept : data_(alloc) {}
 
     basic_string(size_type count, CharT ch,
                  const Allocator& alloc = Allocator()) : data_(alloc)
@@ -84,6 +259,22 @@ public:
         assign(other, pos, count);
     }
 
+#if TIDY_HAS_STRING_VIEW
+    explicit basic_string(string_view_type sv,
+                          const Allocator& alloc = Allocator()) : data_(alloc)
+    {
+        assign(sv.data(), sv.size());
+    }
+
+    basic_string(string_view_type sv,
+                 size_type pos,
+                 size_type count,
+                 const Allocator& alloc = Allocator()) : data_(alloc)
+    {
+        assign(sv, pos, count);
+    }
+#endif
+
     basic_string(const CharT* s,
                  size_type count,
                  const Allocator& alloc = Allocator()) : data_(alloc)
@@ -112,10 +303,7 @@ public:
         assign(other);
     }
 
-    basic_string(basic_string&& other) : data_(std::move(other.data_))
-    {
-        other.data_.push_back(value_type());
-    }
+    basic_string(basic_string&& other) noexcept : data_(std::move(other.data_)) {}
 
     basic_string(std::initializer_list<CharT> init,
                  const Allocator& alloc = Allocator()) : data_(alloc)
@@ -123,16 +311,20 @@ public:
         assign(init);
     }
 
-    ~basic_string() {}
+    ~basic_string() noexcept {}
 
     basic_string& operator=(const stdstring_type& str) { return assign(str); }
     basic_string& operator=(const basic_string& str) { return assign(str); }
     basic_string& operator=(const CharT* s) { return assign(s); }
+#if TIDY_HAS_STRING_VIEW
+    basic_string& operator=(string_view_type sv) { return assign(sv); }
+#endif
     basic_string& operator=(CharT ch) { clear(); push_back(ch); return *this; }
     basic_string& operator=(basic_string&& other)
+        noexcept(detail::is_nothrow_move_assignable_alloc<Allocator>::value)
     {
         data_ = std::move(other.data_);
-        other.data_.push_back(value_type());
+        other.data_.clear();
         return *this;
     }
 
@@ -176,6 +368,23 @@ public:
         return assign(str.data() + pos, std::min(count, size - pos));
     }
 
+#if TIDY_HAS_STRING_VIEW
+    basic_string& assign(string_view_type sv)
+    {
+        return assign(sv.data(), sv.size());
+    }
+
+    basic_string& assign(string_view_type sv,
+                         size_type pos,
+                         size_type count = npos)
+    {
+        size_type size = sv.size();
+        if (pos > size)
+            throw std::out_of_range("pos > size");
+        return assign(sv.data() + pos, std::min(count, size - pos));
+    }
+#endif
+
     basic_string& assign(const CharT* s, size_type count)
     {
         data_.resize(count + 1);
@@ -206,7 +415,7 @@ public:
         return assign(ilist.begin(), ilist.end());
     }
 
-    allocator_type get_allocator() const { return data_.get_allocator(); }
+    allocator_type get_allocator() const noexcept { return data_.get_allocator(); }
 
     reference at(size_type n)
     {
@@ -222,45 +431,67 @@ public:
         return data_[n];
     }
 
-    reference       operator[](size_type n) { return data_[n]; }
-    const_reference operator[](size_type n) const { return data_[n]; }
+    // The terminator of an empty string may be written to, so the string
+    // gets its own storage for it
+    reference operator[](size_type n)
+    {
+        ensure_terminator();
+        return data_[n];
+    }
+    const_reference operator[](size_type n) const noexcept
+    {
+        return data_.empty() ? empty_terminator() : data_[n];
+    }
 
-    CharT& front() { return data_.front(); }
-    const CharT& front() const { return data_.front(); }
-    CharT& back() { return data_[data_.size() - 2]; }
-    const CharT& back() const { return data_[data_.size() - 2]; }
+    CharT& front() noexcept { return data_.front(); }
+    const CharT& front() const noexcept { return data_.front(); }
+    CharT& back() noexcept { return data_[data_.size() - 2]; }
+    const CharT& back() const noexcept { return data_[data_.size() - 2]; }
 
-    const CharT* data() const { return data_.data(); }
-    const CharT* c_str() const { return data_.data(); }
+    const CharT* data() const noexcept
+    {
+        return data_.empty() ? &empty_terminator() : data_.data();
+    }
+    const CharT* c_str() const noexcept { return data(); }
+
+#if TIDY_HAS_STRING_VIEW
+    // The view refers to the characters of the string, thus no copy is made
+    operator string_view_type() const noexcept
+    {
+        return string_view_type(data(), size());
+    }
+#endif
 
-    iterator begin() { return data_.begin(); }
-    const_iterator begin() const { return data_.begin(); }
-    iterator end() { return --(data_.end()); }
-    const_iterator end() const { return --(data_.end()); }
+    iterator begin() noexcept { return data_.begin(); }
+    const_iterator begin() const noexcept { return data_.begin(); }
+    iterator end() noexcept { return data_.begin() + size(); }
+    const_iterator end() const noexcept { return data_.begin() + size(); }
 
-    reverse_iterator       rbegin() { return ++(data_.rbegin()); }
-    const_reverse_iterator rbegin() const { return ++(data_.rbegin()); }
-    reverse_iterator       rend() { return data_.rend(); }
-    const_reverse_iterator rend() const { return data_.rend(); }
+    reverse_iterator       rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend() noexcept { return data_.rend(); }
+    const_reverse_iterator rend() const noexcept { return data_.rend(); }
 
-    const_iterator         cbegin() const { return begin(); }
-    const_iterator         cend() const { return end(); }
-    const_reverse_iterator crbegin() const { return rbegin(); }
-    const_reverse_iterator crend() const { return rend(); }
+    const_iterator         cbegin() const noexcept { return begin(); }
+    const_iterator         cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
 
     // capacity
-    bool empty() const { return data_.size() <= 1; }
-    size_type size() const { return data_.size() - 1; }
-    size_type length() const { return size(); }
-    size_type max_size() const { return data_.max_size() - 1; }
+    bool empty() const noexcept { return data_.size() <= 1; }
+    size_type size() const noexcept { return data_.empty() ? 0 : data_.size() - 1; }
+    size_type length() const noexcept { return size(); }
+    size_type max_size() const noexcept { return data_.max_size() - 1; }
     void reserve(size_type new_cap = 0)
     {
         if (new_cap > max_size())
             throw std::length_error("new_cap > max_size()");
-        data_.reserve(new_cap + 1);
+        // don't allocate just for the terminator of a string without storage
+        if (new_cap > capacity())
+            data_.reserve(new_cap + 1);
     }
 
-    size_type capacity() const
+    size_type capacity() const noexcept
     {
         size_type cap = data_.capacity();
         if (cap > 0)
@@ -269,7 +500,7 @@ public:
     }
 
     void shrink_to_fit() { data_.shrink_to_fit(); }
-    void clear() { data_.clear(); data_.push_back(value_type()); }
+    void clear() noexcept { data_.clear(); }
 
     basic_string& insert(size_type index, size_type count, CharT ch)
     {
@@ -288,6 +519,7 @@ public:
     {
         if (index > size())
             throw std::out_of_range("index > size()");
+        ensure_terminator();
         data_.insert(begin() + index, s, s+count);
         return *this;
     }
@@ -311,14 +543,34 @@ public:
         return insert(index, str.data() + index_str, std::min(count, size - index_str));
     }
 
+#if TIDY_HAS_STRING_VIEW
+    basic_string& insert(size_type index, string_view_type sv)
+    {
+        return insert(index, sv.data(), sv.size());
+    }
+
+    basic_string& insert(size_type index, string_view_type sv,
+                         size_type index_str, size_type count = npos)
+    {
+        size_type size = sv.size();
+        if (index_str > size)
+            throw std::out_of_range("index_str > size");
+        return insert(index, sv.data() + index_str, std::min(count, size - index_str));
+    }
+#endif
+
     iterator insert(const_iterator pos, CharT ch)
     {
-        return data_.insert(pos, ch);
+        difference_type index = pos - cbegin();
+        ensure_terminator();
+        return data_.insert(cbegin() + index, ch);
     }
 
     iterator insert(const_iterator pos, size_type count, CharT ch)
     {
-        return data_.insert(pos, count, ch);
+        difference_type index = pos - cbegin();
+        ensure_terminator();
+        return data_.insert(cbegin() + index, count, ch);
     }
 
     template<class InputIt>
@@ -328,12 +580,16 @@ public:
     >::type
         insert(const_iterator pos, InputIt first, InputIt last)
     {
-        return data_.insert(pos, first, last);
+        difference_type index = pos - cbegin();
+        ensure_terminator();
+        return data_.insert(cbegin() + index, first, last);
     }
 
     iterator insert(const_iterator pos, std::initializer_list<CharT> ilist)
     {
-        return data_.insert(pos, ilist);
+        difference_type index = pos - cbegin();
+        ensure_terminator();
+        return data_.insert(cbegin() + index, ilist);
     }
 
     basic_string& erase(size_type index = 0, size_type count = npos)
@@ -363,10 +619,7 @@ public:
     void pop_back()
     {
         data_.pop_back();
-        if (data_.size() == 1)
-            data_.pop_back();
-        else
-            data_.back() = value_type();
+        data_.back() = value_type();
     }
 
     void resize(size_type count)
@@ -379,7 +632,8 @@ public:
         if (count > max_size())
             throw std::length_error("count >= max_size()");
         reserve(count);
-        data_.pop_back();
+        if (!data_.empty())
+            data_.pop_back();
         data_.resize(count, value);
         data_.push_back(value_type());
     }
@@ -420,11 +674,29 @@ public:
         return append(str.data() + pos, std::min(count, size2 - pos));
     }
 
+#if TIDY_HAS_STRING_VIEW
+    basic_string& append(string_view_type sv)
+    {
+        return append(sv.data(), sv.size());
+    }
+
+    basic_string& append(string_view_type sv,
+                         size_type pos,
+                         size_type count = npos)
+    {
+        size_type size2 = sv.size();
+        if (pos > size2)
+            throw std::out_of_range("index_str > size");
+        return append(sv.data() + pos, std::min(count, size2 - pos));
+    }
+#endif
+
     basic_string& append(const CharT* s, size_type count)
     {
-        size_type old_size = size();
-        resize(size() + count, value_type());
-        traits_type::move(data_.data() + old_size, s, count);
+        if (count > max_size() - size())
+            throw std::length_error("count > max_size() - size()");
+        ensure_terminator();
+        data_.insert(end(), s, s + count);
         return *this;
     }
 
@@ -452,7 +724,9 @@ public:
     >::type
         append(ForwardIt first, ForwardIt last)
     {
-        reserve(size() + std::distance(first, last));
+        if (size_type(std::distance(first, last)) > max_size() - size())
+            throw std::length_error("count > max_size() - size()");
+        ensure_terminator();
         data_.insert(end(), first, last);
         return *this;
     }
@@ -466,6 +740,9 @@ public:
     basic_string& operator+=(const stdstring_type& str) { return append(str); }
     basic_string& operator+=(CharT ch) { push_back(ch); return *this; }
     basic_string& operator+=(const CharT* s) { return append(s); }
+#if TIDY_HAS_STRING_VIEW
+    basic_string& operator+=(string_view_type sv) { return append(sv); }
+#endif
     basic_string& operator+=(std::initializer_list<CharT> ilist) { return append(ilist); }
 
     int compare(const basic_string& str) const
@@ -509,6 +786,30 @@ public:
                        std::min(count2, size2 - pos2));
     }
 
+#if TIDY_HAS_STRING_VIEW
+    int compare(string_view_type sv) const
+    {
+        return compare(0, size(), sv.data(), sv.size());
+    }
+
+    int compare(size_type pos1, size_type count1,
+                string_view_type sv) const
+    {
+        return compare(pos1, count1, sv.data(), sv.size());
+    }
+
+    int compare(size_type pos1, size_type count1,
+                string_view_type sv,
+                size_type pos2, size_type count2 = npos) const
+    {
+        size_type size2 = sv.size();
+        if (pos2 > size2)
+            throw std::out_of_range("pos2 > size2");
+        return compare(pos1, count1, sv.data() + pos2,
+                       std::min(count2, size2 - pos2));
+    }
+#endif
+
     int compare(const CharT* s) const
     {
         return compare(0, size(), s, traits_type::length(s));
@@ -572,6 +873,60 @@ public:
     basic_string& replace(const_iterator first, const_iterator last,
                               std::initializer_list<CharT> ilist);
     */
+    bool starts_with(const CharT* s) const noexcept
+    {
+        return has_prefix(s, traits_type::length(s));
+    }
+    bool starts_with(const basic_string& str) const noexcept
+    {
+        return has_prefix(str.data(), str.size());
+    }
+    bool starts_with(const stdstring_type& str) const noexcept
+    {
+        return has_prefix(str.data(), str.size());
+    }
+    bool starts_with(CharT ch) const noexcept
+    {
+        return !empty() && traits_type::eq(front(), ch);
+    }
+
+    bool ends_with(const CharT* s) const noexcept
+    {
+        return has_suffix(s, traits_type::length(s));
+    }
+    bool ends_with(const basic_string& str) const noexcept
+    {
+        return has_suffix(str.data(), str.size());
+    }
+    bool ends_with(const stdstring_type& str) const noexcept
+    {
+        return has_suffix(str.data(), str.size());
+    }
+    bool ends_with(CharT ch) const noexcept
+    {
+        return !empty() && traits_type::eq(back(), ch);
+    }
+
+    bool contains(const CharT* s) const noexcept { return find(s) != npos; }
+    bool contains(const basic_string& str) const noexcept { return find(str) != npos; }
+    bool contains(const stdstring_type& str) const noexcept { return find(str) != npos; }
+    bool contains(CharT ch) const noexcept { return find(ch) != npos; }
+
+#if TIDY_HAS_STRING_VIEW
+    bool starts_with(string_view_type sv) const noexcept
+    {
+        return has_prefix(sv.data(), sv.size());
+    }
+    bool ends_with(string_view_type sv) const noexcept
+    {
+        return has_suffix(sv.data(), sv.size());
+    }
+    bool contains(string_view_type sv) const noexcept
+    {
+        return find(sv) != npos;
+    }
+#endif
+
     basic_string substr(size_type pos = 0,
                             size_type count = npos) const
     {
@@ -593,7 +948,7 @@ public:
         return count;
     }
 
-    void swap(basic_string& other)
+    void swap(basic_string& other) noexcept
     {
         data_.swap(other.data_);
     }
@@ -607,6 +962,12 @@ public:
     {
         return find(str.data(), pos, str.size());
     }
+#if TIDY_HAS_STRING_VIEW
+    size_type find(string_view_type sv, size_type pos = 0) const
+    {
+        return find(sv.data(), pos, sv.size());
+    }
+#endif
     size_type find(const CharT* s, size_type pos, size_type count) const
     {
         if (pos > size() || size() - pos < count)
@@ -640,6 +1001,12 @@ public:
     {
         return rfind(str.data(), pos, str.size());
     }
+#if TIDY_HAS_STRING_VIEW
+    size_type rfind(string_view_type sv, size_type pos = npos) const
+    {
+        return rfind(sv.data(), pos, sv.size());
+    }
+#endif
     size_type rfind(const CharT* s, size_type pos, size_type count) const
     {
         if (pos < size() && count < size() - pos)
@@ -681,17 +1048,19 @@ public:
     {
         return find_first_of(str.data(), pos, str.size());
     }
+#if TIDY_HAS_STRING_VIEW
+    size_type find_first_of(string_view_type sv, size_type pos = 0) const
+    {
+        return find_first_of(sv.data(), pos, sv.size());
+    }
+#endif
     size_type find_first_of(const CharT* s, size_type pos, size_type count) const
     {
         if (pos >= size() || count == 0)
             return npos;
-        for (auto it1 = begin() + pos; it1 != end(); ++it1) {
-            for (const CharT* it2 = s; it2 < s + count; ++it2) {
-                if (traits_type::eq(*it1, *it2))
-                    return std::distance(begin(), it1);
-            }
-        }
-        return npos;
+        const CharT* last = data() + size();
+        const CharT* found = detail::char_set<CharT, Traits>(s, count).find_in(data() + pos, last);
+        return found == last ? npos : size_type(found - data());
     }
     size_type find_first_of(const CharT* s, size_type pos = 0) const
     {
@@ -710,15 +1079,20 @@ public:
     {
         return find_first_not_of(str.data(), pos, str.size());
     }
+#if TIDY_HAS_STRING_VIEW
+    size_type find_first_not_of(string_view_type sv, size_type pos = 0) const
+    {
+        return find_first_not_of(sv.data(), pos, sv.size());
+    }
+#endif
     size_type find_first_not_of(const CharT* s, size_type pos, size_type count) const
     {
         if (pos >= size())
             return npos;
-        for (auto it = begin() + pos; it != end(); ++it) {
-            if (traits_type::find(s, count, *it) == nullptr)
-                return std::distance(begin(), it);
-        }
-        return npos;
+        const CharT* last = data() + size();
+        const CharT* found =
+                detail::char_set<CharT, Traits>(s, count).find_not_in(data() + pos, last);
+        return found == last ? npos : size_type(found - data());
     }
     size_type find_first_not_of(const CharT* s, size_type pos = 0) const
     {
@@ -743,6 +1117,12 @@ public:
     {
         return find_last_of(str.data(), pos, str.size());
     }
+#if TIDY_HAS_STRING_VIEW
+    size_type find_last_of(string_view_type sv, size_type pos = npos) const
+    {
+        return find_last_of(sv.data(), pos, sv.size());
+    }
+#endif
     size_type find_last_of(const CharT* s, size_type pos, size_type count) const
     {
         if (count == 0)
@@ -775,6 +1155,12 @@ public:
     {
         return find_last_not_of(str.data(), pos, str.size());
     }
+#if TIDY_HAS_STRING_VIEW
+    size_type find_last_not_of(string_view_type sv, size_type pos = npos) const
+    {
+        return find_last_not_of(sv.data(), pos, sv.size());
+    }
+#endif
     size_type find_last_not_of(const CharT* s, size_type pos, size_type count) const
     {
         if (pos < size())
@@ -808,11 +1194,41 @@ public:
 
     bool __invariants() const
     {
-        return !data_.empty() && data_.__invariants();
+        if (!data_.empty() && data_.back() != value_type())
+            return false;
+        return data_.__invariants();
     }
 
     static const size_type npos = -1;
 private:
+
+    // Returns the terminator of strings that have no storage. It is shared
+    // by all such strings and is thus only accessible as const.
+    static const CharT& empty_terminator() noexcept
+    {
+        static const CharT terminator = CharT();
+        return terminator;
+    }
+
+    bool has_prefix(const CharT* s, size_type count) const noexcept
+    {
+        return size() >= count && traits_type::compare(data(), s, count) == 0;
+    }
+
+    bool has_suffix(const CharT* s, size_type count) const noexcept
+    {
+        return size() >= count &&
+                traits_type::compare(data() + size() - count, s, count) == 0;
+    }
+
+    // Adds the nul terminator to strings that have no storage. Must be called
+    // before operations that place characters before the terminator.
+    void ensure_terminator()
+    {
+        if (data_.empty())
+            data_.push_back(value_type());
+    }
+
     container_type data_;
 };
 
@@ -821,15 +1237,98 @@ using wstring = basic_string<wchar_t>;
 using u16string = basic_string<char16_t>;
 using u32string = basic_string<char32_t>;
 
+namespace detail {
+
+// Computes the length of and appends the pieces accepted by tidy::concat
+template<class CharT, class Traits>
+struct concat_piece {
+    static std::size_t size(CharT) { return 1; }
+    static std::size_t size(const CharT* s) { return Traits::length(s); }
+
+    template<class A>
+    static std::size_t size(const basic_string<CharT, Traits, A>& s) { return s.size(); }
+
+    template<class A>
+    static std::size_t size(const std::basic_string<CharT, Traits, A>& s) { return s.size(); }
+
+#if TIDY_HAS_STRING_VIEW
+    static std::size_t size(std::basic_string_view<CharT, Traits> s) { return s.size(); }
+#endif
+
+    // size is the value returned by size() for the same piece, so that the
+    // length of character strings is computed only once
+    template<class String>
+    static void append(String& str, CharT ch, std::size_t) { str.push_back(ch); }
+
+    template<class String>
+    static void append(String& str, const CharT* s, std::size_t size)
+    {
+        str.append(s, size);
+    }
+
+    template<class String, class A>
+    static void append(String& str, const basic_string<CharT, Traits, A>& s, std::size_t size)
+    {
+        str.append(s.data(), size);
+    }
+
+    template<class String, class A>
+    static void append(String& str, const std::basic_string<CharT, Traits, A>& s,
+                       std::size_t size)
+    {
+        str.append(s.data(), size);
+    }
+
+#if TIDY_HAS_STRING_VIEW
+    template<class String>
+    static void append(String& str, std::basic_string_view<CharT, Traits> s, std::size_t size)
+    {
+        str.append(s.data(), size);
+    }
+#endif
+};
+
+} // namespace detail
+
+/*  Concatenates the given pieces into a new string. Each piece may be a
+    tidy::basic_string or std::basic_string with any allocator, a
+    std::basic_string_view, a nul-terminated character string or a single
+    character.
+
+    Unlike a chain of operator+ calls, the total length is computed first and
+    the result is allocated once, thus no intermediate strings are created.
+    The result uses a copy of the allocator of the first piece.
+*/
+template<class CharT, class Traits, class Alloc, class... Pieces>
+basic_string<CharT, Traits, Alloc>
+    concat(const basic_string<CharT, Traits, Alloc>& first, const Pieces& ... rest)
+{
+    using piece = detail::concat_piece<CharT, Traits>;
+    using alloc_traits = std::allocator_traits<Alloc>;
+
+    std::size_t sizes[] = { first.size(), piece::size(rest)... };
+    std::size_t total = 0;
+    for (std::size_t size : sizes)
+        total += size;
+
+    basic_string<CharT, Traits, Alloc> str(
+        alloc_traits::select_on_container_copy_construction(first.get_allocator()));
+    str.reserve(total);
+    str.append(first);
+    // the elements of a braced list are evaluated in order
+    const std::size_t* size = sizes + 1;
+    int expand[] = { 0, (piece::append(str, rest, *size++), 0)... };
+    (void) size;
+    (void) expand;
+    return str;
+}
 
 template<class CharT, class Traits, class Alloc>
 inline basic_string<CharT, Traits, Alloc>
     operator+(const basic_string<CharT, Traits, Alloc>& lhs,
               const basic_string<CharT, Traits, Alloc>& rhs)
 {
-    basic_string<CharT, Traits, Alloc> str = lhs;
-    str.append(rhs);
-    return str;
+    return concat(lhs, rhs);
 }
 
 template<class CharT, class Traits, class Alloc>
@@ -837,8 +1336,10 @@ inline basic_string<CharT, Traits, Alloc>
     operator+(const CharT* lhs,
               const basic_string<CharT, Traits, Alloc>& rhs)
 {
+    typename basic_string<CharT, Traits, Alloc>::size_type size = Traits::length(lhs);
     basic_string<CharT, Traits, Alloc> str;
-    str.assign(lhs);
+    str.reserve(size + rhs.size());
+    str.append(lhs, size);
     str.append(rhs);
     return str;
 }
@@ -849,6 +1350,7 @@ inline basic_string<CharT, Traits, Alloc>
               const basic_string<CharT, Traits, Alloc>& rhs)
 {
     basic_string<CharT, Traits, Alloc> str;
+    str.reserve(1 + rhs.size());
     str.push_back(lhs);
     str.append(rhs);
     return str;
@@ -859,9 +1361,7 @@ inline basic_string<CharT, Traits, Alloc>
     operator+(const basic_string<CharT, Traits, Alloc>& lhs,
               const CharT* rhs)
 {
-    basic_string<CharT, Traits, Alloc> str = lhs;
-    str.append(rhs);
-    return str;
+    return concat(lhs, rhs);
 }
 
 template<class CharT, class Traits, class Alloc>
@@ -869,9 +1369,7 @@ inline basic_string<CharT, Traits, Alloc>
     operator+(const basic_string<CharT, Traits, Alloc>& lhs,
               CharT rhs)
 {
-    basic_string<CharT, Traits, Alloc> str = lhs;
-    str.push_back(rhs);
-    return str;
+    return concat(lhs, rhs);
 }
 
 // TODO
@@ -1140,38 +1638,496 @@ inline bool operator>=(const basic_string<CharT, Traits, Alloc>& lhs, const Char
     return lhs.compare(rhs) >= 0;
 }
 
+#if TIDY_HAS_STRING_VIEW
+// comparisons between tidy::basic_string and std::basic_string_view. The view
+// is not deduced, thus anything convertible to it can be compared directly.
+template<class CharT, class Traits, class Alloc>
+inline bool operator==(const basic_string<CharT, Traits, Alloc>& lhs,
+                       typename basic_string<CharT, Traits, Alloc>::string_view_type rhs)
+{
+    return lhs.compare(rhs) == 0;
+}
+
+template<class CharT, class Traits, class Alloc>
+inline bool operator!=(const basic_string<CharT, Traits, Alloc>& lhs,
+                       typename basic_string<CharT, Traits, Alloc>::string_view_type rhs)
+{
+    return lhs.compare(rhs) != 0;
+}
+
+template<class CharT, class Traits, class Alloc>
+inline bool operator<(const basic_string<CharT, Traits, Alloc>& lhs,
+                      typename basic_string<CharT, Traits, Alloc>::string_view_type rhs)
+{
+    return lhs.compare(rhs) < 0;
+}
+
+template<class CharT, class Traits, class Alloc>
+inline bool operator<=(const basic_string<CharT, Traits, Alloc>& lhs,
+                       typename basic_string<CharT, Traits, Alloc>::string_view_type rhs)
+{
+    return lhs.compare(rhs) <= 0;
+}
+
+template<class CharT, class Traits, class Alloc>
+inline bool operator>(const basic_string<CharT, Traits, Alloc>& lhs,
+                      typename basic_string<CharT, Traits, Alloc>::string_view_type rhs)
+{
+    return lhs.compare(rhs) > 0;
+}
+
+template<class CharT, class Traits, class Alloc>
+inline bool operator>=(const basic_string<CharT, Traits, Alloc>& lhs,
+                       typename basic_string<CharT, Traits, Alloc>::string_view_type rhs)
+{
+    return lhs.compare(rhs) >= 0;
+}
+
+template<class CharT, class Traits, class Alloc>
+inline bool operator==(typename basic_string<CharT, Traits, Alloc>::string_view_type lhs,
+                       const basic_string<CharT, Traits, Alloc>& rhs)
+{
+    return rhs.compare(lhs) == 0;
+}
+
+template<class CharT, class Traits, class Alloc>
+inline bool operator!=(typename basic_string<CharT, Traits, Alloc>::string_view_type lhs,
+                       const basic_string<CharT, Traits, Alloc>& rhs)
+{
+    return rhs.compare(lhs) != 0;
+}
+
+template<class CharT, class Traits, class Alloc>
+inline bool operator<(typename basic_string<CharT, Traits, Alloc>::string_view_type lhs,
+                      const basic_string<CharT, Traits, Alloc>& rhs)
+{
+    return rhs.compare(lhs) > 0;
+}
+
+template<class CharT, class Traits, class Alloc>
+inline bool operator<=(typename basic_string<CharT, Traits, Alloc>::string_view_type lhs,
+                       const basic_string<CharT, Traits, Alloc>& rhs)
+{
+    return rhs.compare(lhs) >= 0;
+}
+
+template<class CharT, class Traits, class Alloc>
+inline bool operator>(typename basic_string<CharT, Traits, Alloc>::string_view_type lhs,
+                      const basic_string<CharT, Traits, Alloc>& rhs)
+{
+    return rhs.compare(lhs) < 0;
+}
+
+template<class CharT, class Traits, class Alloc>
+inline bool operator>=(typename basic_string<CharT, Traits, Alloc>::string_view_type lhs,
+                       const basic_string<CharT, Traits, Alloc>& rhs)
+{
+    return rhs.compare(lhs) <= 0;
+}
+#endif
+
 template<class T, class Traits, class Alloc>
-inline void swap(basic_string<T, Traits, Alloc>& lhs, basic_string<T, Traits, Alloc>& rhs)
+inline void swap(basic_string<T, Traits, Alloc>& lhs, basic_string<T, Traits, Alloc>& rhs) noexcept
 {
     lhs.swap(rhs);
 }
 
+template<class CharT, class Traits, class Alloc, class U>
+typename basic_string<CharT, Traits, Alloc>::size_type
+    erase(basic_string<CharT, Traits, Alloc>& c, const U& value)
+{
+    auto it = std::remove(c.begin(), c.end(), value);
+    auto count = c.end() - it;
+    c.erase(it, c.end());
+    return count;
+}
+
+template<class CharT, class Traits, class Alloc, class Pred>
+typename basic_string<CharT, Traits, Alloc>::size_type
+    erase_if(basic_string<CharT, Traits, Alloc>& c, Pred pred)
+{
+    auto it = std::remove_if(c.begin(), c.end(), pred);
+    auto count = c.end() - it;
+    c.erase(it, c.end());
+    return count;
+}
+
+namespace detail {
+
+template<class CharT>
+const CharT* ascii_whitespace()
+{
+    static const CharT chars[] = {
+        CharT(' '), CharT('\t'), CharT('\n'), CharT('\v'), CharT('\f'), CharT('\r'), CharT()
+    };
+    return chars;
+}
+
+// Flips the case bit of the characters in [lo, lo + 25], i.e. maps one
+// ASCII letter case to the other
+template<class CharT>
+void flip_ascii_case(CharT* p, std::size_t size, char lo)
+{
+    std::size_t i = 0;
+#if TIDY_STRING_SSE2
+    if (sizeof(CharT) == 1) {
+        // shift the range to start at -128 so that a single signed
+        // comparison selects it
+        const __m128i bias = _mm_set1_epi8(char(0x80 - lo));
+        const __m128i limit = _mm_set1_epi8(char(-128 + 26));
+        const __m128i bit = _mm_set1_epi8(0x20);
+        for (; i + 16 <= size; i += 16) {
+            __m128i* chunk = reinterpret_cast<__m128i*>(p + i);
+            __m128i v = _mm_loadu_si128(chunk);
+            __m128i in_range = _mm_cmpgt_epi8(limit, _mm_add_epi8(v, bias));
+            _mm_storeu_si128(chunk, _mm_xor_si128(v, _mm_and_si128(in_range, bit)));
+        }
+    }
+#endif
+    for (; i < size; ++i) {
+        if (p[i] >= CharT(lo) && p[i] <= CharT(lo + 25))
+            p[i] = CharT(p[i] ^ 0x20);
+    }
+}
+
+} // namespace detail
+
+/*  In-place normalization functions. They modify the characters in the
+    existing storage and never reallocate. When the string shrinks, the
+    vacated tail is wiped once.
+*/
+
+// Removes the given characters, ASCII whitespace by default, from the start
+template<class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>&
+    trim_left(basic_string<CharT, Traits, Alloc>& str,
+              const CharT* chars = detail::ascii_whitespace<CharT>())
+{
+    const CharT* first = str.data();
+    const CharT* last = first + str.size();
+    const CharT* kept = detail::char_set<CharT, Traits>(chars, Traits::length(chars))
+            .find_not_in(first, last);
+    str.erase(0, kept - first);
+    return str;
+}
+
+// Removes the given characters, ASCII whitespace by default, from the end
+template<class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>&
+    trim_right(basic_string<CharT, Traits, Alloc>& str,
+               const CharT* chars = detail::ascii_whitespace<CharT>())
+{
+    detail::char_set<CharT, Traits> set(chars, Traits::length(chars));
+    const CharT* first = str.data();
+    const CharT* last = first + str.size();
+    while (last != first && set.contains(last[-1]))
+        --last;
+    str.erase(last - first);
+    return str;
+}
+
+template<class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>&
+    trim(basic_string<CharT, Traits, Alloc>& str,
+         const CharT* chars = detail::ascii_whitespace<CharT>())
+{
+    // trimming the end first leaves fewer characters to move
+    trim_right(str, chars);
+    return trim_left(str, chars);
+}
+
+// Converts ASCII letters to lower case. Other characters are left unchanged.
+template<class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>& to_lower_ascii(basic_string<CharT, Traits, Alloc>& str)
+{
+    if (!str.empty())
+        detail::flip_ascii_case(&str[0], str.size(), 'A');
+    return str;
+}
+
+// Converts ASCII letters to upper case. Other characters are left unchanged.
+template<class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>& to_upper_ascii(basic_string<CharT, Traits, Alloc>& str)
+{
+    if (!str.empty())
+        detail::flip_ascii_case(&str[0], str.size(), 'a');
+    return str;
+}
+
+/*  Replaces each character ch of a string of single-byte characters with
+    table[(unsigned char) ch]. Use tidy::erase and tidy::erase_if to remove
+    characters.
+*/
+template<class CharT, class Traits, class Alloc>
+basic_string<CharT, Traits, Alloc>&
+    translate(basic_string<CharT, Traits, Alloc>& str, const CharT (&table)[256])
+{
+    static_assert(sizeof(CharT) == 1, "translate requires single-byte characters");
+    CharT* p = str.empty() ? nullptr : &str[0];
+    for (std::size_t i = 0, size = str.size(); i < size; ++i)
+        p[i] = table[static_cast<unsigned char>(p[i])];
+    return str;
+}
+
+namespace detail {
+
+// Sets badbit after an exception has been thrown during formatted I/O.
+// Rethrows the exception if the stream is configured to throw on badbit.
+template<class Stream>
+void set_badbit_after_exception(Stream& s)
+{
+    try {
+        s.setstate(std::ios_base::badbit);
+    } catch (const std::ios_base::failure&) {
+    }
+    if (s.exceptions() & std::ios_base::badbit)
+        throw;
+}
+
+template<class CharT, class Traits>
+bool put_fill(std::basic_streambuf<CharT, Traits>* sb, CharT fill, std::streamsize count)
+{
+    for (; count > 0; --count) {
+        if (Traits::eq_int_type(sb->sputc(fill), Traits::eof()))
+            return false;
+    }
+    return true;
+}
+
+} // namespace detail
+
+/*  Writes the string directly to the stream buffer. The contents are not
+    copied anywhere else.
+*/
 template<class CharT, class Traits, class Alloc>
 inline std::basic_ostream<CharT, Traits>&
     operator<<(std::basic_ostream<CharT, Traits>& os,
                const basic_string<CharT, Traits, Alloc>& str)
 {
-    // Use basic_string functionality because it might handle nul characters
-    // differently
-    std::basic_string<CharT, Traits, Alloc> std_str;
-    std_str.assign(str.data(), str.size());
-    os << std_str;
+    typename std::basic_ostream<CharT, Traits>::sentry sentry(os);
+    if (!sentry)
+        return os;
+
+    try {
+        std::streamsize size = str.size();
+        std::streamsize pad = std::max<std::streamsize>(os.width() - size, 0);
+        bool left = (os.flags() & std::ios_base::adjustfield) == std::ios_base::left;
+        auto* sb = os.rdbuf();
+
+        bool ok = left || detail::put_fill(sb, os.fill(), pad);
+        ok = ok && sb->sputn(str.data(), size) == size;
+        ok = ok && (!left || detail::put_fill(sb, os.fill(), pad));
+        os.width(0);
+        if (!ok)
+            os.setstate(std::ios_base::badbit);
+    } catch (...) {
+        detail::set_badbit_after_exception(os);
+    }
     return os;
 }
 
+namespace detail {
+
+/*  Gives access to the get area of a stream buffer. Pointers to protected
+    members of the base class can be formed within a derived class and then
+    used on any object of the base class.
+*/
+template<class CharT, class Traits>
+struct get_area_access : public std::basic_streambuf<CharT, Traits> {
+    using streambuf_type = std::basic_streambuf<CharT, Traits>;
+
+    static CharT* begin(streambuf_type* sb)
+    {
+        return (sb->*(&get_area_access::gptr))();
+    }
+
+    static CharT* end(streambuf_type* sb)
+    {
+        return (sb->*(&get_area_access::egptr))();
+    }
+
+    static void advance(streambuf_type* sb, std::size_t count)
+    {
+        for (; count > INT_MAX; count -= INT_MAX)
+            (sb->*(&get_area_access::gbump))(INT_MAX);
+        (sb->*(&get_area_access::gbump))(int(count));
+    }
+};
+
+} // namespace detail
+
+/*  Reads a whitespace-delimited word directly from the stream buffer. The
+    buffered characters are scanned for whitespace in bulk and each run of
+    characters is appended to the string at once, thus no other copies of
+    the word are made.
+*/
 template<class CharT, class Traits, class Alloc>
 inline std::basic_istream<CharT, Traits>&
     operator>>(std::basic_istream<CharT, Traits>& is,
                basic_string<CharT, Traits, Alloc>& str)
 {
-    // Use basic_string functionality because it might handle nul characters
-    // differently
-    std::basic_string<CharT, Traits, Alloc> std_str;
-    is >> std_str;
-    str.assign(std_str.data(), std_str.size());
+    typename std::basic_istream<CharT, Traits>::sentry sentry(is);
+    if (!sentry)
+        return is;
+
+    using access = detail::get_area_access<CharT, Traits>;
+    using size_type = typename basic_string<CharT, Traits, Alloc>::size_type;
+    size_type extracted = 0;
+    std::ios_base::iostate state = std::ios_base::goodbit;
+
+    try {
+        str.clear();
+        size_type limit = str.max_size();
+        if (is.width() > 0)
+            limit = std::min<size_type>(limit, is.width());
+
+        const auto& ctype = std::use_facet<std::ctype<CharT>>(is.getloc());
+        auto* sb = is.rdbuf();
+        while (extracted < limit) {
+            const CharT* first = access::begin(sb);
+            const CharT* last = access::end(sb);
+            if (first == last) {
+                auto c = sb->sgetc();
+                if (Traits::eq_int_type(c, Traits::eof())) {
+                    state |= std::ios_base::eofbit;
+                    break;
+                }
+                first = access::begin(sb);
+                last = access::end(sb);
+                if (first == last) {
+                    // unbuffered stream buffer
+                    CharT ch = Traits::to_char_type(c);
+                    if (ctype.is(std::ctype_base::space, ch))
+                        break;
+                    str.push_back(ch);
+                    sb->sbumpc();
+                    ++extracted;
+                    continue;
+                }
+            }
+
+            if (size_type(last - first) > limit - extracted)
+                last = first + (limit - extracted);
+            const CharT* space = ctype.scan_is(std::ctype_base::space, first, last);
+            size_type run = space - first;
+            str.append(first, run);
+            access::advance(sb, run);
+            extracted += run;
+            if (space != last)
+                break;
+        }
+        is.width(0);
+    } catch (...) {
+        detail::set_badbit_after_exception(is);
+        return is;
+    }
+    if (extracted == 0)
+        state |= std::ios_base::failbit;
+    is.setstate(state);
+    return is;
+}
+
+/*  Reads characters until delim into the string, like std::getline. The
+    buffered characters of the stream buffer are searched for delim in bulk
+    and each run of characters is appended at once, thus no other copies of
+    the line are made. The capacity of str is reused.
+*/
+template<class CharT, class Traits, class Alloc>
+std::basic_istream<CharT, Traits>&
+    getline(std::basic_istream<CharT, Traits>& is,
+            basic_string<CharT, Traits, Alloc>& str, CharT delim)
+{
+    typename std::basic_istream<CharT, Traits>::sentry sentry(is, true);
+    if (!sentry)
+        return is;
+
+    using access = detail::get_area_access<CharT, Traits>;
+    using size_type = typename basic_string<CharT, Traits, Alloc>::size_type;
+    std::ios_base::iostate state = std::ios_base::goodbit;
+    size_type extracted = 0;
+
+    try {
+        str.clear();
+        auto* sb = is.rdbuf();
+        while (true) {
+            const CharT* first = access::begin(sb);
+            const CharT* last = access::end(sb);
+            if (first == last) {
+                auto c = sb->sgetc();
+                if (Traits::eq_int_type(c, Traits::eof())) {
+                    state |= std::ios_base::eofbit;
+                    break;
+                }
+                first = access::begin(sb);
+                last = access::end(sb);
+                if (first == last) {
+                    // unbuffered stream buffer
+                    sb->sbumpc();
+                    ++extracted;
+                    CharT ch = Traits::to_char_type(c);
+                    if (Traits::eq(ch, delim))
+                        break;
+                    if (str.size() == str.max_size()) {
+                        state |= std::ios_base::failbit;
+                        break;
+                    }
+                    str.push_back(ch);
+                    continue;
+                }
+            }
+
+            const CharT* found = Traits::find(first, last - first, delim);
+            size_type run = (found ? found : last) - first;
+            size_type room = str.max_size() - str.size();
+            if (run > room) {
+                str.append(first, room);
+                access::advance(sb, room);
+                state |= std::ios_base::failbit;
+                break;
+            }
+            str.append(first, run);
+            access::advance(sb, run);
+            extracted += run;
+            if (found) {
+                sb->sbumpc();
+                ++extracted;
+                break;
+            }
+        }
+    } catch (...) {
+        detail::set_badbit_after_exception(is);
+        return is;
+    }
+    if (extracted == 0)
+        state |= std::ios_base::failbit;
+    is.setstate(state);
     return is;
 }
 
+template<class CharT, class Traits, class Alloc>
+std::basic_istream<CharT, Traits>&
+    getline(std::basic_istream<CharT, Traits>&& is,
+            basic_string<CharT, Traits, Alloc>& str, CharT delim)
+{
+    return getline(is, str, delim);
+}
+
+template<class CharT, class Traits, class Alloc>
+std::basic_istream<CharT, Traits>&
+    getline(std::basic_istream<CharT, Traits>& is,
+            basic_string<CharT, Traits, Alloc>& str)
+{
+    return getline(is, str, is.widen('\n'));
+}
+
+template<class CharT, class Traits, class Alloc>
+std::basic_istream<CharT, Traits>&
+    getline(std::basic_istream<CharT, Traits>&& is,
+            basic_string<CharT, Traits, Alloc>& str)
+{
+    return getline(is, str, is.widen('\n'));
+}
+
 } // namespace tidy
 
 #endif
@@ -0,0 +1,871 @@
+/*  Copyright (C) 2017  Povilas Kanapickas <povilas@radix.lt>
+
+    Distributed under the Boost Software License, Version 1.0.
+        (See accompanying file LICENSE_1_0.txt or copy at
+            http://www.boost.org/LICENSE_1_0.txt)
+*/
+
+#ifndef TIDY_TIDYUNORDEREDFLATMAP_H
+#define TIDY_TIDYUNORDEREDFLATMAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "tidyhash.h"
+#include "tidyvector.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TIDY_FLAT_MAP_SSE2 1
+#endif
+
+namespace tidy {
+namespace detail {
+
+/*  Control bytes of the flat hash map. Each slot has one control byte which
+    is either empty, deleted or holds the low 7 bits of the hash of the key
+    in the slot. Empty and deleted have the high bit set.
+*/
+typedef signed char flat_ctrl;
+static const flat_ctrl flat_ctrl_empty = -128;
+static const flat_ctrl flat_ctrl_deleted = -2;
+static const std::size_t flat_group_width = 16;
+
+/*  A group of flat_group_width consecutive control bytes. The match
+    functions return a bit mask with bit i set if byte i matches.
+*/
+#if TIDY_FLAT_MAP_SSE2
+class flat_group {
+public:
+    explicit flat_group(const flat_ctrl* p) :
+        ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)))
+    {}
+
+    unsigned match(flat_ctrl h2) const
+    {
+        return unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_)));
+    }
+
+    unsigned match_empty() const { return match(flat_ctrl_empty); }
+
+    // empty and deleted bytes are the ones with the high bit set
+    unsigned match_empty_or_deleted() const
+    {
+        return unsigned(_mm_movemask_epi8(ctrl_));
+    }
+
+private:
+    __m128i ctrl_;
+};
+#else
+class flat_group {
+public:
+    explicit flat_group(const flat_ctrl* p) : ctrl_(p) {}
+
+    unsigned match(flat_ctrl h2) const
+    {
+        unsigned result = 0;
+        for (std::size_t i = 0; i < flat_group_width; ++i) {
+            if (ctrl_[i] == h2)
+                result |= 1u << i;
+        }
+        return result;
+    }
+
+    unsigned match_empty() const { return match(flat_ctrl_empty); }
+
+    unsigned match_empty_or_deleted() const
+    {
+        unsigned result = 0;
+        for (std::size_t i = 0; i < flat_group_width; ++i) {
+            if (ctrl_[i] < 0)
+                result |= 1u << i;
+        }
+        return result;
+    }
+
+private:
+    const flat_ctrl* ctrl_;
+};
+#endif
+
+// Spreads the bits of the given hash so that weak hash functions, e.g. the
+// identity hash of integers, still produce well distributed control bytes
+inline std::size_t mix_hash(std::size_t hash)
+{
+    std::uint64_t h = std::uint64_t(hash) * 0x9e3779b97f4a7c15ull;
+    return std::size_t(h ^ (h >> 32));
+}
+
+template<class Map, class Value>
+class flat_map_iterator {
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Value value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef Value* pointer;
+    typedef Value& reference;
+
+    flat_map_iterator() : ctrl_(nullptr), slot_(nullptr), end_(nullptr) {}
+
+    // allows conversion from iterator to const_iterator
+    template<class OtherValue, class = typename std::enable_if<
+                 std::is_convertible<OtherValue*, Value*>::value>::type>
+    flat_map_iterator(const flat_map_iterator<Map, OtherValue>& other) :
+        ctrl_(other.ctrl_), slot_(other.slot_), end_(other.end_)
+    {}
+
+    reference operator*() const { return *slot_; }
+    pointer operator->() const { return slot_; }
+
+    flat_map_iterator& operator++()
+    {
+        ++ctrl_;
+        ++slot_;
+        skip_free();
+        return *this;
+    }
+
+    flat_map_iterator operator++(int)
+    {
+        flat_map_iterator copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    friend bool operator==(const flat_map_iterator& a, const flat_map_iterator& b)
+    {
+        return a.ctrl_ == b.ctrl_;
+    }
+
+    friend bool operator!=(const flat_map_iterator& a, const flat_map_iterator& b)
+    {
+        return a.ctrl_ != b.ctrl_;
+    }
+
+private:
+    template<class, class> friend class flat_map_iterator;
+    friend Map;
+
+    flat_map_iterator(const flat_ctrl* ctrl, Value* slot, const flat_ctrl* end) :
+        ctrl_(ctrl), slot_(slot), end_(end)
+    {}
+
+    void skip_free()
+    {
+        while (ctrl_ != end_ && *ctrl_ < 0) {
+            ++ctrl_;
+            ++slot_;
+        }
+    }
+
+    const flat_ctrl* ctrl_;
+    Value* slot_;
+    const flat_ctrl* end_;
+};
+
+} // namespace detail
+
+/*  An unordered map with open addressing that stores the elements directly
+    in a single array of slots instead of allocating a node for each of
+    them. The layout follows the SwissTable design: each slot has a control
+    byte holding 7 bits of the hash of its key, and lookups compare 16
+    control bytes at a time, using SSE2 where available.
+
+    The memory is handled like in tidy::vector. Erased elements are destroyed
+    and their slots wiped. When the map grows, the elements are moved to new
+    arrays and the old ones are wiped before they are released. The element
+    types themselves must wipe any memory they own, e.g. tidy::string and
+    tidy::vector. For keys that should not allocate at all, use
+    tidy::basic_static_string.
+
+    Insertion and rehashing invalidate all iterators. Erasure invalidates only
+    the iterators to the erased element. The maximum load factor is 7/8.
+*/
+template<class Key, class T, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>,
+         class Allocator = std::allocator<std::pair<const Key, T>>>
+class unordered_flat_map {
+    // The elements are stored as pair<Key, T> so that they can be moved on
+    // rehash, and are accessed as pair<const Key, T> like in std::unordered_map
+    typedef std::pair<Key, T> slot_type;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<slot_type>
+        slot_allocator;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<detail::flat_ctrl>
+        ctrl_allocator;
+    typedef std::allocator_traits<slot_allocator> slot_traits;
+    typedef std::allocator_traits<ctrl_allocator> ctrl_traits;
+public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::pair<const Key, T> value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef Hash hasher;
+    typedef KeyEqual key_equal;
+    typedef Allocator allocator_type;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+    typedef value_type* pointer;
+    typedef const value_type* const_pointer;
+    typedef detail::flat_map_iterator<unordered_flat_map, value_type> iterator;
+    typedef detail::flat_map_iterator<unordered_flat_map, const value_type> const_iterator;
+
+    unordered_flat_map() : unordered_flat_map(0) {}
+
+    explicit unordered_flat_map(size_type bucket_count, const Hash& hash = Hash(),
+                                const KeyEqual& equal = KeyEqual(),
+                                const Allocator& alloc = Allocator()) :
+        hash_(hash), equal_(equal), slot_alloc_(alloc), ctrl_alloc_(alloc),
+        ctrl_(nullptr), slots_(nullptr), capacity_(0), size_(0), growth_left_(0)
+    {
+        if (bucket_count > 0)
+            rehash(bucket_count);
+    }
+
+    explicit unordered_flat_map(const Allocator& alloc) :
+        unordered_flat_map(0, Hash(), KeyEqual(), alloc)
+    {}
+
+    template<class InputIt>
+    unordered_flat_map(InputIt first, InputIt last, size_type bucket_count = 0,
+                       const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                       const Allocator& alloc = Allocator()) :
+        unordered_flat_map(bucket_count, hash, equal, alloc)
+    {
+        insert(first, last);
+    }
+
+    unordered_flat_map(std::initializer_list<value_type> init, size_type bucket_count = 0,
+                       const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                       const Allocator& alloc = Allocator()) :
+        unordered_flat_map(init.begin(), init.end(), bucket_count, hash, equal, alloc)
+    {}
+
+    unordered_flat_map(const unordered_flat_map& other) :
+        unordered_flat_map(0, other.hash_, other.equal_,
+                           std::allocator_traits<Allocator>::select_on_container_copy_construction(
+                               Allocator(other.slot_alloc_)))
+    {
+        reserve(other.size());
+        for (const auto& v : other)
+            insert_unique(v.first, v.second);
+    }
+
+    unordered_flat_map(unordered_flat_map&& other) noexcept :
+        hash_(std::move(other.hash_)), equal_(std::move(other.equal_)),
+        slot_alloc_(std::move(other.slot_alloc_)), ctrl_alloc_(std::move(other.ctrl_alloc_)),
+        ctrl_(other.ctrl_), slots_(other.slots_), capacity_(other.capacity_),
+        size_(other.size_), growth_left_(other.growth_left_)
+    {
+        other.ctrl_ = nullptr;
+        other.slots_ = nullptr;
+        other.capacity_ = other.size_ = other.growth_left_ = 0;
+    }
+
+    unordered_flat_map& operator=(const unordered_flat_map& other)
+    {
+        if (this != &other) {
+            unordered_flat_map copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    unordered_flat_map& operator=(unordered_flat_map&& other) noexcept
+    {
+        if (this != &other) {
+            unordered_flat_map temp(std::move(other));
+            swap(temp);
+        }
+        return *this;
+    }
+
+    unordered_flat_map& operator=(std::initializer_list<value_type> init)
+    {
+        clear();
+        insert(init.begin(), init.end());
+        return *this;
+    }
+
+    ~unordered_flat_map()
+    {
+        destroy_all();
+        deallocate(ctrl_, slots_, capacity_);
+    }
+
+    allocator_type get_allocator() const { return allocator_type(slot_alloc_); }
+    hasher hash_function() const { return hash_; }
+    key_equal key_eq() const { return equal_; }
+
+    iterator begin() noexcept
+    {
+        iterator it(ctrl_, as_value(slots_), ctrl_ + capacity_);
+        it.skip_free();
+        return it;
+    }
+
+    const_iterator begin() const noexcept
+    {
+        const_iterator it(ctrl_, as_value(slots_), ctrl_ + capacity_);
+        it.skip_free();
+        return it;
+    }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+
+    iterator end() noexcept
+    {
+        return iterator(ctrl_ + capacity_, as_value(slots_ + capacity_), ctrl_ + capacity_);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(ctrl_ + capacity_, as_value(slots_ + capacity_),
+                              ctrl_ + capacity_);
+    }
+
+    const_iterator cend() const noexcept { return end(); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    size_type max_size() const noexcept
+    {
+        return std::min<size_type>(slot_traits::max_size(slot_alloc_),
+                                   std::numeric_limits<difference_type>::max() / 2);
+    }
+
+    size_type bucket_count() const noexcept { return capacity_; }
+    float load_factor() const noexcept
+    {
+        return capacity_ == 0 ? 0.0f : float(size_) / float(capacity_);
+    }
+    float max_load_factor() const noexcept { return 7.0f / 8.0f; }
+    void max_load_factor(float) noexcept {}
+
+    // Destroys all elements and wipes their slots. The capacity is kept.
+    void clear() noexcept
+    {
+        destroy_all();
+        detail::secure_delete_range(slots_, slots_ + capacity_);
+        reset_ctrl();
+        size_ = 0;
+        growth_left_ = max_load(capacity_);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        return try_emplace(value.first, value.second);
+    }
+
+    template<class P, class = typename std::enable_if<
+                 std::is_constructible<value_type, P&&>::value>::type>
+    std::pair<iterator, bool> insert(P&& value)
+    {
+        return emplace(std::forward<P>(value));
+    }
+
+    iterator insert(const_iterator, const value_type& value)
+    {
+        return insert(value).first;
+    }
+
+    template<class InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+            insert(*first);
+    }
+
+    void insert(std::initializer_list<value_type> init)
+    {
+        insert(init.begin(), init.end());
+    }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj)
+    {
+        auto result = try_emplace(key, std::forward<M>(obj));
+        if (!result.second)
+            result.first->second = std::forward<M>(obj);
+        return result;
+    }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign(Key&& key, M&& obj)
+    {
+        auto result = try_emplace(std::move(key), std::forward<M>(obj));
+        if (!result.second)
+            result.first->second = std::forward<M>(obj);
+        return result;
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> emplace(Args&& ... args)
+    {
+        // the element is constructed first to obtain the key
+        slot_type temp(std::forward<Args>(args)...);
+        return try_emplace(std::move(temp.first), std::move(temp.second));
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&& ... args)
+    {
+        return emplace_key(key, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&& ... args)
+    {
+        return emplace_key(std::move(key), std::forward<Args>(args)...);
+    }
+
+    T& operator[](const Key& key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    T& operator[](Key&& key)
+    {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    T& at(const Key& key)
+    {
+        iterator it = find(key);
+        if (it == end())
+            throw std::out_of_range("key not found");
+        return it->second;
+    }
+
+    const T& at(const Key& key) const
+    {
+        const_iterator it = find(key);
+        if (it == end())
+            throw std::out_of_range("key not found");
+        return it->second;
+    }
+
+    iterator find(const Key& key)
+    {
+        size_type i = find_index(key, detail::mix_hash(hash_(key)));
+        return i == npos ? end() : iterator_at(i);
+    }
+
+    const_iterator find(const Key& key) const
+    {
+        size_type i = find_index(key, detail::mix_hash(hash_(key)));
+        return i == npos ? end() : const_iterator_at(i);
+    }
+
+    size_type count(const Key& key) const { return find(key) == end() ? 0 : 1; }
+    bool contains(const Key& key) const { return find(key) != end(); }
+
+    std::pair<iterator, iterator> equal_range(const Key& key)
+    {
+        iterator it = find(key);
+        if (it == end())
+            return std::make_pair(it, it);
+        iterator next = it;
+        return std::make_pair(it, ++next);
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const Key& key) const
+    {
+        const_iterator it = find(key);
+        if (it == end())
+            return std::make_pair(it, it);
+        const_iterator next = it;
+        return std::make_pair(it, ++next);
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        size_type i = size_type(pos.ctrl_ - ctrl_);
+        erase_index(i);
+        iterator next = iterator_at(i);
+        next.skip_free();
+        return next;
+    }
+
+    iterator erase(iterator pos)
+    {
+        return erase(const_iterator(pos));
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        while (first != last)
+            first = erase(first);
+        return iterator_at(size_type(last.ctrl_ - ctrl_));
+    }
+
+    size_type erase(const Key& key)
+    {
+        size_type i = find_index(key, detail::mix_hash(hash_(key)));
+        if (i == npos)
+            return 0;
+        erase_index(i);
+        return 1;
+    }
+
+    void swap(unordered_flat_map& other) noexcept
+    {
+        using std::swap;
+        swap(hash_, other.hash_);
+        swap(equal_, other.equal_);
+        swap(slot_alloc_, other.slot_alloc_);
+        swap(ctrl_alloc_, other.ctrl_alloc_);
+        swap(ctrl_, other.ctrl_);
+        swap(slots_, other.slots_);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(growth_left_, other.growth_left_);
+    }
+
+    // Resizes the slot array so that it holds at least count slots and all
+    // elements fit within the maximum load factor
+    void rehash(size_type count)
+    {
+        size_type needed = std::max(count, min_capacity_for(size_));
+        if (needed == 0) {
+            if (size_ == 0) {
+                deallocate(ctrl_, slots_, capacity_);
+                ctrl_ = nullptr;
+                slots_ = nullptr;
+                capacity_ = growth_left_ = 0;
+            }
+            return;
+        }
+        size_type new_cap = detail::flat_group_width;
+        while (new_cap < needed)
+            new_cap *= 2;
+        if (new_cap != capacity_)
+            resize(new_cap);
+    }
+
+    void reserve(size_type count)
+    {
+        if (count > size_ + growth_left_)
+            rehash(min_capacity_for(count));
+    }
+
+private:
+    template<class, class> friend class detail::flat_map_iterator;
+
+    static const size_type npos = size_type(-1);
+
+    static size_type max_load(size_type capacity)
+    {
+        return capacity - capacity / 8;
+    }
+
+    static size_type min_capacity_for(size_type count)
+    {
+        if (count == 0)
+            return 0;
+        size_type capacity = detail::flat_group_width;
+        while (max_load(capacity) < count)
+            capacity *= 2;
+        return capacity;
+    }
+
+    /*  The slots hold pair<Key, T>, which is accessed through the public
+        interface as pair<const Key, T>. The two types have the same layout,
+        but strictly speaking this is type punning that the standard doesn't
+        sanction. Implementations of std::unordered_map and std::map use the
+        same technique (libc++ through a union of both pair types) for the
+        same reason: the keys must be movable on rehash, yet immutable for
+        the users.
+    */
+    static value_type* as_value(slot_type* slot)
+    {
+        return reinterpret_cast<value_type*>(slot);
+    }
+
+    iterator iterator_at(size_type i)
+    {
+        return iterator(ctrl_ + i, as_value(slots_ + i), ctrl_ + capacity_);
+    }
+
+    const_iterator const_iterator_at(size_type i) const
+    {
+        return const_iterator(ctrl_ + i, as_value(slots_ + i), ctrl_ + capacity_);
+    }
+
+    static detail::flat_ctrl h2(std::size_t hash)
+    {
+        return detail::flat_ctrl(hash & 0x7f);
+    }
+
+    static std::size_t h1(std::size_t hash)
+    {
+        return hash >> 7;
+    }
+
+    // The last flat_group_width control bytes mirror the first ones, so that
+    // a group can be loaded at any slot without wrapping around
+    static void set_ctrl(detail::flat_ctrl* ctrl, size_type capacity, size_type i,
+                         detail::flat_ctrl value)
+    {
+        ctrl[i] = value;
+        if (i < detail::flat_group_width)
+            ctrl[capacity + i] = value;
+    }
+
+    void set_ctrl(size_type i, detail::flat_ctrl value)
+    {
+        set_ctrl(ctrl_, capacity_, i, value);
+    }
+
+    static void reset_ctrl(detail::flat_ctrl* ctrl, size_type capacity)
+    {
+        if (ctrl != nullptr)
+            std::fill(ctrl, ctrl + capacity + detail::flat_group_width,
+                      detail::flat_ctrl_empty);
+    }
+
+    void reset_ctrl()
+    {
+        reset_ctrl(ctrl_, capacity_);
+    }
+
+    /*  Visits the groups of slots in the probe sequence of the given hash.
+        The groups start at triangular multiples of the group width, which
+        covers the whole table since the capacity is a power of two.
+    */
+    template<class F>
+    static size_type probe(const detail::flat_ctrl* ctrl, size_type capacity,
+                           std::size_t hash, F f)
+    {
+        size_type mask = capacity - 1;
+        size_type offset = h1(hash) & mask;
+        for (size_type step = detail::flat_group_width; ; step += detail::flat_group_width) {
+            size_type result = f(offset, detail::flat_group(ctrl + offset));
+            if (result != npos)
+                return result;
+            offset = (offset + step) & mask;
+        }
+    }
+
+    template<class F>
+    size_type probe(std::size_t hash, F f) const
+    {
+        return probe(ctrl_, capacity_, hash, f);
+    }
+
+    size_type find_index(const Key& key, std::size_t hash) const
+    {
+        if (size_ == 0)
+            return npos;
+        size_type mask = capacity_ - 1;
+        bool missing = false;
+        size_type result = probe(hash, [&](size_type offset,
+                                            const detail::flat_group& g) -> size_type {
+            for (unsigned m = g.match(h2(hash)); m != 0; m &= m - 1) {
+                size_type i = (offset + detail::count_trailing_zeros(m)) & mask;
+                if (equal_(slots_[i].first, key))
+                    return i;
+            }
+            if (g.match_empty() != 0) {
+                missing = true;
+                return size_type(0);
+            }
+            return npos;
+        });
+        return missing ? npos : result;
+    }
+
+    static size_type find_free(const detail::flat_ctrl* ctrl, size_type capacity,
+                               std::size_t hash)
+    {
+        size_type mask = capacity - 1;
+        return probe(ctrl, capacity, hash,
+                     [&](size_type offset, const detail::flat_group& g) -> size_type {
+            unsigned m = g.match_empty_or_deleted();
+            if (m == 0)
+                return npos;
+            return (offset + detail::count_trailing_zeros(m)) & mask;
+        });
+    }
+
+    size_type find_free(std::size_t hash) const
+    {
+        return find_free(ctrl_, capacity_, hash);
+    }
+
+    template<class K, class... Args>
+    std::pair<iterator, bool> emplace_key(K&& key, Args&& ... args)
+    {
+        std::size_t hash = detail::mix_hash(hash_(key));
+        size_type i = find_index(key, hash);
+        if (i != npos)
+            return std::make_pair(iterator_at(i), false);
+
+        if (growth_left_ == 0)
+            grow();
+        i = find_free(hash);
+        slot_traits::construct(slot_alloc_, slots_ + i, std::piecewise_construct,
+                               std::forward_as_tuple(std::forward<K>(key)),
+                               std::forward_as_tuple(std::forward<Args>(args)...));
+        // deleted slots don't count towards the growth limit again
+        if (ctrl_[i] == detail::flat_ctrl_empty)
+            --growth_left_;
+        set_ctrl(i, h2(hash));
+        ++size_;
+        return std::make_pair(iterator_at(i), true);
+    }
+
+    template<class K, class V>
+    void insert_unique(K&& key, V&& value)
+    {
+        emplace_key(std::forward<K>(key), std::forward<V>(value));
+    }
+
+    void erase_index(size_type i)
+    {
+        slot_traits::destroy(slot_alloc_, slots_ + i);
+        detail::secure_delete_range(slots_ + i, slots_ + i + 1);
+        set_ctrl(i, detail::flat_ctrl_deleted);
+        --size_;
+    }
+
+    // Called when there is no room for a new element: doubles the capacity,
+    // or only drops the deleted slots if they take a large part of it
+    void grow()
+    {
+        if (capacity_ > 0 && size_ <= max_load(capacity_) / 2)
+            resize(capacity_);
+        else
+            resize(capacity_ == 0 ? detail::flat_group_width : capacity_ * 2);
+    }
+
+    /*  Moves all elements to new arrays of the given capacity. The old arrays
+        are wiped and released.
+
+        The new table is built on the side and replaces the old one only once
+        all elements are in place. All positions are computed first, so a
+        throwing hasher leaves the map unchanged. The elements are then moved
+        with move_if_noexcept, so a throwing copy also leaves the old elements
+        intact.
+    */
+    void resize(size_type new_cap)
+    {
+        vector<size_type> targets;
+        targets.reserve(size_);
+
+        detail::flat_ctrl* new_ctrl = ctrl_traits::allocate(ctrl_alloc_,
+                                                            new_cap + detail::flat_group_width);
+        slot_type* new_slots;
+        try {
+            new_slots = slot_traits::allocate(slot_alloc_, new_cap);
+        } catch (...) {
+            ctrl_traits::deallocate(ctrl_alloc_, new_ctrl, new_cap + detail::flat_group_width);
+            throw;
+        }
+        reset_ctrl(new_ctrl, new_cap);
+
+        size_type moved = 0;
+        try {
+            for (size_type i = 0; i < capacity_; ++i) {
+                if (ctrl_[i] < 0)
+                    continue;
+                std::size_t hash = detail::mix_hash(hash_(slots_[i].first));
+                size_type j = find_free(new_ctrl, new_cap, hash);
+                set_ctrl(new_ctrl, new_cap, j, h2(hash));
+                targets.push_back(j);
+            }
+            for (size_type i = 0; i < capacity_; ++i) {
+                if (ctrl_[i] < 0)
+                    continue;
+                slot_traits::construct(slot_alloc_, new_slots + targets[moved],
+                                       std::move_if_noexcept(slots_[i]));
+                ++moved;
+            }
+        } catch (...) {
+            for (size_type k = 0; k < moved; ++k)
+                slot_traits::destroy(slot_alloc_, new_slots + targets[k]);
+            deallocate(new_ctrl, new_slots, new_cap);
+            throw;
+        }
+
+        destroy_all();
+        deallocate(ctrl_, slots_, capacity_);
+        ctrl_ = new_ctrl;
+        slots_ = new_slots;
+        capacity_ = new_cap;
+        growth_left_ = max_load(new_cap) - size_;
+    }
+
+    // Destroys all elements. Their slots are wiped by the caller, either
+    // directly or when the arrays are released.
+    void destroy_all() noexcept
+    {
+        for (size_type i = 0; i < capacity_; ++i) {
+            if (ctrl_[i] >= 0)
+                slot_traits::destroy(slot_alloc_, slots_ + i);
+        }
+    }
+
+    // Wipes and releases the arrays
+    void deallocate(detail::flat_ctrl* ctrl, slot_type* slots, size_type capacity) noexcept
+    {
+        if (ctrl == nullptr)
+            return;
+        detail::secure_delete_range(slots, slots + capacity);
+        detail::secure_delete_range(ctrl, ctrl + capacity + detail::flat_group_width);
+        slot_traits::deallocate(slot_alloc_, slots, capacity);
+        ctrl_traits::deallocate(ctrl_alloc_, ctrl, capacity + detail::flat_group_width);
+    }
+
+    hasher hash_;
+    key_equal equal_;
+    slot_allocator slot_alloc_;
+    ctrl_allocator ctrl_alloc_;
+    detail::flat_ctrl* ctrl_;
+    slot_type* slots_;
+    size_type capacity_;
+    size_type size_;
+    size_type growth_left_;
+};
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+bool operator==(const unordered_flat_map<Key, T, Hash, KeyEqual, Allocator>& lhs,
+                const unordered_flat_map<Key, T, Hash, KeyEqual, Allocator>& rhs)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+    for (const auto& v : lhs) {
+        auto it = rhs.find(v.first);
+        if (it == rhs.end() || !(it->second == v.second))
+            return false;
+    }
+    return true;
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+bool operator!=(const unordered_flat_map<Key, T, Hash, KeyEqual, Allocator>& lhs,
+                const unordered_flat_map<Key, T, Hash, KeyEqual, Allocator>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template<class Key, class T, class Hash, class KeyEqual, class Allocator>
+void swap(unordered_flat_map<Key, T, Hash, KeyEqual, Allocator>& lhs,
+          unordered_flat_map<Key, T, Hash, KeyEqual, Allocator>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace tidy
+
+#endif
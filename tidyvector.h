@@ -10,9 +10,14 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
 #include <iterator>
+#include <limits>
 #include <memory>
-#include <vector>
+#include <stdexcept>
 #include <type_traits>
 
 namespace tidy {
@@ -43,7 +48,7 @@ struct is_input_iterator : public is_iterator_tag<T, std::input_iterator_tag> {}
 template<class T>
 struct is_forward_iterator : public is_iterator_tag<T, std::forward_iterator_tag> {};
 
-static void secure_delete(const void* ptr, unsigned size)
+static void secure_delete(const void* ptr, std::size_t size)
 {
     // This function might be the last thing that uses the data in question
     // so we want to fool dead-code optimizations of the compiler to not
@@ -61,114 +66,214 @@ static void secure_delete_range(T* begin, T* end)
     secure_delete(begin, (end - begin) * sizeof(T));
 }
 
-template<class T, class Alloc>
-static void secure_delete_vector(std::vector<T,Alloc>& v)
+/*  Whether move-assignment of containers using the given allocator can reuse
+    the storage of the source container. If it can't, the elements must be
+    copied into new storage, which may throw.
+*/
+template<class Alloc>
+struct is_nothrow_move_assignable_alloc :
+        public std::integral_constant<
+            bool,
+            std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+            std::allocator_traits<Alloc>::is_always_equal::value
+        >
+{};
+
+/*  Whether a range given by iterators of type It can be copied into storage
+    of T using memcpy.
+*/
+template<class It, class T>
+struct is_bitwise_copy_source :
+        public std::integral_constant<
+            bool,
+            std::is_trivially_copyable<T>::value &&
+            (std::is_same<It, T*>::value || std::is_same<It, const T*>::value)
+        >
+{};
+
+// memcpy that accepts null pointers when count is zero
+inline void copy_bytes(void* dest, const void* src, std::size_t count)
 {
-    using value_type = typename std::vector<T,Alloc>::value_type;
-    if (v.size() > 0)
-        secure_delete(v.data(), v.size() * sizeof(value_type));
+    if (count > 0)
+        std::memcpy(dest, src, count);
 }
 
-template<class T, class Alloc>
-static void secure_delete_vector_capacity(std::vector<T,Alloc>& v)
+// Returns the index of the lowest set bit of the non-zero mask, e.g. of the
+// first matching byte in the result of _mm_movemask_epi8
+inline unsigned count_trailing_zeros(unsigned mask)
 {
-    using value_type = typename std::vector<T,Alloc>::value_type;
-    if (v.size() > 0)
-        secure_delete(v.data(), v.capacity() * sizeof(value_type));
+#if defined(__GNUC__)
+    return unsigned(__builtin_ctz(mask));
+#else
+    unsigned result = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        ++result;
+    }
+    return result;
+#endif
 }
 
 } // namespace detail
 
+/*  Whether objects of type T can be moved to a different address by copying
+    their bytes, without calling the move constructor on the new location and
+    the destructor on the old one. tidy::vector uses memcpy and memmove for
+    such types when growing, inserting and erasing.
+
+    This is true for trivially copyable types. Specialize it for other types
+    that don't store pointers to themselves, e.g. classes holding a
+    std::unique_ptr.
+*/
+template<class T>
+struct is_trivially_relocatable : public std::is_trivially_copyable<T> {};
+
 /*  A vector class that does not leak information to memory. That is, upon
     descruction, no traces of the contents of the vector can be found in memory
     regardless of operations that are applied to the vector.
 
-    Only trivial types are supported. In addition to that, the class depends
-    on std::vector not doing any deallocations on move-assignment or swap.
+    Removed elements are destroyed first and then the memory they occupied is
+    wiped. The storage past the last element is kept wiped at all times, thus
+    only the elements need to be wiped on destruction. The vector can't wipe
+    the memory the elements themselves allocate, thus element types that own
+    memory should wipe it in their destructors.
+
+    Elements of types for which is_trivially_relocatable is true are moved
+    using memcpy and memmove. Other types are moved element by element.
 */
 template<class T, class Allocator = std::allocator<T>>
 class vector {
+    using alloc_traits = std::allocator_traits<Allocator>;
 public:
-    static_assert(std::is_trivial<T>::value,
-                  "Only trivial types are supported");
-
-    using container_type = std::vector<T, Allocator>;
-
     typedef T value_type;
     typedef Allocator allocator_type;
-    typedef typename container_type::size_type size_type;
-    typedef typename container_type::difference_type difference_type;
+    typedef typename alloc_traits::size_type size_type;
+    typedef typename alloc_traits::difference_type difference_type;
     typedef value_type& reference;
     typedef const value_type& const_reference;
-    typedef typename std::allocator_traits<Allocator>::pointer pointer;
-    typedef typename std::allocator_traits<Allocator>::const_pointer const_pointer;
-    typedef typename container_type::iterator iterator;
-    typedef typename container_type::const_iterator const_iterator;
+    typedef typename alloc_traits::pointer pointer;
+    typedef typename alloc_traits::const_pointer const_pointer;
+    typedef value_type* iterator;
+    typedef const value_type* const_iterator;
     typedef std::reverse_iterator<iterator> reverse_iterator;
     typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
 
-    vector() {}
+    // The elements used to be held in a std::vector that container() gave
+    // access to. They are now held directly, so both refer to the vector
+    // itself, which has the same interface.
+    typedef vector container_type;
 
-    explicit vector(const Allocator& alloc) : data_(alloc) {}
+    vector() noexcept(std::is_nothrow_default_constructible<Allocator>::value) :
+        begin_(nullptr), size_(0), capacity_(0)
+    {}
+
+    explicit vector(const Allocator& alloc) noexcept :
+        alloc_(alloc), begin_(nullptr), size_(0), capacity_(0)
+    {}
 
-    vector(size_type count, const T& value) : data_(count, value) {}
+    vector(size_type count, const T& value) : vector()
+    {
+        assign(count, value);
+    }
 
     vector(size_type count, const T& value,
            const Allocator& alloc) :
-        data_(count, value, alloc)
-    {}
+        vector(alloc)
+    {
+        assign(count, value);
+    }
 
-    explicit vector(size_type n) : data_(n) {}
-    explicit vector(size_type n, const Allocator& alloc) : data_(n, alloc) {}
+    explicit vector(size_type n) : vector()
+    {
+        construct_default(n);
+    }
 
-    template<class InputIt>
-    vector(InputIt first, InputIt last) : data_(first, last) {}
+    explicit vector(size_type n, const Allocator& alloc) : vector(alloc)
+    {
+        construct_default(n);
+    }
 
-    template<class InputIt>
+    template<class InputIt, class = typename std::enable_if<
+                 detail::is_input_iterator<InputIt>::value>::type>
+    vector(InputIt first, InputIt last) : vector()
+    {
+        assign(first, last);
+    }
+
+    template<class InputIt, class = typename std::enable_if<
+                 detail::is_input_iterator<InputIt>::value>::type>
     vector(InputIt first, InputIt last,
-           const Allocator& alloc) : data_(first, last, alloc)
-    {}
+           const Allocator& alloc) :
+        vector(alloc)
+    {
+        assign(first, last);
+    }
 
-    vector(const vector& other) : data_(other.data_) {}
-    vector(const vector& other, const Allocator& alloc) : data_(other.data_, alloc) {}
+    vector(const vector& other) :
+        vector(alloc_traits::select_on_container_copy_construction(other.alloc_))
+    {
+        assign(other.begin(), other.end());
+    }
 
-    vector(vector&& other) : data_(std::move(other.data_))
+    vector(const vector& other, const Allocator& alloc) : vector(alloc)
     {
-        detail::secure_delete_vector_capacity(other.data_);
+        assign(other.begin(), other.end());
     }
 
-    vector(vector&& other, const Allocator& alloc) : data_(std::move(other.data_), alloc)
+    vector(vector&& other) noexcept : vector(std::move(other.alloc_))
     {
-        detail::secure_delete_vector_capacity(other.data_);
+        steal(other);
     }
 
-    vector(std::initializer_list<T> init) : data_(init) {}
+    vector(vector&& other, const Allocator& alloc) : vector(alloc)
+    {
+        if (alloc_ == other.alloc_) {
+            steal(other);
+        } else {
+            assign(std::make_move_iterator(other.begin()),
+                   std::make_move_iterator(other.end()));
+            other.release_storage();
+        }
+    }
+
+    vector(std::initializer_list<T> init) : vector()
+    {
+        assign(init);
+    }
 
     vector(std::initializer_list<T> init,
            const Allocator& alloc) :
-        data_(init, alloc)
-    {}
+        vector(alloc)
+    {
+        assign(init);
+    }
 
-    ~vector()
+    ~vector() noexcept
     {
-        detail::secure_delete_vector(data_);
+        release_storage();
     }
 
     vector& operator=(const vector& other)
     {
-        if (this != &other)
-        {
-            detail::secure_delete_vector(data_);
-            data_ = other.data_;
+        if (this != &other) {
+            if (alloc_traits::propagate_on_container_copy_assignment::value) {
+                // the storage must be released by the allocator it came from
+                if (alloc_ != other.alloc_)
+                    release_storage();
+                alloc_ = other.alloc_;
+            }
+            assign(other.begin(), other.end());
         }
         return *this;
     }
 
     vector& operator=(vector&& other)
+        noexcept(detail::is_nothrow_move_assignable_alloc<Allocator>::value)
     {
-        detail::secure_delete_vector(data_);
-        data_ = std::move(other.data_);
-        detail::secure_delete_vector_capacity(other.data_);
+        if (this != &other) {
+            release_storage();
+            move_assign(other, typename alloc_traits::propagate_on_container_move_assignment());
+        }
         return *this;
     }
 
@@ -180,8 +285,14 @@ public:
 
     void assign(size_type count, const value_type& value)
     {
+        if (is_element(value)) {
+            value_type copy(value);
+            assign(count, copy);
+            return;
+        }
         clear();
-        resize(count, value);
+        reserve(count);
+        insert(end(), count, value);
     }
 
     template<class InputIt>
@@ -193,7 +304,7 @@ public:
     {
         clear();
         for (; first != last; ++first)
-            push_back(*first);
+            emplace_back(*first);
     }
 
     template<class ForwardIt>
@@ -205,8 +316,7 @@ public:
     {
         clear();
         reserve(std::distance(first, last));
-        for (; first != last; ++first)
-            push_back(*first);
+        insert(end(), first, last);
     }
 
     void assign(std::initializer_list<T> ilist)
@@ -214,80 +324,119 @@ public:
         assign(ilist.begin(), ilist.end());
     }
 
-    allocator_type get_allocator() const { return data_.get_allocator(); }
+    allocator_type get_allocator() const noexcept { return alloc_; }
 
     // element access
-    reference       at(size_type n) { return data_.at(n); }
-    const_reference at(size_type n) const { return data_.at(n); }
-    reference       operator[](size_type n) { return data_[n]; }
-    const_reference operator[](size_type n) const { return data_[n]; }
-
-    reference       front() { return data_.front(); }
-    const_reference front() const { return data_.front(); }
-    reference       back() { return data_.back(); }
-    const_reference back() const { return data_.back(); }
-    value_type*       data() { return data_.data(); }
-    const value_type* data() const { return data_.data(); }
+    reference at(size_type n)
+    {
+        if (n >= size())
+            throw std::out_of_range("n >= size()");
+        return begin_[n];
+    }
+
+    const_reference at(size_type n) const
+    {
+        if (n >= size())
+            throw std::out_of_range("n >= size()");
+        return begin_[n];
+    }
+
+    reference       operator[](size_type n) noexcept { return begin_[n]; }
+    const_reference operator[](size_type n) const noexcept { return begin_[n]; }
+
+    reference       front() noexcept { return begin_[0]; }
+    const_reference front() const noexcept { return begin_[0]; }
+    reference       back() noexcept { return begin_[size_ - 1]; }
+    const_reference back() const noexcept { return begin_[size_ - 1]; }
+    value_type*       data() noexcept { return begin_; }
+    const value_type* data() const noexcept { return begin_; }
 
     // iterators
-    iterator begin() { return data_.begin(); }
-    const_iterator begin() const { return data_.begin(); }
-    iterator end() { return data_.end(); }
-    const_iterator end() const { return data_.end(); }
+    iterator begin() noexcept { return begin_; }
+    const_iterator begin() const noexcept { return begin_; }
+    iterator end() noexcept { return begin_ + size_; }
+    const_iterator end() const noexcept { return begin_ + size_; }
 
-    reverse_iterator       rbegin() { return data_.rbegin(); }
-    const_reverse_iterator rbegin() const { return data_.rbegin(); }
-    reverse_iterator       rend() { return data_.rend(); }
-    const_reverse_iterator rend() const { return data_.rend(); }
+    reverse_iterator       rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
 
-    const_iterator         cbegin() const { return data_.cbegin(); }
-    const_iterator         cend() const { return data_.cend(); }
-    const_reverse_iterator crbegin() const { return data_.crbegin(); }
-    const_reverse_iterator crend() const { return data_.crend(); }
+    const_iterator         cbegin() const noexcept { return begin(); }
+    const_iterator         cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
 
     // capacity
-    bool empty() const { return data_.empty(); }
-    size_type size() const { return data_.size(); }
-    size_type max_size() const { return data_.max_size(); }
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+
+    size_type max_size() const noexcept
+    {
+        return std::min<size_type>(alloc_traits::max_size(alloc_),
+                                   std::numeric_limits<difference_type>::max() /
+                                       sizeof(value_type));
+    }
+
     void reserve(size_type n)
     {
+        if (n > max_size())
+            throw std::length_error("n > max_size()");
         if (n <= capacity())
             return;
         reallocate(n);
     }
 
-    size_type capacity() const { return data_.capacity(); }
+    size_type capacity() const noexcept { return capacity_; }
 
     void shrink_to_fit()
     {
-        reallocate(size());
+        if (size_ == capacity_)
+            return;
+        if (size_ == 0) {
+            release_storage();
+            return;
+        }
+        // the request is non-binding, thus allocation failures are ignored
+        try {
+            reallocate(size_);
+        } catch (...) {
+        }
     }
 
-    void clear()
+    void clear() noexcept
     {
-        detail::secure_delete_vector(data_);
-        data_.clear();
+        destroy_and_wipe(begin_, end());
+        size_ = 0;
     }
 
     iterator insert(const_iterator pos, const T& value)
     {
-        difference_type index = std::distance(cbegin(), pos);
-        reserve_grow(size() + 1);
-        return data_.insert(cbegin() + index, value);
+        return insert(pos, 1, value);
     }
 
     iterator insert(const_iterator pos, T&& value)
     {
-        difference_type index = std::distance(cbegin(), pos);
-        reserve_grow(size() + 1);
-        return data_.insert(cbegin() + index, std::move(value));
+        difference_type index = pos - cbegin();
+        if (is_element(value)) {
+            value_type copy(std::move(value));
+            return insert(begin_ + index, std::move(copy));
+        }
+        return insert_constructed(index, 1, [&](value_type* p) {
+            alloc_traits::construct(alloc_, p, std::move(value));
+        });
     }
 
     iterator insert(const_iterator pos, size_type count, const T& value)
     {
-        difference_type index = std::distance(cbegin(), pos);
-        reserve_grow(size() + count);
-        return data_.insert(cbegin() + index, count, value);
+        difference_type index = pos - cbegin();
+        if (is_element(value)) {
+            value_type copy(value);
+            return insert(begin_ + index, count, copy);
+        }
+        return insert_constructed(index, count, [&](value_type* p) {
+            alloc_traits::construct(alloc_, p, value);
+        });
     }
 
     template<class InputIt>
@@ -297,15 +446,20 @@ public:
     >::type
         insert(const_iterator pos, InputIt first, InputIt last)
     {
-        size_type old_size = size();
         difference_type index = pos - cbegin();
+        if (index == difference_type(size_)) {
+            for (; first != last; ++first)
+                emplace_back(*first);
+            return begin_ + index;
+        }
+        // The number of elements is not known in advance. Collect them first
+        // so that the tail is moved only once. The temporary storage is wiped
+        // when it's released.
+        vector<value_type, Allocator> buffer(alloc_);
         for (; first != last; ++first)
-            push_back(*first);
-
-        std::rotate(begin() + index,
-                    begin() + old_size,
-                    end());
-        return begin() + index;
+            buffer.emplace_back(*first);
+        return insert(begin_ + index, std::make_move_iterator(buffer.begin()),
+                      std::make_move_iterator(buffer.end()));
     }
 
     template<class ForwardIt>
@@ -316,79 +470,67 @@ public:
         insert(const_iterator pos, ForwardIt first, ForwardIt last)
     {
         difference_type index = pos - cbegin();
-        reserve_grow(size() + std::distance(first, last));
-        return data_.insert(cbegin() + index, first, last);
+        return insert_range(index, first, last,
+                            detail::is_bitwise_copy_source<ForwardIt, T>());
     }
 
     iterator insert(const_iterator pos, std::initializer_list<T> ilist)
     {
-        difference_type index = pos - cbegin();
-        reserve_grow(size() + std::distance(ilist.begin(), ilist.end()));
-        return data_.insert(cbegin() + index, ilist);
+        return insert(pos, ilist.begin(), ilist.end());
     }
 
     template<class... Args>
     iterator emplace(const_iterator pos, Args&& ... args)
     {
         difference_type index = pos - cbegin();
-
-        if (index == size() || size() == capacity()) {
-            value_type temp(std::forward<Args>(args)...);
-            reserve_grow(size() + 1);
-            return data_.insert(cbegin() + index, std::move(temp));
+        if (index == difference_type(size_)) {
+            emplace_back(std::forward<Args>(args)...);
+            return begin_ + index;
         }
-
-        reserve_grow(size() + 1);
-        return data_.emplace(cbegin() + index, std::move(args...));
+        // args may refer to elements that will be moved
+        value_type temp(std::forward<Args>(args)...);
+        return insert(begin_ + index, std::move(temp));
     }
 
     iterator erase(const_iterator pos)
     {
-        iterator ret = data_.erase(pos);
-
-        value_type* p_end = data_.data() + data_.size();
-        detail::secure_delete_range(p_end, p_end + 1);
-
-        return ret;
+        return erase(pos, pos + 1);
     }
 
     iterator erase(const_iterator first, const_iterator last)
     {
-        difference_type count = std::distance(first, last);
-        iterator ret = data_.erase(first, last);
-
-        if (count > 0) {
-            value_type* p_end = data_.data() + data_.size();
-            detail::secure_delete_range(p_end, p_end + count);
-        }
-
-        return ret;
+        value_type* p = begin_ + (first - cbegin());
+        size_type count = last - first;
+        if (count > 0)
+            erase_impl(p, count, is_trivially_relocatable<T>());
+        return p;
     }
 
     void push_back(const T& value)
     {
-        reserve_grow(size() + 1);
-        data_.push_back(value);
+        emplace_back(value);
     }
 
     void push_back(T&& value)
     {
-        reserve_grow(size() + 1);
-        data_.push_back(std::move(value));
+        emplace_back(std::move(value));
     }
 
     template<class... Args>
     void emplace_back(Args&& ... args)
     {
-        reserve_grow(size() + 1);
-        data_.emplace_back(std::move(args...));
+        if (size_ == capacity_) {
+            grow_emplace_back(std::forward<Args>(args)...);
+            return;
+        }
+        alloc_traits::construct(alloc_, end(), std::forward<Args>(args)...);
+        ++size_;
     }
 
     void pop_back()
     {
-        data_.pop_back();
-        value_type* p_end = data_.data() + data_.size();
-        detail::secure_delete_range(p_end, p_end + 1);
+        destroy_and_wipe(end() - 1, end());
+        --size_;
     }
 
     void resize(size_type count)
@@ -396,13 +538,12 @@ public:
         if (count > max_size())
             throw std::length_error("count > max_size()");
         if (count < size()) {
-            value_type* new_end = data_.data() + count;
-            value_type* old_end = data_.data() + data_.size();
-            detail::secure_delete_range(new_end, old_end);
-            data_.resize(count);
+            destroy_and_wipe(begin_ + count, end());
+            size_ = count;
         } else {
-            reserve_grow(count);
-            data_.resize(count);
+            insert_constructed(size_, count - size_, [&](value_type* p) {
+                alloc_traits::construct(alloc_, p);
+            });
         }
     }
 
@@ -411,120 +552,460 @@ public:
         if (count > max_size())
             throw std::length_error("count > max_size()");
         if (count < size()) {
-            value_type* new_end = data_.data() + count;
-            value_type* old_end = data_.data() + data_.size();
-            detail::secure_delete_range(new_end, old_end);
-            data_.resize(count, value);
+            destroy_and_wipe(begin_ + count, end());
+            size_ = count;
         } else {
-            reserve_grow(count);
-            data_.resize(count, value);
+            insert(end(), count - size_, value);
         }
     }
 
-    void swap(vector& other)
+    void swap(vector& other) noexcept
     {
-        data_.swap(other.data_);
+        if (alloc_traits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        }
+        std::swap(begin_, other.begin_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
     }
 
-    const container_type& container() const { return data_; }
+    const container_type& container() const noexcept { return *this; }
 
     // dummy function that aids compatibility with libcxx tests
     bool __invariants() const
     {
-#ifdef _LIBCPP_VECTOR
-        return data_.__invariants();
-#else
-        return true;
-#endif
+        if (size_ > capacity_)
+            return false;
+        return (begin_ == nullptr) == (capacity_ == 0);
     }
 
 private:
 
-    // We can't use reserve() when growing container, because it will allocate
-    // absolute minimum space.
-    void reserve_grow(size_type size)
+    bool is_element(const value_type& value) const noexcept
     {
-        if (size <= capacity())
-            return;
-        reallocate(std::max(2 * capacity(), size));
+        std::less<const value_type*> less;
+        const value_type* p = std::addressof(value);
+        return !less(p, begin_) && less(p, end());
     }
 
-    void reallocate(size_type new_capacity)
+    // Takes over the storage of other. This vector must not have storage.
+    void steal(vector& other) noexcept
+    {
+        begin_ = other.begin_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        other.begin_ = nullptr;
+        other.size_ = 0;
+        other.capacity_ = 0;
+    }
+
+    void move_assign(vector& other, std::true_type /*propagate*/) noexcept
     {
-        // support stateful allocators
-        reallocate_impl(new_capacity, std::is_empty<allocator_type>());
+        alloc_ = std::move(other.alloc_);
+        steal(other);
     }
 
-    void reallocate_impl(size_type new_capacity, std::true_type /*is_empty*/)
+    void move_assign(vector& other, std::false_type /*propagate*/)
     {
-        vector temp;
-        temp.data_.reserve(new_capacity);
-        std::move(begin(), end(), std::back_inserter(temp.data_));
-        swap(temp);
+        if (alloc_ == other.alloc_) {
+            steal(other);
+        } else {
+            assign(std::make_move_iterator(other.begin()),
+                   std::make_move_iterator(other.end()));
+            other.release_storage();
+        }
+    }
+
+    // Destroys the elements in the given range and wipes the memory they
+    // occupied
+    void destroy_and_wipe(value_type* first, value_type* last) noexcept
+    {
+        for (value_type* p = first; p != last; ++p)
+            alloc_traits::destroy(alloc_, p);
+        detail::secure_delete_range(first, last);
     }
 
-    void reallocate_impl(size_type new_capacity, std::false_type /*is_not_empty*/)
+    // Destroys and wipes the elements and releases the storage
+    void release_storage() noexcept
     {
-        // make sure we preserve the stateful allocator
-        vector temp;
-        temp.reserve(size());
-        std::move(begin(), end(), std::back_inserter(temp.data_));
         clear();
-        data_.reserve(new_capacity);
-        std::move(temp.begin(), temp.end(), std::back_inserter(data_));
+        if (begin_ != nullptr)
+            deallocate(begin_, capacity_);
+        begin_ = nullptr;
+        capacity_ = 0;
+    }
+
+    value_type* allocate(size_type n)
+    {
+        pointer p = alloc_traits::allocate(alloc_, n);
+        return std::addressof(*p);
+    }
+
+    void deallocate(value_type* p, size_type n) noexcept
+    {
+        alloc_traits::deallocate(alloc_, std::pointer_traits<pointer>::pointer_to(*p), n);
+    }
+
+    // Moves the elements in [first, last) to the uninitialized storage at dest.
+    // The source elements are left in place and must be discarded with
+    // discard_relocated(). On exception nothing is left constructed at dest.
+    void relocate_range(value_type* first, value_type* last, value_type* dest,
+                        std::true_type /*is_trivially_relocatable*/) noexcept
+    {
+        if (first != last)
+            std::memcpy(static_cast<void*>(dest), first, (last - first) * sizeof(value_type));
+    }
+
+    void relocate_range(value_type* first, value_type* last, value_type* dest,
+                        std::false_type /*is_trivially_relocatable*/)
+    {
+        value_type* out = dest;
+        try {
+            for (; first != last; ++first, ++out)
+                alloc_traits::construct(alloc_, out, std::move_if_noexcept(*first));
+        } catch (...) {
+            destroy_and_wipe(dest, out);
+            throw;
+        }
+    }
+
+    // Wipes the elements in [first, last) that have been relocated. Objects
+    // that were relocated as bytes are not destroyed.
+    void discard_relocated(value_type* first, value_type* last,
+                           std::true_type /*is_trivially_relocatable*/) noexcept
+    {
+        detail::secure_delete_range(first, last);
+    }
+
+    void discard_relocated(value_type* first, value_type* last,
+                           std::false_type /*is_trivially_relocatable*/) noexcept
+    {
+        destroy_and_wipe(first, last);
+    }
+
+    // Moves the elements to the storage at dest. The original location of the
+    // elements is wiped.
+    void relocate_to(value_type* dest)
+    {
+        relocate_range(begin_, end(), dest, is_trivially_relocatable<T>());
+        discard_relocated(begin_, end(), is_trivially_relocatable<T>());
+    }
+
+    // Moves the elements to newly allocated storage and releases the old
+    // storage. On exception the vector is not modified.
+    void reallocate(size_type new_capacity)
+    {
+        value_type* p = allocate(new_capacity);
+        try {
+            relocate_to(p);
+        } catch (...) {
+            deallocate(p, new_capacity);
+            throw;
+        }
+        replace_storage(p, new_capacity);
     }
 
-    container_type data_;
+    // Releases the storage whose elements have already been relocated and
+    // starts using the given storage
+    void replace_storage(value_type* p, size_type new_capacity) noexcept
+    {
+        if (begin_ != nullptr)
+            deallocate(begin_, capacity_);
+        begin_ = p;
+        capacity_ = new_capacity;
+    }
+
+    template<class... Args>
+    void grow_emplace_back(Args&& ... args)
+    {
+        size_type new_capacity = grow_capacity(size_ + 1);
+        value_type* p = allocate(new_capacity);
+        try {
+            // args may refer to an element of this vector, thus the new
+            // element is constructed before the old ones are moved
+            alloc_traits::construct(alloc_, p + size_, std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate(p, new_capacity);
+            throw;
+        }
+        try {
+            relocate_to(p);
+        } catch (...) {
+            destroy_and_wipe(p + size_, p + size_ + 1);
+            deallocate(p, new_capacity);
+            throw;
+        }
+        replace_storage(p, new_capacity);
+        ++size_;
+    }
+
+    template<class ForwardIt>
+    iterator insert_range(difference_type index, ForwardIt first, ForwardIt last,
+                          std::false_type /*is_bitwise_copy_source*/)
+    {
+        return insert_constructed(index, std::distance(first, last), [&](value_type* p) {
+            alloc_traits::construct(alloc_, p, *first);
+            ++first;
+        });
+    }
+
+    // Copies the elements with memcpy. When growing, the elements before and
+    // after the insertion point are copied directly to their final locations.
+    iterator insert_range(difference_type index, const value_type* first,
+                          const value_type* last, std::true_type /*is_bitwise_copy_source*/)
+    {
+        size_type count = last - first;
+        value_type* pos = begin_ + index;
+        size_type tail = end() - pos;
+        if (size_ + count > capacity_) {
+            size_type new_capacity = grow_capacity(size_ + count);
+            value_type* p = allocate(new_capacity);
+            detail::copy_bytes(p, begin_, index * sizeof(value_type));
+            detail::copy_bytes(p + index, first, count * sizeof(value_type));
+            detail::copy_bytes(p + index + count, pos, tail * sizeof(value_type));
+            detail::secure_delete_range(begin_, end());
+            replace_storage(p, new_capacity);
+        } else if (count > 0) {
+            if (tail > 0)
+                std::memmove(static_cast<void*>(pos + count), pos, tail * sizeof(value_type));
+            std::memcpy(static_cast<void*>(pos), first, count * sizeof(value_type));
+        }
+        size_ += count;
+        return begin_ + index;
+    }
+
+    // Inserts count elements at index. construct(p) must construct a single
+    // element at the uninitialized location p.
+    template<class Construct>
+    iterator insert_constructed(difference_type index, size_type count,
+                                Construct construct)
+    {
+        if (count == 0)
+            return begin_ + index;
+        if (size_ + count > capacity_)
+            grow_insert_constructed(index, count, construct);
+        else
+            insert_constructed_impl(begin_ + index, count, construct,
+                                    is_trivially_relocatable<T>());
+        return begin_ + index;
+    }
+
+    // Inserts the elements into newly allocated storage. The elements before
+    // and after the insertion point are moved directly to their final
+    // locations, thus each existing element is moved only once. On exception
+    // the vector is not modified.
+    template<class Construct>
+    void grow_insert_constructed(difference_type index, size_type count,
+                                 Construct& construct)
+    {
+        size_type new_capacity = grow_capacity(size_ + count);
+        value_type* p = allocate(new_capacity);
+        value_type* gap = p + index;
+
+        // the new elements may refer to the existing ones, thus they are
+        // constructed first
+        size_type i = 0;
+        try {
+            for (; i < count; ++i)
+                construct(gap + i);
+        } catch (...) {
+            destroy_and_wipe(gap, gap + i);
+            deallocate(p, new_capacity);
+            throw;
+        }
+
+        value_type* pos = begin_ + index;
+        try {
+            relocate_range(begin_, pos, p, is_trivially_relocatable<T>());
+            try {
+                relocate_range(pos, end(), gap + count, is_trivially_relocatable<T>());
+            } catch (...) {
+                destroy_and_wipe(p, gap);
+                throw;
+            }
+        } catch (...) {
+            destroy_and_wipe(gap, gap + count);
+            deallocate(p, new_capacity);
+            throw;
+        }
+        discard_relocated(begin_, end(), is_trivially_relocatable<T>());
+        replace_storage(p, new_capacity);
+        size_ += count;
+    }
+
+    template<class Construct>
+    void insert_constructed_impl(value_type* pos, size_type count, Construct& construct,
+                                 std::true_type /*is_trivially_relocatable*/)
+    {
+        size_type tail = end() - pos;
+        if (tail > 0)
+            std::memmove(static_cast<void*>(pos + count), pos, tail * sizeof(value_type));
+
+        size_type i = 0;
+        try {
+            for (; i < count; ++i)
+                construct(pos + i);
+        } catch (...) {
+            // close the gap
+            destroy_and_wipe(pos, pos + i);
+            if (tail > 0)
+                std::memmove(static_cast<void*>(pos), pos + count, tail * sizeof(value_type));
+            detail::secure_delete_range(end(), end() + count);
+            throw;
+        }
+        size_ += count;
+    }
+
+    template<class Construct>
+    void insert_constructed_impl(value_type* pos, size_type count, Construct& construct,
+                                 std::false_type /*is_trivially_relocatable*/)
+    {
+        value_type* old_end = end();
+        append_constructed(count, construct);
+        std::rotate(pos, old_end, end());
+    }
+
+    // Constructs count elements at the end. The capacity must be sufficient.
+    template<class Construct>
+    void append_constructed(size_type count, Construct& construct)
+    {
+        size_type old_size = size_;
+        try {
+            for (; size_ < old_size + count; ++size_)
+                construct(end());
+        } catch (...) {
+            destroy_and_wipe(begin_ + old_size, end());
+            size_ = old_size;
+            throw;
+        }
+    }
+
+    // Constructs n value-initialized elements in a vector without storage.
+    // Elements don't need to be movable.
+    void construct_default(size_type n)
+    {
+        if (n > max_size())
+            throw std::length_error("n > max_size()");
+        if (n == 0)
+            return;
+        begin_ = allocate(n);
+        capacity_ = n;
+        auto construct = [&](value_type* p) { alloc_traits::construct(alloc_, p); };
+        append_constructed(n, construct);
+    }
+
+    void erase_impl(value_type* p, size_type count,
+                    std::true_type /*is_trivially_relocatable*/) noexcept
+    {
+        // The erased elements are either overwritten by the tail or wiped
+        // below together with the vacated end, so they are only destroyed here
+        for (value_type* it = p; it != p + count; ++it)
+            alloc_traits::destroy(alloc_, it);
+        size_type tail = end() - (p + count);
+        if (tail > 0)
+            std::memmove(static_cast<void*>(p), p + count, tail * sizeof(value_type));
+        size_ -= count;
+        detail::secure_delete_range(end(), end() + count);
+    }
+
+    void erase_impl(value_type* p, size_type count,
+                    std::false_type /*is_trivially_relocatable*/)
+    {
+        std::move(p + count, end(), p);
+        destroy_and_wipe(end() - count, end());
+        size_ -= count;
+    }
+
+    // Returns the capacity to allocate when the size grows to the given value
+    size_type grow_capacity(size_type size) const
+    {
+        if (size > max_size())
+            throw std::length_error("size > max_size()");
+        if (capacity() > max_size() / 2)
+            return max_size();
+        return std::max(2 * capacity(), size);
+    }
+
+    Allocator alloc_;
+    value_type* begin_;
+    size_type size_;
+    size_type capacity_;
 };
 
 template<class T, class Alloc>
 bool operator==(const vector<T, Alloc>& lhs,
                 const vector<T, Alloc>& rhs)
 {
-    return lhs.container() == rhs.container();
+    return lhs.size() == rhs.size() &&
+            std::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
 template<class T, class Alloc>
 bool operator!=(const vector<T, Alloc>& lhs,
                 const vector<T, Alloc>& rhs)
 {
-    return lhs.container() != rhs.container();
+    return !(lhs == rhs);
 }
 
 template<class T, class Alloc>
 bool operator<(const vector<T, Alloc>& lhs,
                const vector<T, Alloc>& rhs)
 {
-    return lhs.container() < rhs.container();
+    return std::lexicographical_compare(lhs.begin(), lhs.end(),
+                                        rhs.begin(), rhs.end());
 }
 
 template<class T, class Alloc>
 bool operator<=(const vector<T, Alloc>& lhs,
                 const vector<T, Alloc>& rhs)
 {
-    return lhs.container() <= rhs.container();
+    return !(rhs < lhs);
 }
 
 template<class T, class Alloc>
 bool operator>(const vector<T, Alloc>& lhs,
                const vector<T, Alloc>& rhs)
 {
-    return lhs.container() > rhs.container();
+    return rhs < lhs;
 }
 
 template<class T, class Alloc>
 bool operator>=(const vector<T, Alloc>& lhs,
                 const vector<T, Alloc>& rhs)
 {
-    return lhs.container() >= rhs.container();
+    return !(lhs < rhs);
 }
 
 template<class T, class Alloc>
-void swap(vector<T, Alloc>& lhs, vector<T, Alloc>& rhs)
+void swap(vector<T, Alloc>& lhs, vector<T, Alloc>& rhs) noexcept
 {
     lhs.swap(rhs);
 }
 
+/*  Removes the elements that compare equal to value or satisfy pred. The
+    remaining elements are compacted in a single pass and the vacated tail is
+    destroyed and wiped at once, unlike when calling erase() in a loop.
+    Returns the number of removed elements.
+*/
+template<class T, class Alloc, class U>
+typename vector<T, Alloc>::size_type erase(vector<T, Alloc>& c, const U& value)
+{
+    auto it = std::remove(c.begin(), c.end(), value);
+    auto count = c.end() - it;
+    c.erase(it, c.end());
+    return count;
+}
+
+template<class T, class Alloc, class Pred>
+typename vector<T, Alloc>::size_type erase_if(vector<T, Alloc>& c, Pred pred)
+{
+    auto it = std::remove_if(c.begin(), c.end(), pred);
+    auto count = c.end() - it;
+    c.erase(it, c.end());
+    return count;
+}
+
 } // namespace tidy
 
 #endif